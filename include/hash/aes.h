@@ -21,6 +21,7 @@
 #define __AES_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define AES_KEY_SIZE_128	16
 #define AES_KEY_SIZE_192	24
@@ -35,16 +36,39 @@ typedef struct {
 	unsigned int  eK[60];
 	unsigned int  dK[60];
 	unsigned long Nr;
+	uint32_t      Flags;	// AES_CONTEXT_* bits describing how eK/dK are laid out
 } AesContext;
 
+// eK/dK hold the round keys as 16-byte AES-NI blocks instead of big-endian table words
+#define AES_CONTEXT_AESNI	0x1
+// dK has not been derived (AesInitialiseEncryptOnly)
+#define AES_CONTEXT_NO_DECRYPT	0x2
+
 /*
  *  XorBuffer
  *
  * Takes two Source buffers and XORs them together and puts the result in
- * DestinationBuffer
+ * DestinationBuffer. Buffers of at least 32 bytes go through the widest vector
+ * unit the CPU has (AVX2 or SSE2), shorter ones are XORed 8 bytes at a time.
+ * The destination may be one of the sources.
  */
 extern void XorBuffers(const uint8_t*,const uint8_t*,uint8_t *,uint32_t);
 
+/*
+ *  XorBuffersLarge
+ *
+ * XorBuffers for a size_t length.
+ */
+extern void XorBuffersLarge(const uint8_t*,const uint8_t*,uint8_t *,size_t);
+
+/*
+ *  XorAesBlock
+ *
+ *  Takes two source blocks (size AES_BLOCK_SIZE) and XORs them together and
+ * puts the result in first block
+ */
+extern void XorAesBlock(uint8_t*,const uint8_t*);
+
 /*
  *  AesInitialise
  *
@@ -54,6 +78,25 @@ extern void XorBuffers(const uint8_t*,const uint8_t*,uint8_t *,uint32_t);
  */
 extern int AesInitialise(AesContext*, const void*, uint32_t);
 
+/*
+ *  AesInitialiseEncryptOnly
+ *
+ *  Initialises an AesContext for encryption only: just the encryption round
+ * keys are expanded and the context is flagged AES_CONTEXT_NO_DECRYPT. Suited
+ * to CTR and OFB, which never run the inverse cipher. The decryption schedule
+ * can be added later with AesExpandDecryptKey. Returns 0 if successful, or -1
+ * if invalid KeySize provided
+ */
+extern int AesInitialiseEncryptOnly(AesContext*, const void*, uint32_t);
+
+/*
+ *  AesExpandDecryptKey
+ *
+ *  Derives the decryption round keys of a context initialised with
+ * AesInitialiseEncryptOnly. Does nothing if the context already has them.
+ */
+extern void AesExpandDecryptKey(AesContext*);
+
 /*
  *  AesEncrypt
  *
@@ -70,7 +113,8 @@ extern void AesEncrypt(const AesContext*,const uint8_t[AES_BLOCK_SIZE],uint8_t[A
  *  Performs an AES decryption of one block (128 bits) with the AesContext
  * initialised with one of the functions AesInitialise[n]. Input and Output can
  * point to same memory location, however it is more efficient to use
- *  AesDecryptInPlace in this situation.
+ *  AesDecryptInPlace in this situation. An encrypt-only context must have
+ * AesExpandDecryptKey run on it first.
  */
 extern void AesDecrypt(const AesContext*,const uint8_t[AES_BLOCK_SIZE],uint8_t[AES_BLOCK_SIZE]);
 
@@ -92,6 +136,26 @@ extern void AesEncryptInPlace(const AesContext*,uint8_t[AES_BLOCK_SIZE]);
  */
 extern void AesDecryptInPlace(const AesContext*,uint8_t[AES_BLOCK_SIZE]);
 
+/*
+ *  AesEncryptBlocks
+ *
+ *  Encrypts Blocks independent blocks (ECB) from Input to Output with the
+ * AesContext initialised with one of the functions AesInitialise[n]. The
+ * backend is picked once per call rather than per block; with AES-NI the blocks
+ * go through the rounds 8 at a time. Input and Output can point to the same
+ * memory location.
+ */
+extern void AesEncryptBlocks(const AesContext*,const void*,void*,size_t);
+
+/*
+ *  AesDecryptBlocks
+ *
+ *  Decrypts Blocks independent blocks (ECB) from Input to Output. Input and
+ * Output can point to the same memory location. An encrypt-only context must
+ * have AesExpandDecryptKey run on it first.
+ */
+extern void AesDecryptBlocks(const AesContext*,const void*,void*,size_t);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,7 @@
 #define __AESCBCI_H__
 
 #include <aes.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,12 +33,16 @@ typedef struct {
 } AesCbcContext;
 
 /*
- *  XorAesBlock
+ * AesCbcSharedContext
  *
- *  Takes two source blocks (size AES_BLOCK_SIZE) and XORs them together and
- * puts the result in first block
+ * CBC chaining state over an externally owned key schedule. The AesContext is
+ * only read, so one initialised schedule can back any number of streams on any
+ * number of threads; it must outlive them.
  */
-extern void XorAesBlock(uint8_t*,const uint8_t*);
+typedef struct {
+	const AesContext* Aes;
+	uint8_t PreviousCipherBlock[AES_BLOCK_SIZE];
+} AesCbcSharedContext;
 
 /*
  *  AesCbcInitialise
@@ -71,17 +76,70 @@ extern int AesCbcInitialiseWithKey(AesCbcContext *,const uint8_t*,uint32_t,const
  */
 extern int AesCbcEncrypt(AesCbcContext*,const void*,void*,uint32_t);
 
+/*
+ *  AesCbcEncryptMulti
+ *
+ *  Encrypts Count independent CBC streams in one call: InBuffers[i] (Sizes[i]
+ * bytes) is encrypted into OutBuffers[i] with Contexts[i], exactly as
+ * AesCbcEncrypt would. With AES-NI up to 8 chains advance in lockstep so their
+ * rounds interleave. The contexts must be distinct. Returns 0 if successful, or
+ * -1 (before encrypting anything) if a size is not a multiple of 16 bytes.
+ */
+extern int AesCbcEncryptMulti(AesCbcContext* const*,const void* const*,void* const*,const uint32_t*,size_t);
+
 /*
  *  AesCbcDecrypt
  *
  *  Decrypts a buffer of data using an AES CBC context. The data buffer must be
  * a multiple of 16 bytes (128 bits) in size. The "position" of the context will
  * be advanced by the buffer amount. InBuffer and OutBuffer can point to the
- * same location for in-place decrypting. Returns 0 if successful, or -1 if Size
- * is not a multiple of 16 bytes.
+ * same location for in-place decrypting. A context made from an encrypt-only
+ * AesContext gets its decryption keys derived on the first call. Returns 0 if
+ * successful, or -1 if Size is not a multiple of 16 bytes.
  */
 extern int AesCbcDecrypt(AesCbcContext*,const void*,void*,uint32_t);
 
+/*
+ *  AesCbcEncryptLarge
+ *
+ *  AesCbcEncrypt for a size_t length, encrypted in one call of the block loop.
+ */
+extern int AesCbcEncryptLarge(AesCbcContext*,const void*,void*,size_t);
+
+/*
+ *  AesCbcDecryptLarge
+ *
+ *  AesCbcDecrypt for a size_t length, decrypted in one call of the batched block
+ * loop.
+ */
+extern int AesCbcDecryptLarge(AesCbcContext*,const void*,void*,size_t);
+
+/*
+ *  AesCbcInitialiseShared
+ *
+ *  Initialises an AesCbcSharedContext over an already initialised AesContext
+ * and an IV. The key schedule is referenced, not copied, so changing the IV only
+ * writes 16 bytes. Decrypting needs a context set up with AesInitialise (or
+ * AesExpandDecryptKey).
+ */
+extern void AesCbcInitialiseShared(AesCbcSharedContext*,const AesContext*,const uint8_t[AES_BLOCK_SIZE]);
+
+/*
+ *  AesCbcSharedEncrypt
+ *
+ *  AesCbcEncrypt for an AesCbcSharedContext.
+ */
+extern int AesCbcSharedEncrypt(AesCbcSharedContext*,const void*,void*,uint32_t);
+
+/*
+ *  AesCbcSharedDecrypt
+ *
+ *  AesCbcDecrypt for an AesCbcSharedContext. The shared key schedule is never
+ * modified, so it must already have its decryption keys: returns -1 for an
+ * encrypt-only AesContext as well as for a partial block.
+ */
+extern int AesCbcSharedDecrypt(AesCbcSharedContext*,const void*,void*,uint32_t);
+
 /*
  *  AesCbcEncryptWithKey
  *
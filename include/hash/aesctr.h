@@ -21,9 +21,13 @@
 #define __AESCTRI_H__
 
 #include <aes.h>
+#include <stddef.h>
 
 #define AES_CTR_IV_SIZE 8
 
+// Default of AesCtrSetParallelThreshold
+#define AES_CTR_PARALLEL_THRESHOLD	(4U << 20)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -36,6 +40,21 @@ typedef struct {
 	uint8_t CurrentCipherBlock[AES_BLOCK_SIZE];
 } AesCtrContext;
 
+/*
+ * AesCtrSharedContext
+ *
+ * CTR stream state over an externally owned key schedule. The AesContext is
+ * only read, so one initialised schedule can back any number of streams on any
+ * number of threads; it must outlive them.
+ */
+typedef struct {
+	const AesContext* Aes;
+	uint8_t IV[AES_CTR_IV_SIZE];
+	uint64_t StreamIndex;
+	uint64_t CurrentCipherBlockIndex;
+	uint8_t CurrentCipherBlock[AES_BLOCK_SIZE];
+} AesCtrSharedContext;
+
 /*
  *  CreateCurrentCipherBlock
  *
@@ -74,6 +93,17 @@ extern int AesCtrInitialiseWithKey(AesCtrContext*,const uint8_t*,uint32_t,const
  */
 extern void AesCtrSetStreamIndex(AesCtrContext*,uint64_t);
 
+/*
+ *  AesCtrSetParallelThreshold
+ *
+ * Sets the buffer size from which AesCtrXor and AesCtrOutput split the work
+ * into contiguous segments running on the worker thread pool. 0 keeps every
+ * call on the calling thread. The default is AES_CTR_PARALLEL_THRESHOLD. May
+ * be called while other threads encrypt; a call already running keeps the
+ * value it started with.
+ */
+extern void AesCtrSetParallelThreshold(size_t);
+
 /*
  *  AesCtrXor
  *
@@ -94,6 +124,51 @@ extern void AesCtrXor(AesCtrContext*,const void*,void*,uint32_t);
  */
 extern void AesCtrOutput(AesCtrContext*,void*,uint32_t);
 
+/*
+ *  AesCtrXorLarge
+ *
+ * AesCtrXor for a size_t length. The buffer is handed to the batched (and, above
+ * the parallel threshold, threaded) keystream generation in one piece.
+ */
+extern void AesCtrXorLarge(AesCtrContext*,const void*,void*,size_t);
+
+/*
+ *  AesCtrOutputLarge
+ *
+ * AesCtrOutput for a size_t length.
+ */
+extern void AesCtrOutputLarge(AesCtrContext*,void*,size_t);
+
+/*
+ *  AesCtrInitialiseShared
+ *
+ * Initialises an AesCtrSharedContext over an already initialised AesContext and
+ * an IV. The key schedule is referenced, not copied, so only the IV and the
+ * first keystream block are written.
+ */
+extern void AesCtrInitialiseShared(AesCtrSharedContext*,const AesContext*,const uint8_t[AES_CTR_IV_SIZE]);
+
+/*
+ *  AesCtrSharedSetStreamIndex
+ *
+ * AesCtrSetStreamIndex for an AesCtrSharedContext.
+ */
+extern void AesCtrSharedSetStreamIndex(AesCtrSharedContext*,uint64_t);
+
+/*
+ *  AesCtrSharedXor
+ *
+ * AesCtrXor for an AesCtrSharedContext.
+ */
+extern void AesCtrSharedXor(AesCtrSharedContext*,const void*,void*,uint32_t);
+
+/*
+ *  AesCtrSharedOutput
+ *
+ * AesCtrOutput for an AesCtrSharedContext.
+ */
+extern void AesCtrSharedOutput(AesCtrSharedContext*,void*,uint32_t);
+
 /*
  *  AesCtrXorWithKey
  *
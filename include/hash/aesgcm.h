@@ -0,0 +1,172 @@
+/**
+ * WjCryptLib_AesGcm
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __AESGCMI_H__
+#define __AESGCMI_H__
+
+#include <aes.h>
+
+#define AES_GCM_IV_SIZE 12
+#define AES_GCM_TAG_SIZE 16
+#define AES_GCM_PIPELINE 8
+
+// Most plaintext bytes one IV may protect (2^39 - 256 bits, NIST SP 800-38D)
+#define AES_GCM_MAX_DATA_SIZE	((((uint64_t)1) << 36) - 32)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	AesContext Aes;
+	uint64_t HL[16];					// 4-bit multiplication table of H (portable GHASH)
+	uint64_t HH[16];
+	uint8_t HPowers[AES_GCM_PIPELINE][AES_BLOCK_SIZE];	// H^1 .. H^8 byte reversed (PCLMULQDQ GHASH)
+	uint8_t J0[AES_BLOCK_SIZE];				// pre-counter block of the current message
+	uint8_t Ghash[AES_BLOCK_SIZE];				// running GHASH value
+	uint8_t Buffer[AES_BLOCK_SIZE];				// partial AAD or ciphertext block not hashed yet
+	uint8_t CurrentCipherBlock[AES_BLOCK_SIZE];		// keystream of the block DataSize is in
+	uint64_t AadSize;
+	uint64_t DataSize;
+	uint32_t Flags;
+} AesGcmContext;
+
+// HPowers is set up and GHASH runs on PCLMULQDQ
+#define AES_GCM_PCLMUL	0x1
+// The AAD is closed, the message data is being processed
+#define AES_GCM_DATA	0x2
+
+/*
+ *  AesGcmInitialise
+ *
+ * Initialises an AesGcmContext with an already initialised AesContext: derives
+ * the hash key H and its GHASH tables. A message is then started with
+ * AesGcmStart; the context can be reused for any number of messages.
+ */
+extern void AesGcmInitialise(AesGcmContext*,const AesContext*);
+
+/*
+ *  AesGcmInitialiseWithKey
+ *
+ * Initialises an AesGcmContext with an AES Key. KeySize must be 16, 24, or 32
+ * (for 128, 192, or 256 bit key size) Returns 0 if successful, or -1 if invalid
+ * KeySize provided
+ */
+extern int AesGcmInitialiseWithKey(AesGcmContext*,const uint8_t*,uint32_t);
+
+/*
+ *  AesGcmStart
+ *
+ * Starts a new message under IV. 12 byte IVs (AES_GCM_IV_SIZE) are used as
+ * is, any other non-zero size is hashed into the pre-counter block. Returns 0
+ * if successful, or -1 if IVSize is 0
+ */
+extern int AesGcmStart(AesGcmContext*,const uint8_t*,uint32_t);
+
+/*
+ *  AesGcmUpdateAad
+ *
+ * Adds Size bytes of additional authenticated data to the current message.
+ * Can be called any number of times, but only before the first AesGcmEncrypt
+ * or AesGcmDecrypt of the message. Returns 0 if successful, or -1 if message
+ * data has already been processed
+ */
+extern int AesGcmUpdateAad(AesGcmContext*,const void*,uint32_t);
+
+/*
+ *  AesGcmEncrypt
+ *
+ * Encrypts Size bytes of the current message and authenticates the resulting
+ * ciphertext in the same pass. Can be called any number of times with pieces
+ * of any size. InBuffer and OutBuffer can point to the same location. Returns
+ * 0 if successful, or -1 if the message would exceed AES_GCM_MAX_DATA_SIZE
+ */
+extern int AesGcmEncrypt(AesGcmContext*,const void*,void*,uint32_t);
+
+/*
+ *  AesGcmDecrypt
+ *
+ * Decrypts Size bytes of the current message, authenticating the ciphertext
+ * in the same pass. The plaintext must not be trusted before AesGcmVerify has
+ * succeeded. Returns 0 if successful, or -1 if the message would exceed
+ * AES_GCM_MAX_DATA_SIZE
+ */
+extern int AesGcmDecrypt(AesGcmContext*,const void*,void*,uint32_t);
+
+/*
+ *  AesGcmUpdateAadLarge
+ *
+ * AesGcmUpdateAad for a size_t length.
+ */
+extern int AesGcmUpdateAadLarge(AesGcmContext*,const void*,size_t);
+
+/*
+ *  AesGcmEncryptLarge
+ *
+ * AesGcmEncrypt for a size_t length.
+ */
+extern int AesGcmEncryptLarge(AesGcmContext*,const void*,void*,size_t);
+
+/*
+ *  AesGcmDecryptLarge
+ *
+ * AesGcmDecrypt for a size_t length.
+ */
+extern int AesGcmDecryptLarge(AesGcmContext*,const void*,void*,size_t);
+
+/*
+ *  AesGcmFinish
+ *
+ * Completes the current message and writes its 16 byte authentication tag.
+ * Start the next message with AesGcmStart.
+ */
+extern void AesGcmFinish(AesGcmContext*,uint8_t[AES_GCM_TAG_SIZE]);
+
+/*
+ *  AesGcmVerify
+ *
+ * Completes the current message like AesGcmFinish and compares the first
+ * TagSize bytes of its tag with Tag in constant time. TagSize must be between
+ * 4 and 16. Returns 0 if the tag matches, or -1 otherwise
+ */
+extern int AesGcmVerify(AesGcmContext*,const uint8_t*,uint32_t);
+
+/*
+ *  AesGcmEncryptWithKey
+ *
+ * This function combines AesGcmInitialiseWithKey, AesGcmStart, AesGcmUpdateAad,
+ * AesGcmEncrypt and AesGcmFinish for a message encrypted in one go. Returns 0
+ * if successful, or -1 if invalid KeySize, IVSize or BufferSize provided
+ */
+extern int AesGcmEncryptWithKey(const uint8_t*,uint32_t,const uint8_t*,uint32_t,const void*,uint32_t,const void*,void*,uint32_t,uint8_t[AES_GCM_TAG_SIZE]);
+
+/*
+ *  AesGcmDecryptWithKey
+ *
+ * Decrypts and authenticates a message in one go. On a tag mismatch OutBuffer
+ * is cleared. Returns 0 if successful, or -1 if invalid KeySize, IVSize or
+ * TagSize provided or the message does not authenticate
+ */
+extern int AesGcmDecryptWithKey(const uint8_t*,uint32_t,const uint8_t*,uint32_t,const void*,uint32_t,const void*,void*,uint32_t,const uint8_t*,uint32_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AESGCMI_H__ */
@@ -21,23 +21,42 @@
 #define __AESOFBI_H__
 
 #include <aes.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Keystream ring buffer attached by AesOfbEnableKeystream (opaque)
+typedef struct AesOfbKeystream AesOfbKeystream;
+
 typedef struct {
 	AesContext Aes;
 	uint8_t CurrentCipherBlock[AES_BLOCK_SIZE];
 	uint32_t IndexWithinCipherBlock;
+	AesOfbKeystream* Keystream;
 } AesOfbContext;
 
+/*
+ * AesOfbSharedContext
+ *
+ * OFB stream state over an externally owned key schedule. The AesContext is
+ * only read, so one initialised schedule can back any number of streams on any
+ * number of threads; it must outlive them.
+ */
+typedef struct {
+	const AesContext* Aes;
+	uint8_t CurrentCipherBlock[AES_BLOCK_SIZE];
+	uint32_t IndexWithinCipherBlock;
+} AesOfbSharedContext;
+
 /*
  *  AesOfbInitialise
  *
  * Initialises an AesOfbContext with an already initialised AesContext and a IV.
  * This function can quickly be used to change the IV without requiring the more
- * lengthy processes of reinitialising an AES key.
+ * lengthy processes of reinitialising an AES key. Any keystream buffer must be
+ * released with AesOfbDisableKeystream first.
  */
 extern void AesOfbInitialise(AesOfbContext*,const AesContext*,const uint8_t[AES_BLOCK_SIZE]);
 
@@ -59,7 +78,8 @@ extern int AesOfbInitialiseWithKey(AesOfbContext*,const uint8_t*,uint32_t,const
  * of bytes. Use once over data to encrypt it. Use it a second time over the
  * same data from the same stream position and the data will be decrypted.
  * InBuffer and OutBuffer can point to the same location for in-place
- * encrypting/decrypting
+ * encrypting/decrypting. With a keystream buffer enabled the stream is taken
+ * from the buffer, so the call only XORs while keystream is ready.
  */
 extern void AesOfbXor(AesOfbContext*,const void*,void*,uint32_t);
 
@@ -71,6 +91,85 @@ extern void AesOfbXor(AesOfbContext*,const void*,void*,uint32_t);
  */
 extern void AesOfbOutput(AesOfbContext*,void*,uint32_t);
 
+/*
+ *  AesOfbXorLarge
+ *
+ * AesOfbXor for a size_t length.
+ */
+extern void AesOfbXorLarge(AesOfbContext*,const void*,void*,size_t);
+
+/*
+ *  AesOfbEnableKeystream
+ *
+ * Attaches a ring buffer of Size bytes (rounded down to whole blocks, at least
+ * one) in which keystream is generated ahead of the data by AesOfbRefill. The
+ * stream continues from the current position; the output is the same as
+ * without the buffer. Returns 0 if successful, or -1 if Size is too small, the
+ * context already has a buffer, or the allocation failed.
+ */
+extern int AesOfbEnableKeystream(AesOfbContext*,uint32_t);
+
+/*
+ *  AesOfbRefill
+ *
+ * Fills the free part of the keystream buffer and returns the number of bytes
+ * generated (0 when the buffer is full, another thread is filling it, or it is
+ * not enabled). Never blocks; meant to be called while idle on the thread that
+ * encrypts. A helper thread should loop on AesOfbRefillWait instead.
+ */
+extern uint32_t AesOfbRefill(AesOfbContext*);
+
+/*
+ *  AesOfbRefillWait
+ *
+ * AesOfbRefill for a helper thread running while another thread calls
+ * AesOfbXor on the same context: sleeps until the buffer has a free block,
+ * then fills it. Returns the number of bytes generated, or 0 once
+ * AesOfbStopRefill was called (or if the buffer is not enabled), which is the
+ * signal for the helper to exit.
+ */
+extern uint32_t AesOfbRefillWait(AesOfbContext*);
+
+/*
+ *  AesOfbStopRefill
+ *
+ * Wakes every AesOfbRefillWait sleeping on the context and makes it, and any
+ * later call, return 0. The helper must be joined before
+ * AesOfbDisableKeystream.
+ */
+extern void AesOfbStopRefill(AesOfbContext*);
+
+/*
+ *  AesOfbDisableKeystream
+ *
+ * Releases the keystream buffer; the stream carries on from the current
+ * position without it. No AesOfbRefill or AesOfbRefillWait may be running on
+ * the context.
+ */
+extern void AesOfbDisableKeystream(AesOfbContext*);
+
+/*
+ *  AesOfbInitialiseShared
+ *
+ * Initialises an AesOfbSharedContext over an already initialised AesContext and
+ * an IV. The key schedule is referenced, not copied.
+ */
+extern void AesOfbInitialiseShared(AesOfbSharedContext*,const AesContext*,const uint8_t[AES_BLOCK_SIZE]);
+
+/*
+ *  AesOfbSharedXor
+ *
+ * AesOfbXor for an AesOfbSharedContext.
+ */
+extern void AesOfbSharedXor(AesOfbSharedContext*,const void*,void*,uint32_t);
+
+/*
+ *  AesOfbSharedOutput
+ *
+ * AesOfbOutput for an AesOfbSharedContext.
+ */
+extern void AesOfbSharedOutput(AesOfbSharedContext*,void*,uint32_t);
+
 /*
  *  AesOfbXorWithKey
  *
@@ -0,0 +1,108 @@
+/**
+ * WjCryptLib_AesXts
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __AESXTSI_H__
+#define __AESXTSI_H__
+
+#include <aes.h>
+#include <stddef.h>
+
+// Default of AesXtsSetParallelThreshold
+#define AES_XTS_PARALLEL_THRESHOLD	(1U << 20)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	AesContext Data;	// Key1: encrypts and decrypts the data units
+	AesContext Tweak;	// Key2: encrypts the data unit (sector) numbers
+} AesXtsContext;
+
+/*
+ *  AesXtsInitialise
+ *
+ * Initialises an AesXtsContext with two already initialised AesContexts: the
+ * data key (Key1) and the tweak key (Key2). The data key gets its decryption
+ * schedule derived if it was initialised encrypt-only.
+ */
+extern void AesXtsInitialise(AesXtsContext*,const AesContext*,const AesContext*);
+
+/*
+ *  AesXtsInitialiseWithKey
+ *
+ * Initialises an AesXtsContext with an XTS key: Key1 followed by Key2, both of
+ * the same AES size. KeySize must be 32, 48, or 64 (for XTS-AES-128, -192, or
+ * -256) Returns 0 if successful, or -1 if invalid KeySize provided
+ */
+extern int AesXtsInitialiseWithKey(AesXtsContext*,const uint8_t*,uint32_t);
+
+/*
+ *  AesXtsEncryptSector
+ *
+ * Encrypts one data unit (sector) of Size bytes with sequence number Sector.
+ * Size need not be a multiple of 16; the last partial block is handled with
+ * ciphertext stealing. InBuffer and OutBuffer can point to the same location.
+ * Returns 0 if successful, or -1 if Size is less than 16
+ */
+extern int AesXtsEncryptSector(const AesXtsContext*,uint64_t,const void*,void*,uint32_t);
+
+/*
+ *  AesXtsDecryptSector
+ *
+ * Decrypts one data unit (sector) encrypted with AesXtsEncryptSector. Returns
+ * 0 if successful, or -1 if Size is less than 16
+ */
+extern int AesXtsDecryptSector(const AesXtsContext*,uint64_t,const void*,void*,uint32_t);
+
+/*
+ *  AesXtsSetParallelThreshold
+ *
+ * Sets the batch size in bytes from which AesXtsEncryptSectors and
+ * AesXtsDecryptSectors split the sectors into runs processed on the worker
+ * thread pool. 0 keeps every call on the calling thread. The default is
+ * AES_XTS_PARALLEL_THRESHOLD. Safe to change while other threads process
+ * sectors; a batch already under way uses the value it read when it started.
+ */
+extern void AesXtsSetParallelThreshold(size_t);
+
+/*
+ *  AesXtsEncryptSectors
+ *
+ * Encrypts Sectors consecutive data units of SectorSize bytes each, numbered
+ * from FirstSector, laid out back to back in InBuffer. Large batches are split
+ * across the worker thread pool. InBuffer and OutBuffer can point to the same
+ * location. Returns 0 if successful, or -1 if SectorSize is less than 16
+ */
+extern int AesXtsEncryptSectors(const AesXtsContext*,uint64_t,uint32_t,const void*,void*,size_t);
+
+/*
+ *  AesXtsDecryptSectors
+ *
+ * Decrypts Sectors consecutive data units encrypted with AesXtsEncryptSectors
+ * or AesXtsEncryptSector. Returns 0 if successful, or -1 if SectorSize is less
+ * than 16
+ */
+extern int AesXtsDecryptSectors(const AesXtsContext*,uint64_t,uint32_t,const void*,void*,size_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AESXTSI_H__ */
@@ -44,6 +44,21 @@ extern uint32_t ccrc32_reflected(uint32_t,const void*,size_t,const uint32_t*);
 // Compute CRC-32 not-reflected over a byte buffer using precomputed table
 extern uint32_t ccrc32(uint32_t,const void*,size_t,const uint32_t*);
 
+// Shared reflected lookup table of one of the CRC32_*_POLY_REFLECTED polynomials (built once, thread-safe), or NULL
+// for any other polynomial
+extern const uint32_t* crc32_shared_table(uint32_t);
+
+// Continue a reflected CRC-32 (no final XOR) over a buffer. The CRC32_*_POLY_REFLECTED polynomials use the shared
+// tables and the fastest kernel available (slicing-by-8/16 in software); any other polynomial is processed byte-wise.
+extern uint32_t crc32_update(uint32_t,uint32_t,const void*,size_t);
+
+// CRC of A followed by B (len_b bytes) from the CRCs of A and B: crc32_combine(crc_a, crc_b, len_b, poly). Works on
+// final CRCs sharing the initial value and final XOR, and on crc32_update registers when crc_b was started from 0.
+extern uint32_t crc32_combine(uint32_t,uint32_t,uint64_t,uint32_t);
+
+// crc32_update that checksums large buffers in segments on the worker thread pool and merges them with crc32_combine
+extern uint32_t crc32_update_parallel(uint32_t,uint32_t,const void*,size_t);
+
 #ifdef __cplusplus
 }
 #endif
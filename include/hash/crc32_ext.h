@@ -15,9 +15,12 @@
  *   - crc32_autosar()  : AUTOSAR standard
  *
  * For each memory variant, a file-based counterpart exists, suffixed with `_file`.
+ * crc32_parallel() and crc32_file_parallel() take the polynomial and split large
+ * inputs across the worker threads.
  * Example:
  *     uint32_t a = crc32c(data, len);
  *     uint32_t b = crc32c_file("example.bin");
+ *     uint32_t c = crc32_file_parallel("disk.img", CRC32C_POLY_REFLECTED);
  */
 
 #ifndef __CRC32_EXT_H__
@@ -49,6 +52,10 @@ extern uint32_t crc32d_file(const char *path);
 extern uint32_t crc32_xfer_file(const char *path);
 extern uint32_t crc32_autosar_file(const char *path);
 
+/* === Parallel CRC32 over memory and files (worker thread pool), any CRC32_*_POLY_REFLECTED === */
+extern uint32_t crc32_parallel(const void *data, size_t len, uint32_t poly_reflected);
+extern uint32_t crc32_file_parallel(const char *path, uint32_t poly_reflected);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,7 @@
 #define __MD2I_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* MD2 parameters */
 #define MD2_HASH_SIZE    16
@@ -74,6 +75,21 @@ extern void Md2Finalise(Md2Context*,MD2_HASH*);
  */
 extern void Md2Calculate(const void*,uint32_t,MD2_HASH*);
 
+/*
+ * Md2UpdateLarge
+ *
+ * Md2Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Md2UpdateLarge(Md2Context*, const void*, size_t);
+
+/*
+ * Md2CalculateLarge
+ *
+ * Md2Calculate for a size_t length.
+ */
+extern void Md2CalculateLarge(const void*, size_t, MD2_HASH*);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,7 @@
 #define __MD4I_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define MD4_HASH_SIZE        16
 #define MD4_BLOCK_SIZE       64
@@ -77,6 +78,21 @@ extern void Md4Finalise(Md4Context*,MD4_HASH*);
  */
 extern void Md4Calculate(const void*,uint32_t,MD4_HASH*);
 
+/*
+ * Md4UpdateLarge
+ *
+ * Md4Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Md4UpdateLarge(Md4Context*, const void*, size_t);
+
+/*
+ * Md4CalculateLarge
+ *
+ * Md4Calculate for a size_t length.
+ */
+extern void Md4CalculateLarge(const void*, size_t, MD4_HASH*);
+
 #ifdef __cplusplus
 }
 #endif
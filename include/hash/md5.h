@@ -31,8 +31,12 @@
 #define __MD5I_H__
 
 #include <stdint.h>
+#include <stddef.h>
+
+#include "multibuffer.h"
 
 #define MD5_HASH_SIZE 16
+#define MD5_BLOCK_SIZE 64
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,6 +58,15 @@ typedef struct {
 	uint8_t bytes[MD5_HASH_SIZE];
 } MD5_HASH;
 
+// Md5MultiContext - Multi-buffer MD5 scheduler, initialise with Md5MultiInitialise. Do not modify directly.
+typedef struct {
+	HashLane  Lanes[HASH_LANES_MAX];
+	MD5_HASH* Digests[HASH_LANES_MAX];
+	uint32_t  State[4][HASH_LANES_MAX];
+	uint32_t  Width;
+	uint32_t  Busy;
+} Md5MultiContext;
+
 /*
  *  Md5Initialise
  *
@@ -87,6 +100,54 @@ extern void Md5Finalise(Md5Context*, MD5_HASH*);
  */
 extern void Md5Calculate(const void*,uint32_t,MD5_HASH *);
 
+/*
+ * Md5UpdateLarge
+ *
+ * Md5Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Md5UpdateLarge(Md5Context*, const void*, size_t);
+
+/*
+ * Md5CalculateLarge
+ *
+ * Md5Calculate for a size_t length.
+ */
+extern void Md5CalculateLarge(const void*, size_t, MD5_HASH*);
+
+/*
+ *  Md5MultiInitialise
+ *
+ *  Initialises a multi-buffer MD5 scheduler (16 lanes with AVX-512, 8 with
+ * AVX2, one message at a time otherwise).
+ */
+extern void Md5MultiInitialise(Md5MultiContext*);
+
+/*
+ *  Md5MultiSubmit
+ *
+ *  Queues a message whose MD5 will be written to Digest. When every lane is
+ * busy, lanes are advanced until one finishes. Buffer must stay valid until its
+ * digest has been written. Returns the number of digests completed.
+ */
+extern size_t Md5MultiSubmit(Md5MultiContext*,const void*,size_t,MD5_HASH*);
+
+/*
+ *  Md5MultiFlush
+ *
+ *  Runs every submitted message to completion. Returns the number of digests
+ * completed.
+ */
+extern size_t Md5MultiFlush(Md5MultiContext*);
+
+/*
+ *  Md5CalculateBatch
+ *
+ *  Calculates the MD5 hash of Count independent buffers (Buffers[i] of
+ * Sizes[i] bytes into Digests[i]) through the multi-buffer scheduler.
+ */
+extern void Md5CalculateBatch(const void* const*,const size_t*,size_t,MD5_HASH*);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,23 @@
+/*
+ * WjCryptLib_MultiBuffer
+ *
+ * Lane bookkeeping shared by the multi-buffer hash schedulers. Do not modify the contents of these structures
+ * directly.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define HASH_LANES_MAX		16
+#define HASH_LANE_BLOCK_MAX	128
+
+typedef struct {
+	const uint8_t*	Data;
+	size_t		Blocks;
+	uint32_t	BlockSize;
+	uint32_t	TailBlocks;
+	uint32_t	TailOffset;
+	uint8_t		Tail[2 * HASH_LANE_BLOCK_MAX];
+} HashLane;
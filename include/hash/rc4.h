@@ -9,6 +9,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +35,13 @@ extern void Rc4Initialise(Rc4Context*,const void*,uint32_t,uint32_t);
  */
 extern void Rc4Output(Rc4Context*,void*,uint32_t);
 
+/*
+ *  Rc4OutputLarge
+ *
+ *  Rc4Output for a size_t length.
+ */
+extern void Rc4OutputLarge(Rc4Context*,void*,size_t);
+
 /*
  *  Rc4Xor
  *
@@ -42,6 +50,13 @@ extern void Rc4Output(Rc4Context*,void*,uint32_t);
  */
 extern void Rc4Xor(Rc4Context*, const void*, void*, uint32_t);
 
+/*
+ *  Rc4XorLarge
+ *
+ *  Rc4Xor for a size_t length.
+ */
+extern void Rc4XorLarge(Rc4Context*, const void*, void*, size_t);
+
 /*
  * Rc4XorWithKey
  *
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define SHA1_BLOCK_SIZE 64
 #define SHA1_HASH_SIZE 20
@@ -69,6 +70,21 @@ extern void Sha1Finalise(Sha1Context *Context, SHA1_HASH *Digest);
  */
 extern void Sha1Calculate(const void *Buffer, uint32_t BufferSize, SHA1_HASH *Digest);
 
+/*
+ * Sha1UpdateLarge
+ *
+ * Sha1Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Sha1UpdateLarge(Sha1Context*, const void*, size_t);
+
+/*
+ * Sha1CalculateLarge
+ *
+ * Sha1Calculate for a size_t length.
+ */
+extern void Sha1CalculateLarge(const void*, size_t, SHA1_HASH*);
+
 #ifdef __cplusplus
 }
 #endif
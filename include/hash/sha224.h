@@ -25,6 +25,7 @@
 #define __SHA224I_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define SHA224_BLOCK_SIZE 64
 #define SHA224_HASH_SIZE  28
@@ -77,6 +78,21 @@ extern void Sha224Finalise(Sha224Context*, SHA224_HASH*);
  */
 extern void Sha224Calculate(const void*, uint32_t, SHA224_HASH *);
 
+/*
+ * Sha224UpdateLarge
+ *
+ * Sha224Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Sha224UpdateLarge(Sha224Context*, const void*, size_t);
+
+/*
+ * Sha224CalculateLarge
+ *
+ * Sha224Calculate for a size_t length.
+ */
+extern void Sha224CalculateLarge(const void*, size_t, SHA224_HASH*);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,7 @@
 #define __SHA256I_H__
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define SHA256_BLOCK_SIZE 64
 #define SHA256_HASH_SIZE 32
@@ -77,6 +78,30 @@ extern void Sha256Finalise(Sha256Context*, SHA256_HASH*);
  */
 extern void Sha256Calculate(const void*, uint32_t, SHA256_HASH *);
 
+/*
+ * Sha256UpdateLarge
+ *
+ * Sha256Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Sha256UpdateLarge(Sha256Context*, const void*, size_t);
+
+/*
+ * Sha256CalculateLarge
+ *
+ * Sha256Calculate for a size_t length.
+ */
+extern void Sha256CalculateLarge(const void*, size_t, SHA256_HASH*);
+
+/*
+ * Sha256CalculateBatch
+ *
+ * Calculates the SHA256 hash of Count independent buffers (Buffers[i] of
+ * Sizes[i] bytes into Digests[i]), several at a time in SIMD lanes when the CPU
+ * supports AVX2 or AVX-512.
+ */
+extern void Sha256CalculateBatch(const void* const*, const size_t*, size_t, SHA256_HASH*);
+
 #ifdef __cplusplus
 }
 #endif
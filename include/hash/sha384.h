@@ -12,17 +12,15 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
-#define SHA384_BLOCK_SIZE 128
+#include "sha512.h"
+
+#define SHA384_BLOCK_SIZE SHA512_BLOCK_SIZE
 #define SHA384_HASH_SIZE  48
 
-typedef struct {
-	uint64_t length_high;   /* high 64 bits of bit length */
-	uint64_t length_low;    /* low  64 bits of bit length */
-	uint64_t state[8];      /* 8 x 64-bit state words */
-	uint32_t curlen;	/* number of bytes currently in buf */
-	uint8_t  buf[SHA384_BLOCK_SIZE];
-} Sha384Context;
+// SHA-384 is SHA-512 with a different initial value, truncated to 384 bits
+typedef Sha512Context Sha384Context;
 
 typedef struct {
 	uint8_t bytes[SHA384_HASH_SIZE];
@@ -61,6 +59,29 @@ extern void Sha384Finalise(Sha384Context*,SHA384_HASH*);
  */
 extern void Sha384Calculate(const void*,uint32_t,SHA384_HASH*);
 
+/*
+ * Sha384UpdateLarge
+ *
+ * Sha384Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Sha384UpdateLarge(Sha384Context*, const void*, size_t);
+
+/*
+ * Sha384CalculateLarge
+ *
+ * Sha384Calculate for a size_t length.
+ */
+extern void Sha384CalculateLarge(const void*, size_t, SHA384_HASH*);
+
+/*
+ * Sha384CalculateBatch
+ *
+ * Calculates the SHA384 hash of Count independent buffers (Buffers[i] of
+ * Sizes[i] bytes into Digests[i]) on the multi-buffer SHA-512 core.
+ */
+extern void Sha384CalculateBatch(const void* const*,const size_t*,size_t,SHA384_HASH*);
+
 #ifdef __cplusplus
 }
 #endif
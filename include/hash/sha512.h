@@ -11,6 +11,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define SHA512_BLOCK_SIZE 128
 #define SHA512_HASH_SIZE  64
@@ -62,6 +63,29 @@ extern void Sha512Finalise(Sha512Context* Context, SHA512_HASH* Digest);
  */
 extern void Sha512Calculate(const void* Buffer, uint32_t BufferSize, SHA512_HASH* Digest);
 
+/*
+ * Sha512UpdateLarge
+ *
+ * Sha512Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Sha512UpdateLarge(Sha512Context*, const void*, size_t);
+
+/*
+ * Sha512CalculateLarge
+ *
+ * Sha512Calculate for a size_t length.
+ */
+extern void Sha512CalculateLarge(const void*, size_t, SHA512_HASH*);
+
+/*
+ * Sha512CalculateBatch
+ *
+ * Calculates the SHA512 hash of Count independent buffers (Buffers[i] of Sizes[i] bytes into Digests[i]), four at a
+ * time in AVX2 lanes when the CPU supports it.
+ */
+extern void Sha512CalculateBatch(const void* const* Buffers, const size_t* Sizes, size_t Count, SHA512_HASH* Digests);
+
 #ifdef __cplusplus
 }
 #endif
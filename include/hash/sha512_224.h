@@ -0,0 +1,76 @@
+/*
+ *  WjCryptLib_Sha512_224
+ *
+ *  SHA-512/224 (FIPS 180-4): the SHA-512 compression function with its own initial value, truncated to 224 bits.
+ *  Shares the SHA-512 context.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sha512.h"
+
+#define SHA512_224_BLOCK_SIZE SHA512_BLOCK_SIZE
+#define SHA512_224_HASH_SIZE  28
+
+typedef Sha512Context Sha512_224Context;
+
+typedef struct {
+	uint8_t	bytes[SHA512_224_HASH_SIZE];
+} SHA512_224_HASH;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ *  Sha512_224Initialise
+ *
+ *  Initialises a SHA-512/224 Context. Use this to initialise/reset a context.
+ */
+extern void Sha512_224Initialise(Sha512_224Context* Context);
+
+/*
+ *  Sha512_224Update
+ *
+ *  Adds data to the SHA-512/224 context. This will process the data and update the internal state of the context.
+ *  Keep on calling this function until all the data has been added. Then call Sha512_224Finalise to calculate the hash.
+ */
+extern void Sha512_224Update(Sha512_224Context* Context, const void* Buffer, uint32_t BufferSize);
+
+/*
+ *  Sha512_224Finalise
+ *
+ *  Performs the final calculation of the hash and returns the digest (28 byte buffer containing 224bit hash).
+ *  After calling this, Sha512_224Initialise must be used to reuse the context.
+ */
+extern void Sha512_224Finalise(Sha512_224Context* Context, SHA512_224_HASH* Digest);
+
+/*
+ *  Sha512_224Calculate
+ *
+ *  Combines Sha512_224Initialise, Sha512_224Update, and Sha512_224Finalise into one function. Calculates the SHA-512/224 hash of
+ *  the buffer.
+ */
+extern void Sha512_224Calculate(const void* Buffer, uint32_t BufferSize, SHA512_224_HASH* Digest);
+
+/*
+ * Sha512_224UpdateLarge
+ *
+ * Sha512_224Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Sha512_224UpdateLarge(Sha512_224Context*, const void*, size_t);
+
+/*
+ * Sha512_224CalculateLarge
+ *
+ * Sha512_224Calculate for a size_t length.
+ */
+extern void Sha512_224CalculateLarge(const void*, size_t, SHA512_224_HASH*);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+/*
+ *  WjCryptLib_Sha512_256
+ *
+ *  SHA-512/256 (FIPS 180-4): the SHA-512 compression function with its own initial value, truncated to 256 bits.
+ *  Shares the SHA-512 context.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sha512.h"
+
+#define SHA512_256_BLOCK_SIZE SHA512_BLOCK_SIZE
+#define SHA512_256_HASH_SIZE  32
+
+typedef Sha512Context Sha512_256Context;
+
+typedef struct {
+	uint8_t	bytes[SHA512_256_HASH_SIZE];
+} SHA512_256_HASH;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ *  Sha512_256Initialise
+ *
+ *  Initialises a SHA-512/256 Context. Use this to initialise/reset a context.
+ */
+extern void Sha512_256Initialise(Sha512_256Context* Context);
+
+/*
+ *  Sha512_256Update
+ *
+ *  Adds data to the SHA-512/256 context. This will process the data and update the internal state of the context.
+ *  Keep on calling this function until all the data has been added. Then call Sha512_256Finalise to calculate the hash.
+ */
+extern void Sha512_256Update(Sha512_256Context* Context, const void* Buffer, uint32_t BufferSize);
+
+/*
+ *  Sha512_256Finalise
+ *
+ *  Performs the final calculation of the hash and returns the digest (32 byte buffer containing 256bit hash).
+ *  After calling this, Sha512_256Initialise must be used to reuse the context.
+ */
+extern void Sha512_256Finalise(Sha512_256Context* Context, SHA512_256_HASH* Digest);
+
+/*
+ *  Sha512_256Calculate
+ *
+ *  Combines Sha512_256Initialise, Sha512_256Update, and Sha512_256Finalise into one function. Calculates the SHA-512/256 hash of
+ *  the buffer.
+ */
+extern void Sha512_256Calculate(const void* Buffer, uint32_t BufferSize, SHA512_256_HASH* Digest);
+
+/*
+ * Sha512_256UpdateLarge
+ *
+ * Sha512_256Update for a size_t length, so buffers of 4 GB and more can be added in
+ * one call.
+ */
+extern void Sha512_256UpdateLarge(Sha512_256Context*, const void*, size_t);
+
+/*
+ * Sha512_256CalculateLarge
+ *
+ * Sha512_256Calculate for a size_t length.
+ */
+extern void Sha512_256CalculateLarge(const void*, size_t, SHA512_256_HASH*);
+
+#ifdef __cplusplus
+}
+#endif
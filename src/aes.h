@@ -23,6 +23,9 @@
 #include <stdint.h>
 #include <memory.h>
 #include <string.h>
+#include <assert.h>
+
+#include "cpufeatures.h"
 
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
 #define inline __inline
@@ -56,6 +59,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes (a multiple of every block size)
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -82,8 +90,14 @@ typedef struct {
 	unsigned int  eK[60];
 	unsigned int  dK[60];
 	unsigned long Nr;
+	uint32_t      Flags;	// AES_CONTEXT_* bits describing how eK/dK are laid out
 } AesContext;
 
+// eK/dK hold the round keys as 16-byte AES-NI blocks instead of big-endian table words
+#define AES_CONTEXT_AESNI	0x1
+// dK has not been derived (AesInitialiseEncryptOnly)
+#define AES_CONTEXT_NO_DECRYPT	0x2
+
 static const uint32_t TE0[256] = {
 	0xc66363a5UL,0xf87c7c84UL,0xee777799UL,0xf67b7b8dUL,0xfff2f20dUL,0xd66b6bbdUL,0xde6f6fb1UL,0x91c5c554UL,
 	0x60303050UL,0x02010103UL,0xce6767a9UL,0x562b2b7dUL,0xe7fefe19UL,0xb5d7d762UL,0x4dababe6UL,0xec76769aUL,
@@ -685,10 +699,86 @@ static const uint32_t rcon[] = {
 	0x1B000000UL,0x36000000UL,// for 128-bit blocks, Rijndael never uses more than 10 rcon values
 };
 
+/*
+ *  XorBuffersWords
+ *
+ * Portable XorBuffers: 8 bytes at a time (through memcpy, so the buffers need no alignment) with a byte loop for the
+ * tail.
+ */
+static inline void XorBuffersWords(const uint8_t* SourceBuffer1, const uint8_t* SourceBuffer2, uint8_t* DestinationBuffer,
+				   uint32_t Amount) {
+	uint64_t a, b;
+	uint32_t i = 0;
+	for(; i + 8 <= Amount; i += 8) {
+		memcpy(&a, SourceBuffer1 + i, 8);
+		memcpy(&b, SourceBuffer2 + i, 8);
+		a ^= b;
+		memcpy(DestinationBuffer + i, &a, 8);
+	}
+	for(; i<Amount; i++) DestinationBuffer[i] = SourceBuffer1[i]^SourceBuffer2[i];
+}
+
+#if HASH_USE_CPU_DISPATCH
+#define AES_XOR_SSE2(LOAD, STORE)	for(; i + 64 <= Amount; i += 64) { \
+		STORE((__m128i*)(d + i), _mm_xor_si128(LOAD((const __m128i*)(a + i)), LOAD((const __m128i*)(b + i)))); \
+		STORE((__m128i*)(d + i + 16), _mm_xor_si128(LOAD((const __m128i*)(a + i + 16)), LOAD((const __m128i*)(b + i + 16)))); \
+		STORE((__m128i*)(d + i + 32), _mm_xor_si128(LOAD((const __m128i*)(a + i + 32)), LOAD((const __m128i*)(b + i + 32)))); \
+		STORE((__m128i*)(d + i + 48), _mm_xor_si128(LOAD((const __m128i*)(a + i + 48)), LOAD((const __m128i*)(b + i + 48)))); \
+	} \
+	for(; i + 16 <= Amount; i += 16) \
+		STORE((__m128i*)(d + i), _mm_xor_si128(LOAD((const __m128i*)(a + i)), LOAD((const __m128i*)(b + i))))
+#define AES_XOR_AVX2(LOAD, STORE)	for(; i + 128 <= Amount; i += 128) { \
+		STORE((__m256i*)(d + i), _mm256_xor_si256(LOAD((const __m256i*)(a + i)), LOAD((const __m256i*)(b + i)))); \
+		STORE((__m256i*)(d + i + 32), _mm256_xor_si256(LOAD((const __m256i*)(a + i + 32)), LOAD((const __m256i*)(b + i + 32)))); \
+		STORE((__m256i*)(d + i + 64), _mm256_xor_si256(LOAD((const __m256i*)(a + i + 64)), LOAD((const __m256i*)(b + i + 64)))); \
+		STORE((__m256i*)(d + i + 96), _mm256_xor_si256(LOAD((const __m256i*)(a + i + 96)), LOAD((const __m256i*)(b + i + 96)))); \
+	} \
+	for(; i + 32 <= Amount; i += 32) \
+		STORE((__m256i*)(d + i), _mm256_xor_si256(LOAD((const __m256i*)(a + i)), LOAD((const __m256i*)(b + i))))
+
+/*
+ *  XorBuffersSse2
+ *
+ * SSE2 XorBuffers, 64 bytes per iteration. Aligned loads and stores are used when all three buffers are 16-byte
+ * aligned, unaligned ones otherwise; the last bytes go through XorBuffersWords.
+ */
+LIBHASH_TARGET("sse2")
+static void XorBuffersSse2(const uint8_t* a, const uint8_t* b, uint8_t* d, uint32_t Amount) {
+	uint32_t i = 0;
+	if(((uintptr_t)a | (uintptr_t)b | (uintptr_t)d) & 15) {
+		AES_XOR_SSE2(_mm_loadu_si128, _mm_storeu_si128);
+	} else {
+		AES_XOR_SSE2(_mm_load_si128, _mm_store_si128);
+	}
+	XorBuffersWords(a + i, b + i, d + i, Amount - i);
+}
+
+/*
+ *  XorBuffersAvx2
+ *
+ * AVX2 XorBuffers, 128 bytes per iteration, with the same aligned (32 bytes here) and unaligned paths.
+ */
+LIBHASH_TARGET("avx2")
+static void XorBuffersAvx2(const uint8_t* a, const uint8_t* b, uint8_t* d, uint32_t Amount) {
+	uint32_t i = 0;
+	if(((uintptr_t)a | (uintptr_t)b | (uintptr_t)d) & 31) {
+		AES_XOR_AVX2(_mm256_loadu_si256, _mm256_storeu_si256);
+	} else {
+		AES_XOR_AVX2(_mm256_load_si256, _mm256_store_si256);
+	}
+	XorBuffersWords(a + i, b + i, d + i, Amount - i);
+}
+
+#undef AES_XOR_SSE2
+#undef AES_XOR_AVX2
+#endif
+
 /*
  *  XorBuffer
  *
- * Takes two Source buffers and XORs them together and puts the result in DestinationBuffer
+ * Takes two Source buffers and XORs them together and puts the result in DestinationBuffer. Buffers of at least 32
+ * bytes go through the widest vector unit the CPU has (AVX2 or SSE2), shorter ones are XORed 8 bytes at a time. The
+ * destination may be one of the sources.
  */
 LIBHASH_INLINE_API void XorBuffers(
 	const uint8_t* SourceBuffer1,
@@ -696,19 +786,72 @@ LIBHASH_INLINE_API void XorBuffers(
 	uint8_t* DestinationBuffer,
 	uint32_t Amount
 ) {
-	for(uint32_t i=0; i<Amount; i++) DestinationBuffer[i] = SourceBuffer1[i]^SourceBuffer2[i];
+#if HASH_USE_CPU_DISPATCH
+	if(Amount >= 32) {
+		uint32_t features = libhash_cpu_features();
+		if(features & HASH_CPU_AVX2) {
+			XorBuffersAvx2(SourceBuffer1, SourceBuffer2, DestinationBuffer, Amount);
+			return;
+		}
+		if(features & HASH_CPU_SSE2) {
+			XorBuffersSse2(SourceBuffer1, SourceBuffer2, DestinationBuffer, Amount);
+			return;
+		}
+	}
+#endif
+	XorBuffersWords(SourceBuffer1, SourceBuffer2, DestinationBuffer, Amount);
 }
 
 /*
- *  AesInitialise
+ *  XorBuffersLarge
  *
- *  Initialises an AesContext with an AES Key. KeySize must be 16, 24, or 32 (for 128, 192, or 256 bit key size)
- *  Returns 0 if successful, or -1 if invalid KeySize provided
+ * XorBuffers for a size_t length.
  */
-LIBHASH_INLINE_API int AesInitialise(AesContext* Context, const void* Key, uint32_t KeySize) {
+LIBHASH_INLINE_API void XorBuffersLarge(
+	const uint8_t* SourceBuffer1,
+	const uint8_t* SourceBuffer2,
+	uint8_t* DestinationBuffer,
+	size_t Amount
+) {
+	for(; Amount > HASH_LARGE_STRIDE; Amount -= HASH_LARGE_STRIDE) {
+		XorBuffers(SourceBuffer1, SourceBuffer2, DestinationBuffer, HASH_LARGE_STRIDE);
+		SourceBuffer1 += HASH_LARGE_STRIDE;
+		SourceBuffer2 += HASH_LARGE_STRIDE;
+		DestinationBuffer += HASH_LARGE_STRIDE;
+	}
+	XorBuffers(SourceBuffer1, SourceBuffer2, DestinationBuffer, hash_cast(uint32_t,Amount));
+}
+
+/*
+ *  XorAesBlock
+ *
+ *  Takes two source blocks (size AES_BLOCK_SIZE) and XORs them together and
+ * puts the result in first block. Two 64-bit words, or one SSE2 register where
+ * SSE2 is part of the baseline (x86-64).
+ */
+LIBHASH_INLINE_API void XorAesBlock(uint8_t *Block1, const uint8_t *Block2) {
+#if HASH_USE_CPU_DISPATCH && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	_mm_storeu_si128((__m128i*)Block1, _mm_xor_si128(_mm_loadu_si128((const __m128i*)Block1),
+							 _mm_loadu_si128((const __m128i*)Block2)));
+#else
+	uint64_t a[2], b[2];
+	memcpy(a, Block1, AES_BLOCK_SIZE);
+	memcpy(b, Block2, AES_BLOCK_SIZE);
+	a[0] ^= b[0];
+	a[1] ^= b[1];
+	memcpy(Block1, a, AES_BLOCK_SIZE);
+#endif
+}
+
+/*
+ *  AesInitialiseTable
+ *
+ *  Portable key schedule: expands Key into big-endian encryption round key words for the T-table code.
+ */
+static inline int AesInitialiseTable(AesContext* Context, const void* Key, uint32_t KeySize) {
 	const uint8_t* key = (const uint8_t*)Key;
 	uint_fast32_t i = 0;
-	uint32_t temp, *rk, *rrk;
+	uint32_t temp, *rk;
 	Context->Nr = 10 + ((KeySize/8)-2)*2;
 	rk = Context->eK;
 	rk[0] = hash_cast(uint32_t,((key)[0] & 255) << 24) |
@@ -803,8 +946,20 @@ LIBHASH_INLINE_API int AesInitialise(AesContext* Context, const void* Key, uint3
 			rk += 8;
 		}
 	} else { return -1; }
+	return 0;
+}
+
+/*
+ *  AesDecryptKeyTable
+ *
+ *  Portable decryption schedule: the encryption round keys in reverse order with InvMixColumns (Tks0..3) applied to
+ *  the inner rounds.
+ */
+static inline void AesDecryptKeyTable(AesContext* Context) {
+	uint_fast32_t i;
+	uint32_t temp, *rk, *rrk;
 	rk  = Context->dK;
-	rrk = Context->eK + (28 + KeySize) - 4;
+	rrk = Context->eK + 4 * Context->Nr;
 	*rk++ = *rrk++;
 	*rk++ = *rrk++;
 	*rk++ = *rrk++;
@@ -824,17 +979,14 @@ LIBHASH_INLINE_API int AesInitialise(AesContext* Context, const void* Key, uint3
 	*rk++ = *rrk++;
 	*rk++ = *rrk++;
 	*rk   = *rrk;
-	return 0;
 }
 
 /*
- *  AesEncrypt
+ *  AesEncryptTable
  *
- *  Performs an AES encryption of one block (128 bits) with the AesContext initialised with one of the functions
- *  AesInitialise[n]. Input and Output can point to same memory location, however it is more efficient to use
- *  AesEncryptInPlace in this situation.
+ *  Portable T-table encryption of one block.
  */
-LIBHASH_INLINE_API void AesEncrypt(const AesContext* Context, const uint8_t Input[AES_BLOCK_SIZE], uint8_t Output[AES_BLOCK_SIZE]) {
+static inline void AesEncryptTable(const AesContext* Context, const uint8_t Input[AES_BLOCK_SIZE], uint8_t Output[AES_BLOCK_SIZE]) {
 	uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
 	const uint32_t* rk;
 	uint_fast32_t   r;
@@ -896,13 +1048,11 @@ LIBHASH_INLINE_API void AesEncrypt(const AesContext* Context, const uint8_t Inpu
 }
 
 /*
- *  AesDecrypt
+ *  AesDecryptTable
  *
- *  Performs an AES decryption of one block (128 bits) with the AesContext initialised with one of the functions
- *  AesInitialise[n]. Input and Output can point to same memory location, however it is more efficient to use
- *  AesDecryptInPlace in this situation.
+ *  Portable T-table decryption of one block.
  */
-LIBHASH_INLINE_API void AesDecrypt(
+static inline void AesDecryptTable(
 	const AesContext* Context,
 	const uint8_t Input[AES_BLOCK_SIZE],
 	uint8_t Output[AES_BLOCK_SIZE]
@@ -970,6 +1120,245 @@ LIBHASH_INLINE_API void AesDecrypt(
 	(Output+12)[3] = hash_cast(uint8_t,((s3) & 255));
 }
 
+#if HASH_USE_CPU_DISPATCH
+/*
+ *  AesInitialiseAesNi
+ *
+ *  AES-NI key schedule. The FIPS-197 expansion is run word by word, with AESKEYGENASSIST providing SubWord(RotWord())
+ *  and SubWord(), so one routine covers all three key sizes.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesInitialiseAesNi(AesContext* Context, const uint8_t* Key, uint32_t KeySize) {
+	uint32_t w[60], temp, nk = KeySize / 4, total, i;
+	uint32_t rc = 1;
+	__m128i x;
+	Context->Nr = nk + 6;
+	total = 4 * (uint32_t)(Context->Nr + 1);
+	memcpy(w, Key, KeySize);
+	for(i = nk; i < total; i++) {
+		temp = w[i - 1];
+		if(i % nk == 0) {
+			x = _mm_aeskeygenassist_si128(_mm_set_epi32(0, 0, (int)temp, 0), 0);
+			temp = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(x, 4)) ^ rc;
+			rc = (rc << 1) ^ ((rc >> 7) * 0x11b);
+		} else if(nk == 8 && i % nk == 4) {
+			x = _mm_aeskeygenassist_si128(_mm_set_epi32(0, 0, (int)temp, 0), 0);
+			temp = (uint32_t)_mm_cvtsi128_si32(x);
+		}
+		w[i] = w[i - nk] ^ temp;
+	}
+	memcpy(Context->eK, w, total * 4);
+	Context->Flags = AES_CONTEXT_AESNI;
+}
+
+/*
+ *  AesDecryptKeyAesNi
+ *
+ *  AES-NI decryption schedule: the encryption schedule in reverse order with AESIMC (InvMixColumns) applied to the
+ *  inner round keys, as AESDEC expects.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesDecryptKeyAesNi(AesContext* Context) {
+	const __m128i* ek = (const __m128i*)Context->eK;
+	__m128i* dk = (__m128i*)Context->dK;
+	uint_fast32_t i, nr = Context->Nr;
+	_mm_storeu_si128(dk, _mm_loadu_si128(ek + nr));
+	for(i = 1; i < nr; i++) _mm_storeu_si128(dk + i, _mm_aesimc_si128(_mm_loadu_si128(ek + nr - i)));
+	_mm_storeu_si128(dk + nr, _mm_loadu_si128(ek));
+}
+
+/*
+ *  AesEncryptAesNi
+ *
+ *  AES-NI encryption of one block.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesEncryptAesNi(const AesContext* Context, const uint8_t Input[AES_BLOCK_SIZE], uint8_t Output[AES_BLOCK_SIZE]) {
+	const __m128i* rk = (const __m128i*)Context->eK;
+	uint_fast32_t r, nr = Context->Nr;
+	__m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)Input), _mm_loadu_si128(rk));
+	for(r = 1; r < nr; r++) b = _mm_aesenc_si128(b, _mm_loadu_si128(rk + r));
+	b = _mm_aesenclast_si128(b, _mm_loadu_si128(rk + nr));
+	_mm_storeu_si128((__m128i*)Output, b);
+}
+
+/*
+ *  AesDecryptAesNi
+ *
+ *  AES-NI decryption of one block.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesDecryptAesNi(const AesContext* Context, const uint8_t Input[AES_BLOCK_SIZE], uint8_t Output[AES_BLOCK_SIZE]) {
+	const __m128i* rk = (const __m128i*)Context->dK;
+	uint_fast32_t r, nr = Context->Nr;
+	__m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)Input), _mm_loadu_si128(rk));
+	for(r = 1; r < nr; r++) b = _mm_aesdec_si128(b, _mm_loadu_si128(rk + r));
+	b = _mm_aesdeclast_si128(b, _mm_loadu_si128(rk + nr));
+	_mm_storeu_si128((__m128i*)Output, b);
+}
+
+#define AES_PIPELINE 8
+
+#define AES_NI_EACH(OP, x)	b0 = OP(b0, x); b1 = OP(b1, x); b2 = OP(b2, x); b3 = OP(b3, x); \
+				b4 = OP(b4, x); b5 = OP(b5, x); b6 = OP(b6, x); b7 = OP(b7, x)
+#define AES_NI_LOAD(j)		_mm_xor_si128(_mm_loadu_si128((const __m128i*)(Input + AES_BLOCK_SIZE * (j))), k[0])
+#define AES_NI_STORE(b, j)	_mm_storeu_si128((__m128i*)(Output + AES_BLOCK_SIZE * (j)), b)
+
+/*
+ *  AesEncryptBlocksAesNi
+ *
+ *  AES-NI encryption of Blocks independent blocks. The round keys stay in registers for the whole call and
+ *  AES_PIPELINE blocks go through the rounds together, so the AESENC latency is hidden behind independent blocks.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesEncryptBlocksAesNi(const AesContext* Context, const uint8_t* Input, uint8_t* Output, size_t Blocks) {
+	const __m128i* rk = (const __m128i*)Context->eK;
+	__m128i k[15], b0, b1, b2, b3, b4, b5, b6, b7;
+	uint_fast32_t r, nr = Context->Nr;
+	for(r = 0; r <= nr; r++) k[r] = _mm_loadu_si128(rk + r);
+	for(; Blocks >= AES_PIPELINE; Blocks -= AES_PIPELINE) {
+		b0 = AES_NI_LOAD(0); b1 = AES_NI_LOAD(1); b2 = AES_NI_LOAD(2); b3 = AES_NI_LOAD(3);
+		b4 = AES_NI_LOAD(4); b5 = AES_NI_LOAD(5); b6 = AES_NI_LOAD(6); b7 = AES_NI_LOAD(7);
+		for(r = 1; r < nr; r++) {
+			AES_NI_EACH(_mm_aesenc_si128, k[r]);
+		}
+		AES_NI_EACH(_mm_aesenclast_si128, k[nr]);
+		AES_NI_STORE(b0, 0); AES_NI_STORE(b1, 1); AES_NI_STORE(b2, 2); AES_NI_STORE(b3, 3);
+		AES_NI_STORE(b4, 4); AES_NI_STORE(b5, 5); AES_NI_STORE(b6, 6); AES_NI_STORE(b7, 7);
+		Input += AES_PIPELINE * AES_BLOCK_SIZE;
+		Output += AES_PIPELINE * AES_BLOCK_SIZE;
+	}
+	for(; Blocks; Blocks--) {
+		b0 = AES_NI_LOAD(0);
+		for(r = 1; r < nr; r++) b0 = _mm_aesenc_si128(b0, k[r]);
+		AES_NI_STORE(_mm_aesenclast_si128(b0, k[nr]), 0);
+		Input += AES_BLOCK_SIZE;
+		Output += AES_BLOCK_SIZE;
+	}
+}
+
+/*
+ *  AesDecryptBlocksAesNi
+ *
+ *  AES-NI decryption of Blocks independent blocks, AES_PIPELINE at a time.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesDecryptBlocksAesNi(const AesContext* Context, const uint8_t* Input, uint8_t* Output, size_t Blocks) {
+	const __m128i* rk = (const __m128i*)Context->dK;
+	__m128i k[15], b0, b1, b2, b3, b4, b5, b6, b7;
+	uint_fast32_t r, nr = Context->Nr;
+	for(r = 0; r <= nr; r++) k[r] = _mm_loadu_si128(rk + r);
+	for(; Blocks >= AES_PIPELINE; Blocks -= AES_PIPELINE) {
+		b0 = AES_NI_LOAD(0); b1 = AES_NI_LOAD(1); b2 = AES_NI_LOAD(2); b3 = AES_NI_LOAD(3);
+		b4 = AES_NI_LOAD(4); b5 = AES_NI_LOAD(5); b6 = AES_NI_LOAD(6); b7 = AES_NI_LOAD(7);
+		for(r = 1; r < nr; r++) {
+			AES_NI_EACH(_mm_aesdec_si128, k[r]);
+		}
+		AES_NI_EACH(_mm_aesdeclast_si128, k[nr]);
+		AES_NI_STORE(b0, 0); AES_NI_STORE(b1, 1); AES_NI_STORE(b2, 2); AES_NI_STORE(b3, 3);
+		AES_NI_STORE(b4, 4); AES_NI_STORE(b5, 5); AES_NI_STORE(b6, 6); AES_NI_STORE(b7, 7);
+		Input += AES_PIPELINE * AES_BLOCK_SIZE;
+		Output += AES_PIPELINE * AES_BLOCK_SIZE;
+	}
+	for(; Blocks; Blocks--) {
+		b0 = AES_NI_LOAD(0);
+		for(r = 1; r < nr; r++) b0 = _mm_aesdec_si128(b0, k[r]);
+		AES_NI_STORE(_mm_aesdeclast_si128(b0, k[nr]), 0);
+		Input += AES_BLOCK_SIZE;
+		Output += AES_BLOCK_SIZE;
+	}
+}
+
+#undef AES_NI_EACH
+#undef AES_NI_LOAD
+#undef AES_NI_STORE
+#endif
+
+/*
+ *  AesInitialiseEncryptOnly
+ *
+ *  Initialises an AesContext for encryption only: just the encryption round keys are expanded and the context is
+ *  flagged AES_CONTEXT_NO_DECRYPT. Suited to CTR and OFB, which never run the inverse cipher. The decryption
+ *  schedule can be added later with AesExpandDecryptKey. KeySize must be 16, 24, or 32. Returns 0 if successful, or
+ *  -1 if invalid KeySize provided.
+ */
+LIBHASH_INLINE_API int AesInitialiseEncryptOnly(AesContext* Context, const void* Key, uint32_t KeySize) {
+	if(KeySize != AES_KEY_SIZE_128 && KeySize != AES_KEY_SIZE_192 && KeySize != AES_KEY_SIZE_256) return -1;
+#if HASH_USE_CPU_DISPATCH
+	if(libhash_cpu_features() & HASH_CPU_AESNI) {
+		AesInitialiseAesNi(Context, (const uint8_t*)Key, KeySize);
+		Context->Flags |= AES_CONTEXT_NO_DECRYPT;
+		return 0;
+	}
+#endif
+	Context->Flags = AES_CONTEXT_NO_DECRYPT;
+	return AesInitialiseTable(Context, Key, KeySize);
+}
+
+/*
+ *  AesExpandDecryptKey
+ *
+ *  Derives the decryption round keys of a context initialised with AesInitialiseEncryptOnly. Does nothing if the
+ *  context already has them.
+ */
+LIBHASH_INLINE_API void AesExpandDecryptKey(AesContext* Context) {
+	if(!(Context->Flags & AES_CONTEXT_NO_DECRYPT)) return;
+#if HASH_USE_CPU_DISPATCH
+	if(Context->Flags & AES_CONTEXT_AESNI) AesDecryptKeyAesNi(Context);
+	else
+#endif
+	AesDecryptKeyTable(Context);
+	Context->Flags &= ~(uint32_t)AES_CONTEXT_NO_DECRYPT;
+}
+
+/*
+ *  AesInitialise
+ *
+ *  Initialises an AesContext with an AES Key. KeySize must be 16, 24, or 32 (for 128, 192, or 256 bit key size)
+ *  Returns 0 if successful, or -1 if invalid KeySize provided. The round keys are laid out for AES-NI when the CPU
+ *  has it, otherwise for the portable table code.
+ */
+LIBHASH_INLINE_API int AesInitialise(AesContext* Context, const void* Key, uint32_t KeySize) {
+	if(AesInitialiseEncryptOnly(Context, Key, KeySize) != 0) return -1;
+	AesExpandDecryptKey(Context);
+	return 0;
+}
+
+/*
+ *  AesEncrypt
+ *
+ *  Performs an AES encryption of one block (128 bits) with the AesContext initialised with one of the functions
+ *  AesInitialise[n]. Input and Output can point to same memory location, however it is more efficient to use
+ *  AesEncryptInPlace in this situation.
+ */
+LIBHASH_INLINE_API void AesEncrypt(const AesContext* Context, const uint8_t Input[AES_BLOCK_SIZE], uint8_t Output[AES_BLOCK_SIZE]) {
+#if HASH_USE_CPU_DISPATCH
+	if(Context->Flags & AES_CONTEXT_AESNI) {
+		AesEncryptAesNi(Context, Input, Output);
+		return;
+	}
+#endif
+	AesEncryptTable(Context, Input, Output);
+}
+
+/*
+ *  AesDecrypt
+ *
+ *  Performs an AES decryption of one block (128 bits) with the AesContext initialised with one of the functions
+ *  AesInitialise[n]. Input and Output can point to same memory location, however it is more efficient to use
+ *  AesDecryptInPlace in this situation. An encrypt-only context must have AesExpandDecryptKey run on it first.
+ */
+LIBHASH_INLINE_API void AesDecrypt(const AesContext* Context, const uint8_t Input[AES_BLOCK_SIZE], uint8_t Output[AES_BLOCK_SIZE]) {
+	assert(!(Context->Flags & AES_CONTEXT_NO_DECRYPT));
+#if HASH_USE_CPU_DISPATCH
+	if(Context->Flags & AES_CONTEXT_AESNI) {
+		AesDecryptAesNi(Context, Input, Output);
+		return;
+	}
+#endif
+	AesDecryptTable(Context, Input, Output);
+}
+
 /*
  *  AesEncryptInPlace
  *
@@ -990,6 +1379,44 @@ LIBHASH_INLINE_API void AesDecryptInPlace(const AesContext* Context, uint8_t Blo
 	AesDecrypt(Context, Block, Block);
 }
 
+/*
+ *  AesEncryptBlocks
+ *
+ *  Encrypts Blocks independent blocks (ECB) from Input to Output with the AesContext initialised with one of the
+ *  functions AesInitialise[n]. The backend is picked once per call rather than per block; with AES-NI the blocks go
+ *  through the rounds AES_PIPELINE at a time. Input and Output can point to the same memory location.
+ */
+LIBHASH_INLINE_API void AesEncryptBlocks(const AesContext* Context, const void* Input, void* Output, size_t Blocks) {
+	const uint8_t* in = hash_c_cast(const uint8_t*, Input);
+	uint8_t* out = uhash_cast(uint8_t*, Output);
+#if HASH_USE_CPU_DISPATCH
+	if(Context->Flags & AES_CONTEXT_AESNI) {
+		AesEncryptBlocksAesNi(Context, in, out, Blocks);
+		return;
+	}
+#endif
+	for(; Blocks; Blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE) AesEncryptTable(Context, in, out);
+}
+
+/*
+ *  AesDecryptBlocks
+ *
+ *  Decrypts Blocks independent blocks (ECB) from Input to Output. Input and Output can point to the same memory
+ *  location. An encrypt-only context must have AesExpandDecryptKey run on it first.
+ */
+LIBHASH_INLINE_API void AesDecryptBlocks(const AesContext* Context, const void* Input, void* Output, size_t Blocks) {
+	const uint8_t* in = hash_c_cast(const uint8_t*, Input);
+	uint8_t* out = uhash_cast(uint8_t*, Output);
+	assert(!(Context->Flags & AES_CONTEXT_NO_DECRYPT));
+#if HASH_USE_CPU_DISPATCH
+	if(Context->Flags & AES_CONTEXT_AESNI) {
+		AesDecryptBlocksAesNi(Context, in, out, Blocks);
+		return;
+	}
+#endif
+	for(; Blocks; Blocks--, in += AES_BLOCK_SIZE, out += AES_BLOCK_SIZE) AesDecryptTable(Context, in, out);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,14 +34,15 @@ typedef struct {
 } AesCbcContext;
 
 /*
- *  XorAesBlock
+ * AesCbcSharedContext
  *
- *  Takes two source blocks (size AESCBC_BLOCK_SIZE) and XORs them together and
- * puts the result in first block
+ * CBC chaining state over an externally owned key schedule. The AesContext is only read, so one initialised schedule
+ * can back any number of streams on any number of threads; it must outlive them.
  */
-LIBHASH_INLINE_API void XorAesBlock(uint8_t *Block1, const uint8_t *Block2) {
-	for (uint32_t i=0; i<AESCBC_BLOCK_SIZE; i++) Block1[i]^=Block2[i];
-}
+typedef struct {
+	const AesContext* Aes;
+	uint8_t PreviousCipherBlock[AESCBC_BLOCK_SIZE];
+} AesCbcSharedContext;
 
 /*
  *  AesCbcInitialise
@@ -72,6 +73,22 @@ LIBHASH_INLINE_API int AesCbcInitialiseWithKey(AesCbcContext *Context,const uint
 	return 0;
 }
 
+/*
+ *  AesCbcEncryptBlocks
+ *
+ *  CBC encryption of Blocks whole blocks, chained through Previous.
+ */
+static inline void AesCbcEncryptBlocks(const AesContext* Aes, uint8_t Previous[AESCBC_BLOCK_SIZE], const uint8_t* In,
+				       uint8_t* Out, size_t Blocks) {
+	for (; Blocks; Blocks--) {
+		XorAesBlock(Previous, In);
+		AesEncryptInPlace(Aes, Previous);
+		memcpy(Out, Previous, AESCBC_BLOCK_SIZE);
+		In += AESCBC_BLOCK_SIZE;
+		Out += AESCBC_BLOCK_SIZE;
+	}
+}
+
 /*
  *  AesCbcEncrypt
  *
@@ -84,37 +101,319 @@ LIBHASH_INLINE_API int AesCbcInitialiseWithKey(AesCbcContext *Context,const uint
  * is not a multiple of 16 bytes.
  */
 LIBHASH_INLINE_API int AesCbcEncrypt(AesCbcContext *Context, const void *InBuffer,  void *OutBuffer, uint32_t Size) {
-	uint32_t numBlocks = Size / AESCBC_BLOCK_SIZE, offset = 0, i;
 	if (Size % AESCBC_BLOCK_SIZE != 0) return -1;
-	for (i = 0; i<numBlocks; i++) {
-		XorAesBlock(Context->PreviousCipherBlock, (uint8_t*)InBuffer + offset);
-		AesEncryptInPlace(&Context->Aes, Context->PreviousCipherBlock);
-		memcpy(uhash_cast(uint8_t*, OutBuffer)+offset, Context->PreviousCipherBlock, AESCBC_BLOCK_SIZE);
-		offset += AESCBC_BLOCK_SIZE;
+	AesCbcEncryptBlocks(&Context->Aes, Context->PreviousCipherBlock, hash_c_cast(const uint8_t*, InBuffer),
+			    uhash_cast(uint8_t*, OutBuffer), Size / AESCBC_BLOCK_SIZE);
+	return 0;
+}
+
+#define AES_CBC_LANES 8
+
+#if HASH_USE_CPU_DISPATCH
+#define AES_CBC_X8_EACH(STEP)	STEP(0, b0) STEP(1, b1) STEP(2, b2) STEP(3, b3) STEP(4, b4) STEP(5, b5) STEP(6, b6) STEP(7, b7)
+#define AES_CBC_X8_CHAIN(j, b)	b = _mm_loadu_si128((const __m128i*)Chain[j]);
+#define AES_CBC_X8_FIRST(j, b)	b = _mm_xor_si128(_mm_xor_si128(b, _mm_loadu_si128((const __m128i*)In[j])), _mm_loadu_si128(Keys[j]));
+#define AES_CBC_X8_ROUND(j, b)	b = _mm_aesenc_si128(b, _mm_loadu_si128(Keys[j] + r));
+#define AES_CBC_X8_LAST(j, b)	b = _mm_aesenclast_si128(b, _mm_loadu_si128(Keys[j] + Nr)); \
+				_mm_storeu_si128((__m128i*)Out[j], b); In[j] += Stride[j]; Out[j] += Stride[j];
+#define AES_CBC_X8_SAVE(j, b)	_mm_storeu_si128((__m128i*)Chain[j], b);
+
+/*
+ *  AesCbcEncryptX8AesNi
+ *
+ *  Advances AES_CBC_LANES independent CBC chains by Steps blocks each. Every lane has its own round keys (Keys[j],
+ * all with Nr rounds), chaining block, input and output; the eight AESENC chains interleave in the pipeline. A lane
+ * with Stride 0 is a placeholder that keeps re-encrypting the same block into a scratch buffer.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesCbcEncryptX8AesNi(const __m128i* const Keys[AES_CBC_LANES], uint_fast32_t Nr,
+				 uint8_t* const Chain[AES_CBC_LANES], const uint8_t* In[AES_CBC_LANES],
+				 uint8_t* Out[AES_CBC_LANES], const size_t Stride[AES_CBC_LANES], size_t Steps) {
+	__m128i b0, b1, b2, b3, b4, b5, b6, b7;
+	uint_fast32_t r;
+	AES_CBC_X8_EACH(AES_CBC_X8_CHAIN)
+	for (; Steps; Steps--) {
+		AES_CBC_X8_EACH(AES_CBC_X8_FIRST)
+		for (r = 1; r < Nr; r++) {
+			AES_CBC_X8_EACH(AES_CBC_X8_ROUND)
+		}
+		AES_CBC_X8_EACH(AES_CBC_X8_LAST)
+	}
+	AES_CBC_X8_EACH(AES_CBC_X8_SAVE)
+}
+
+#undef AES_CBC_X8_EACH
+#undef AES_CBC_X8_CHAIN
+#undef AES_CBC_X8_FIRST
+#undef AES_CBC_X8_ROUND
+#undef AES_CBC_X8_LAST
+#undef AES_CBC_X8_SAVE
+
+/*
+ *  AesCbcEncryptMultiAesNi
+ *
+ *  Lane scheduler for AesCbcEncryptMulti. Streams are taken per round count (the lanes of one kernel call share Nr);
+ * a lane that runs out of blocks is refilled with the next stream and idle lanes become placeholders. When a single
+ * stream is left it is finished by the one-stream path. Streams it does not handle (no AES-NI key layout) are left
+ * with Done[i] == 0.
+ */
+static inline void AesCbcEncryptMultiAesNi(AesCbcContext* const* Contexts, const void* const* InBuffers,
+					   void* const* OutBuffers, const uint32_t* Sizes, size_t Count, uint8_t* Done) {
+	static const uint8_t zeroBlock[AESCBC_BLOCK_SIZE] = { 0 };
+	uint8_t scratch[AESCBC_BLOCK_SIZE], scratchChain[AESCBC_BLOCK_SIZE];
+	const __m128i* keys[AES_CBC_LANES];
+	uint8_t* chain[AES_CBC_LANES];
+	const uint8_t* in[AES_CBC_LANES];
+	uint8_t* out[AES_CBC_LANES];
+	size_t stride[AES_CBC_LANES], left[AES_CBC_LANES], lane[AES_CBC_LANES], next, steps;
+	uint32_t active, j, first;
+	unsigned long nr;
+
+	for (nr = 10; nr <= 14; nr += 2) {
+		next = 0;
+		for (j = 0; j < AES_CBC_LANES; j++) left[j] = 0;
+		for (;;) {
+			for (j = 0; j < AES_CBC_LANES; j++) {
+				if (left[j]) continue;
+				for (; next < Count; next++) {
+					AesCbcContext* ctx = Contexts[next];
+					if (Done[next] || ctx->Aes.Nr != nr || !(ctx->Aes.Flags & AES_CONTEXT_AESNI)) continue;
+					Done[next] = 1;
+					if (Sizes[next] == 0) continue;
+					lane[j] = next;
+					left[j] = Sizes[next] / AESCBC_BLOCK_SIZE;
+					keys[j] = (const __m128i*)ctx->Aes.eK;
+					chain[j] = ctx->PreviousCipherBlock;
+					in[j] = (const uint8_t*)InBuffers[next];
+					out[j] = (uint8_t*)OutBuffers[next];
+					stride[j] = AESCBC_BLOCK_SIZE;
+					next++;
+					break;
+				}
+			}
+			for (j = 0, active = 0, first = 0, steps = 0; j < AES_CBC_LANES; j++) {
+				if (!left[j]) continue;
+				if (active++ == 0 || left[j] < steps) steps = left[j];
+				if (active == 1) first = j;
+			}
+			if (active == 0) break;
+			if (active == 1 && next >= Count) {
+				AesCbcEncrypt(Contexts[lane[first]], in[first], out[first], (uint32_t)(left[first] * AESCBC_BLOCK_SIZE));
+				break;
+			}
+			for (j = 0; j < AES_CBC_LANES; j++) {
+				if (left[j]) continue;
+				keys[j] = keys[first];
+				chain[j] = scratchChain;
+				in[j] = zeroBlock;
+				out[j] = scratch;
+				stride[j] = 0;
+			}
+			AesCbcEncryptX8AesNi(keys, nr, chain, in, out, stride, steps);
+			for (j = 0; j < AES_CBC_LANES; j++) if (left[j]) left[j] -= steps;
+		}
+	}
+}
+#endif
+
+/*
+ *  AesCbcEncryptMulti
+ *
+ *  Encrypts Count independent CBC streams in one call: InBuffers[i] (Sizes[i] bytes) is encrypted into OutBuffers[i]
+ * with Contexts[i], exactly as AesCbcEncrypt would. With AES-NI up to AES_CBC_LANES chains advance in lockstep so
+ * their rounds interleave. The contexts must be distinct. Returns 0 if successful, or -1 (before encrypting anything)
+ * if a size is not a multiple of 16 bytes.
+ */
+LIBHASH_INLINE_API int AesCbcEncryptMulti(AesCbcContext* const* Contexts, const void* const* InBuffers,
+					  void* const* OutBuffers, const uint32_t* Sizes, size_t Count) {
+	uint8_t done[64];
+	size_t i, base, n;
+	for (i = 0; i < Count; i++) if (Sizes[i] % AESCBC_BLOCK_SIZE != 0) return -1;
+	for (base = 0; base < Count; base += n) {
+		n = (Count - base < sizeof(done)) ? Count - base : sizeof(done);
+		memset(done, 0, n);
+#if HASH_USE_CPU_DISPATCH
+		if (libhash_cpu_features() & HASH_CPU_AESNI)
+			AesCbcEncryptMultiAesNi(Contexts + base, InBuffers + base, OutBuffers + base, Sizes + base, n, done);
+#endif
+		for (i = 0; i < n; i++)
+			if (!done[i]) AesCbcEncrypt(Contexts[base + i], InBuffers[base + i], OutBuffers[base + i], Sizes[base + i]);
 	}
 	return 0;
 }
 
+#define AES_CBC_PIPELINE 8
+
+#if HASH_USE_CPU_DISPATCH
+#define AES_CBC_NI_EACH(OP, x)	b0 = OP(b0, x); b1 = OP(b1, x); b2 = OP(b2, x); b3 = OP(b3, x); \
+				b4 = OP(b4, x); b5 = OP(b5, x); b6 = OP(b6, x); b7 = OP(b7, x)
+#define AES_CBC_NI_LOAD(j)	_mm_loadu_si128((const __m128i*)(In + AESCBC_BLOCK_SIZE * (j)))
+#define AES_CBC_NI_STORE(b, j)	_mm_storeu_si128((__m128i*)(Out + AESCBC_BLOCK_SIZE * (j)), b)
+
+/*
+ *  AesCbcDecryptBlocksAesNi
+ *
+ *  AES-NI CBC decryption of Blocks whole blocks. AES_CBC_PIPELINE ciphertext blocks are loaded, decrypted interleaved
+ * and XORed with their predecessors before anything is stored, so In and Out may be the same buffer. Previous holds
+ * the last ciphertext block before In and is updated to the last block of In.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesCbcDecryptBlocksAesNi(const AesContext* Aes, uint8_t Previous[AESCBC_BLOCK_SIZE], const uint8_t* In,
+				     uint8_t* Out, size_t Blocks) {
+	const __m128i* rk = (const __m128i*)Aes->dK;
+	__m128i k[15], prev, b0, b1, b2, b3, b4, b5, b6, b7;
+	uint_fast32_t nr = Aes->Nr, r;
+	for (r = 0; r <= nr; r++) k[r] = _mm_loadu_si128(rk + r);
+	prev = _mm_loadu_si128((const __m128i*)Previous);
+	for (; Blocks >= AES_CBC_PIPELINE; Blocks -= AES_CBC_PIPELINE) {
+		b0 = AES_CBC_NI_LOAD(0); b1 = AES_CBC_NI_LOAD(1); b2 = AES_CBC_NI_LOAD(2); b3 = AES_CBC_NI_LOAD(3);
+		b4 = AES_CBC_NI_LOAD(4); b5 = AES_CBC_NI_LOAD(5); b6 = AES_CBC_NI_LOAD(6); b7 = AES_CBC_NI_LOAD(7);
+		AES_CBC_NI_EACH(_mm_xor_si128, k[0]);
+		for (r = 1; r < nr; r++) {
+			AES_CBC_NI_EACH(_mm_aesdec_si128, k[r]);
+		}
+		AES_CBC_NI_EACH(_mm_aesdeclast_si128, k[nr]);
+		b0 = _mm_xor_si128(b0, prev);
+		b1 = _mm_xor_si128(b1, AES_CBC_NI_LOAD(0)); b2 = _mm_xor_si128(b2, AES_CBC_NI_LOAD(1));
+		b3 = _mm_xor_si128(b3, AES_CBC_NI_LOAD(2)); b4 = _mm_xor_si128(b4, AES_CBC_NI_LOAD(3));
+		b5 = _mm_xor_si128(b5, AES_CBC_NI_LOAD(4)); b6 = _mm_xor_si128(b6, AES_CBC_NI_LOAD(5));
+		b7 = _mm_xor_si128(b7, AES_CBC_NI_LOAD(6));
+		prev = AES_CBC_NI_LOAD(7);
+		AES_CBC_NI_STORE(b0, 0); AES_CBC_NI_STORE(b1, 1); AES_CBC_NI_STORE(b2, 2); AES_CBC_NI_STORE(b3, 3);
+		AES_CBC_NI_STORE(b4, 4); AES_CBC_NI_STORE(b5, 5); AES_CBC_NI_STORE(b6, 6); AES_CBC_NI_STORE(b7, 7);
+		In += AES_CBC_PIPELINE * AESCBC_BLOCK_SIZE;
+		Out += AES_CBC_PIPELINE * AESCBC_BLOCK_SIZE;
+	}
+	for (; Blocks; Blocks--) {
+		b1 = AES_CBC_NI_LOAD(0);
+		b0 = _mm_xor_si128(b1, k[0]);
+		for (r = 1; r < nr; r++) b0 = _mm_aesdec_si128(b0, k[r]);
+		b0 = _mm_xor_si128(_mm_aesdeclast_si128(b0, k[nr]), prev);
+		prev = b1;
+		AES_CBC_NI_STORE(b0, 0);
+		In += AESCBC_BLOCK_SIZE;
+		Out += AESCBC_BLOCK_SIZE;
+	}
+	_mm_storeu_si128((__m128i*)Previous, prev);
+}
+
+#undef AES_CBC_NI_EACH
+#undef AES_CBC_NI_LOAD
+#undef AES_CBC_NI_STORE
+#endif
+
+/*
+ *  AesCbcDecryptBlocks
+ *
+ *  CBC decryption of Blocks whole blocks, AES_CBC_PIPELINE at a time. The portable path copies each group of
+ * ciphertext aside first (which keeps in-place buffers correct), decrypts it with AesDecryptBlocks and XORs the
+ * chained blocks word-wide. Aes must have its decryption keys.
+ */
+static inline void AesCbcDecryptBlocks(const AesContext* Aes, uint8_t Previous[AESCBC_BLOCK_SIZE], const uint8_t* In,
+				       uint8_t* Out, size_t Blocks) {
+	uint8_t cipher[AESCBC_BLOCK_SIZE + AES_CBC_PIPELINE * AESCBC_BLOCK_SIZE];
+	uint32_t n;
+#if HASH_USE_CPU_DISPATCH
+	if (Aes->Flags & AES_CONTEXT_AESNI) {
+		AesCbcDecryptBlocksAesNi(Aes, Previous, In, Out, Blocks);
+		return;
+	}
+#endif
+	memcpy(cipher, Previous, AESCBC_BLOCK_SIZE);
+	while (Blocks) {
+		n = (Blocks < AES_CBC_PIPELINE) ? (uint32_t)Blocks : AES_CBC_PIPELINE;
+		memcpy(cipher + AESCBC_BLOCK_SIZE, In, n * AESCBC_BLOCK_SIZE);
+		AesDecryptBlocks(Aes, cipher + AESCBC_BLOCK_SIZE, Out, n);
+		XorBuffers(Out, cipher, Out, n * AESCBC_BLOCK_SIZE);
+		memcpy(cipher, cipher + AESCBC_BLOCK_SIZE * n, AESCBC_BLOCK_SIZE);
+		In += n * AESCBC_BLOCK_SIZE;
+		Out += n * AESCBC_BLOCK_SIZE;
+		Blocks -= n;
+	}
+	memcpy(Previous, cipher, AESCBC_BLOCK_SIZE);
+}
+
 /*
  *  AesCbcDecrypt
  *
  *  Decrypts a buffer of data using an AES CBC context. The data buffer must be
  * a multiple of 16 bytes (128 bits) in size. The "position" of the context will
  * be advanced by the buffer amount. InBuffer and OutBuffer can point to the
- * same location for in-place decrypting. Returns 0 if successful, or -1 if Size
- * is not a multiple of 16 bytes.
+ * same location for in-place decrypting. A context made from an encrypt-only
+ * AesContext gets its decryption keys derived on the first call. Returns 0 if
+ * successful, or -1 if Size is not a multiple of 16 bytes.
  */
 LIBHASH_INLINE_API int AesCbcDecrypt(AesCbcContext *Context, const void *InBuffer, void *OutBuffer, uint32_t Size) {
-	uint32_t numBlocks = Size/AESCBC_BLOCK_SIZE, offset = 0, i;
-	uint8_t previousCipherBlock[AESCBC_BLOCK_SIZE];
 	if (0 != Size % AESCBC_BLOCK_SIZE) return -1;
-	for (i = 0; i<numBlocks; i++) {
-		memcpy(previousCipherBlock, Context->PreviousCipherBlock, AESCBC_BLOCK_SIZE);
-		memcpy(Context->PreviousCipherBlock, (uint8_t*)(InBuffer)+offset, AESCBC_BLOCK_SIZE);
-		AesDecrypt(&Context->Aes, Context->PreviousCipherBlock, uhash_cast(uint8_t*, OutBuffer)+offset);
-		XorAesBlock(uhash_cast(uint8_t*, OutBuffer)+offset, previousCipherBlock);
-		offset += AESCBC_BLOCK_SIZE;
-	}
+	AesExpandDecryptKey(&Context->Aes);
+	AesCbcDecryptBlocks(&Context->Aes, Context->PreviousCipherBlock, hash_c_cast(const uint8_t*, InBuffer),
+			    uhash_cast(uint8_t*, OutBuffer), Size / AESCBC_BLOCK_SIZE);
+	return 0;
+}
+
+/*
+ *  AesCbcEncryptLarge
+ *
+ *  AesCbcEncrypt for a size_t length, encrypted in one call of the block loop.
+ */
+LIBHASH_INLINE_API int AesCbcEncryptLarge(AesCbcContext *Context, const void *InBuffer, void *OutBuffer, size_t Size) {
+	if (Size % AESCBC_BLOCK_SIZE != 0) return -1;
+	AesCbcEncryptBlocks(&Context->Aes, Context->PreviousCipherBlock, hash_c_cast(const uint8_t*, InBuffer),
+			    uhash_cast(uint8_t*, OutBuffer), Size / AESCBC_BLOCK_SIZE);
+	return 0;
+}
+
+/*
+ *  AesCbcDecryptLarge
+ *
+ *  AesCbcDecrypt for a size_t length, decrypted in one call of the batched block
+ * loop.
+ */
+LIBHASH_INLINE_API int AesCbcDecryptLarge(AesCbcContext *Context, const void *InBuffer, void *OutBuffer, size_t Size) {
+	if (Size % AESCBC_BLOCK_SIZE != 0) return -1;
+	AesExpandDecryptKey(&Context->Aes);
+	AesCbcDecryptBlocks(&Context->Aes, Context->PreviousCipherBlock, hash_c_cast(const uint8_t*, InBuffer),
+			    uhash_cast(uint8_t*, OutBuffer), Size / AESCBC_BLOCK_SIZE);
+	return 0;
+}
+
+/*
+ *  AesCbcInitialiseShared
+ *
+ *  Initialises an AesCbcSharedContext over an already initialised AesContext
+ * and an IV. The key schedule is referenced, not copied, so changing the IV only
+ * writes 16 bytes. Decrypting needs a context set up with AesInitialise (or
+ * AesExpandDecryptKey).
+ */
+LIBHASH_INLINE_API void AesCbcInitialiseShared(AesCbcSharedContext *Context,const AesContext *InitialisedAesContext,
+					  const uint8_t IV[AESCBC_BLOCK_SIZE]) {
+	Context->Aes = InitialisedAesContext;
+	memcpy(Context->PreviousCipherBlock, IV, sizeof(Context->PreviousCipherBlock));
+}
+
+/*
+ *  AesCbcSharedEncrypt
+ *
+ *  AesCbcEncrypt for an AesCbcSharedContext.
+ */
+LIBHASH_INLINE_API int AesCbcSharedEncrypt(AesCbcSharedContext *Context, const void *InBuffer, void *OutBuffer, uint32_t Size) {
+	if (Size % AESCBC_BLOCK_SIZE != 0) return -1;
+	AesCbcEncryptBlocks(Context->Aes, Context->PreviousCipherBlock, hash_c_cast(const uint8_t*, InBuffer),
+			    uhash_cast(uint8_t*, OutBuffer), Size / AESCBC_BLOCK_SIZE);
+	return 0;
+}
+
+/*
+ *  AesCbcSharedDecrypt
+ *
+ *  AesCbcDecrypt for an AesCbcSharedContext. The shared key schedule is never
+ * modified, so it must already have its decryption keys: returns -1 for an
+ * encrypt-only AesContext as well as for a partial block.
+ */
+LIBHASH_INLINE_API int AesCbcSharedDecrypt(AesCbcSharedContext *Context, const void *InBuffer, void *OutBuffer, uint32_t Size) {
+	if (Size % AESCBC_BLOCK_SIZE != 0 || (Context->Aes->Flags & AES_CONTEXT_NO_DECRYPT)) return -1;
+	AesCbcDecryptBlocks(Context->Aes, Context->PreviousCipherBlock, hash_c_cast(const uint8_t*, InBuffer),
+			    uhash_cast(uint8_t*, OutBuffer), Size / AESCBC_BLOCK_SIZE);
 	return 0;
 }
 
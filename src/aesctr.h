@@ -21,10 +21,18 @@
 #define __AESCTR_H__
 
 #include <aes.h>
+#include "threadpool.h"
 
 #define AESCTR_BLOCK_SIZE AES_BLOCK_SIZE
 #define AES_CTR_IV_SIZE 8
 
+// Buffers of at least this many bytes are split across the worker threads (see AesCtrSetParallelThreshold)
+#ifndef AES_CTR_PARALLEL_THRESHOLD
+#define AES_CTR_PARALLEL_THRESHOLD	(4U << 20)
+#endif
+// Smallest contiguous segment handed to one thread
+#define AES_CTR_PARALLEL_SEGMENT_MIN	(256U << 10)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -37,27 +45,174 @@ typedef struct {
 	uint8_t CurrentCipherBlock[AESCTR_BLOCK_SIZE];
 } AesCtrContext;
 
+/*
+ * AesCtrSharedContext
+ *
+ * CTR stream state over an externally owned key schedule. The AesContext is only read, so one initialised schedule
+ * can back any number of streams on any number of threads; it must outlive them.
+ */
+typedef struct {
+	const AesContext* Aes;
+	uint8_t IV[AES_CTR_IV_SIZE];
+	uint64_t StreamIndex;
+	uint64_t CurrentCipherBlockIndex;
+	uint8_t CurrentCipherBlock[AESCTR_BLOCK_SIZE];
+} AesCtrSharedContext;
+
+#define AES_CTR_PIPELINE 8
+
+/*
+ *  AesCtrCounterBlock
+ *
+ * Builds the pre-cipher block for BlockIndex: the IV as first 64 bits and the block index as the remaining 64 bits in
+ * Network byte order (Big Endian)
+ */
+static inline void AesCtrCounterBlock(const uint8_t IV[AES_CTR_IV_SIZE], uint64_t BlockIndex,
+				      uint8_t Block[AESCTR_BLOCK_SIZE]) {
+	int i;
+	memcpy(Block, IV, AES_CTR_IV_SIZE);
+	for (i = 0; i < 8; i++) Block[AES_CTR_IV_SIZE + i] = hash_cast(uint8_t, (BlockIndex >> (56 - 8 * i)) & 255);
+}
+
 /*
  *  CreateCurrentCipherBlock
  *
  * Takes the IV and the counter in the AesCtrContext and produces the cipher
- * block (CurrentCipherBlock). The cipher block is produced by first creating a
- * 128 bit block with the IV as first 64 bits and the CurrentCipherBlockIndex
- * stored as the remaining 64bits in Network byte order (Big Endian)
+ * block (CurrentCipherBlock) for CurrentCipherBlockIndex.
  */
 static inline void CreateCurrentCipherBlock(AesCtrContext *Context) {
-	memcpy(Context->CurrentCipherBlock,Context->IV,AES_CTR_IV_SIZE);
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[0] = hash_cast(uint8_t,(((Context->CurrentCipherBlockIndex) >> 56) & 255));
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[1] = hash_cast(uint8_t,(((Context->CurrentCipherBlockIndex) >> 48) & 255));
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[2] = hash_cast(uint8_t,(((Context->CurrentCipherBlockIndex) >> 40) & 255));
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[3] = hash_cast(uint8_t,(((Context->CurrentCipherBlockIndex) >> 32) & 255));
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[4] = hash_cast(uint8_t,(((Context->CurrentCipherBlockIndex) >> 24) & 255));
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[5] = hash_cast(uint8_t,(((Context->CurrentCipherBlockIndex) >> 16) & 255));
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[6] = hash_cast(uint8_t,(((Context->CurrentCipherBlockIndex) >> 8) & 255));
-	(Context->CurrentCipherBlock + AES_CTR_IV_SIZE)[7] = hash_cast(uint8_t,((Context->CurrentCipherBlockIndex) & 255));
+	AesCtrCounterBlock(Context->IV, Context->CurrentCipherBlockIndex, Context->CurrentCipherBlock);
 	AesEncryptInPlace(&Context->Aes,Context->CurrentCipherBlock);
 }
 
+static inline void AesCtrSharedCurrentBlock(AesCtrSharedContext *Context) {
+	AesCtrCounterBlock(Context->IV, Context->CurrentCipherBlockIndex, Context->CurrentCipherBlock);
+	AesEncryptInPlace(Context->Aes, Context->CurrentCipherBlock);
+}
+
+#if HASH_USE_CPU_DISPATCH
+static inline uint64_t AesCtrSwap64(uint64_t x) {
+	x = ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+	x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+	return (x << 32) | (x >> 32);
+}
+
+#define AES_CTR_NI_COUNTER(j)	_mm_xor_si128(_mm_set_epi64x((long long)AesCtrSwap64(BlockIndex + (j)), (long long)iv), k[0])
+#define AES_CTR_NI_EACH(OP, x)	b0 = OP(b0, x); b1 = OP(b1, x); b2 = OP(b2, x); b3 = OP(b3, x); \
+				b4 = OP(b4, x); b5 = OP(b5, x); b6 = OP(b6, x); b7 = OP(b7, x)
+#define AES_CTR_NI_STORE(b, j)	if (In) b = _mm_xor_si128(b, _mm_loadu_si128((const __m128i*)(In + AESCTR_BLOCK_SIZE * (j)))); \
+				_mm_storeu_si128((__m128i*)(Out + AESCTR_BLOCK_SIZE * (j)), b)
+
+/*
+ *  AesCtrXorBlocksAesNi
+ *
+ * AES-NI keystream for Blocks whole blocks starting at BlockIndex. Counter blocks are built in registers and
+ * AES_CTR_PIPELINE of them go through the rounds together, so the AESENC latency is hidden behind independent blocks.
+ * The keystream is XORed onto In, or stored as is when In is NULL.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesCtrXorBlocksAesNi(const AesContext* Aes, const uint8_t IV[AES_CTR_IV_SIZE], uint64_t BlockIndex,
+				 const uint8_t* In, uint8_t* Out, size_t Blocks) {
+	const __m128i* rk = (const __m128i*)Aes->eK;
+	__m128i k[15], b0, b1, b2, b3, b4, b5, b6, b7;
+	uint_fast32_t nr = Aes->Nr, r;
+	uint64_t iv;
+	memcpy(&iv, IV, AES_CTR_IV_SIZE);
+	for (r = 0; r <= nr; r++) k[r] = _mm_loadu_si128(rk + r);
+	for (; Blocks >= AES_CTR_PIPELINE; Blocks -= AES_CTR_PIPELINE, BlockIndex += AES_CTR_PIPELINE) {
+		b0 = AES_CTR_NI_COUNTER(0); b1 = AES_CTR_NI_COUNTER(1); b2 = AES_CTR_NI_COUNTER(2); b3 = AES_CTR_NI_COUNTER(3);
+		b4 = AES_CTR_NI_COUNTER(4); b5 = AES_CTR_NI_COUNTER(5); b6 = AES_CTR_NI_COUNTER(6); b7 = AES_CTR_NI_COUNTER(7);
+		for (r = 1; r < nr; r++) {
+			AES_CTR_NI_EACH(_mm_aesenc_si128, k[r]);
+		}
+		AES_CTR_NI_EACH(_mm_aesenclast_si128, k[nr]);
+		AES_CTR_NI_STORE(b0, 0); AES_CTR_NI_STORE(b1, 1); AES_CTR_NI_STORE(b2, 2); AES_CTR_NI_STORE(b3, 3);
+		AES_CTR_NI_STORE(b4, 4); AES_CTR_NI_STORE(b5, 5); AES_CTR_NI_STORE(b6, 6); AES_CTR_NI_STORE(b7, 7);
+		if (In) In += AES_CTR_PIPELINE * AESCTR_BLOCK_SIZE;
+		Out += AES_CTR_PIPELINE * AESCTR_BLOCK_SIZE;
+	}
+	for (; Blocks; Blocks--, BlockIndex++) {
+		b0 = AES_CTR_NI_COUNTER(0);
+		for (r = 1; r < nr; r++) b0 = _mm_aesenc_si128(b0, k[r]);
+		b0 = _mm_aesenclast_si128(b0, k[nr]);
+		AES_CTR_NI_STORE(b0, 0);
+		if (In) In += AESCTR_BLOCK_SIZE;
+		Out += AESCTR_BLOCK_SIZE;
+	}
+}
+
+#undef AES_CTR_NI_COUNTER
+#undef AES_CTR_NI_EACH
+#undef AES_CTR_NI_STORE
+#endif
+
+/*
+ *  AesCtrXorBlocks
+ *
+ * XORs the keystream of Blocks whole blocks starting at BlockIndex onto In (or writes the keystream itself when In is
+ * NULL). The portable path builds AES_CTR_PIPELINE counter blocks in a local buffer, encrypts them with
+ * AesEncryptBlocks and XORs the result word-wide.
+ */
+static inline void AesCtrXorBlocks(const AesContext* Aes, const uint8_t IV[AES_CTR_IV_SIZE], uint64_t BlockIndex,
+				   const uint8_t* In, uint8_t* Out, size_t Blocks) {
+	uint8_t keystream[AES_CTR_PIPELINE * AESCTR_BLOCK_SIZE];
+	uint32_t n, j;
+#if HASH_USE_CPU_DISPATCH
+	if (Aes->Flags & AES_CONTEXT_AESNI) {
+		AesCtrXorBlocksAesNi(Aes, IV, BlockIndex, In, Out, Blocks);
+		return;
+	}
+#endif
+	while (Blocks) {
+		n = (Blocks < AES_CTR_PIPELINE) ? (uint32_t)Blocks : AES_CTR_PIPELINE;
+		for (j = 0; j < n; j++) AesCtrCounterBlock(IV, BlockIndex + j, keystream + AESCTR_BLOCK_SIZE * j);
+		AesEncryptBlocks(Aes, keystream, keystream, n);
+		if (In) {
+			XorBuffers(In, keystream, Out, n * AESCTR_BLOCK_SIZE);
+			In += n * AESCTR_BLOCK_SIZE;
+		} else {
+			memcpy(Out, keystream, n * AESCTR_BLOCK_SIZE);
+		}
+		Out += n * AESCTR_BLOCK_SIZE;
+		BlockIndex += n;
+		Blocks -= n;
+	}
+}
+
+/*
+ *  AesCtrProcess
+ *
+ * Common body of AesCtrXor and AesCtrOutput (In == NULL). CurrentCipherBlock always holds the keystream block that
+ * contains StreamIndex: bytes left in it are used first, whole blocks are then generated in bulk and the block the
+ * call ends in becomes the new CurrentCipherBlock.
+ */
+static inline void AesCtrProcess(AesCtrSharedContext *Context, const uint8_t *In, uint8_t *Out, size_t Size) {
+	uint32_t offset = (uint32_t)(Context->StreamIndex % AESCTR_BLOCK_SIZE);
+	uint32_t chunk = AESCTR_BLOCK_SIZE - offset;
+	size_t blocks;
+	if (Size == 0) return;
+	if (chunk > Size) chunk = (uint32_t)Size;
+	if (In) XorBuffers(In, Context->CurrentCipherBlock + offset, Out, chunk);
+	else memcpy(Out, Context->CurrentCipherBlock + offset, chunk);
+	Context->StreamIndex += chunk;
+	if (Context->StreamIndex % AESCTR_BLOCK_SIZE) return;
+	if (In) In += chunk;
+	Out += chunk;
+	Size -= chunk;
+	blocks = Size / AESCTR_BLOCK_SIZE;
+	AesCtrXorBlocks(Context->Aes, Context->IV, Context->CurrentCipherBlockIndex + 1, In, Out, blocks);
+	Context->CurrentCipherBlockIndex += 1 + blocks;
+	Context->StreamIndex += (uint64_t)blocks * AESCTR_BLOCK_SIZE;
+	AesCtrSharedCurrentBlock(Context);
+	Size -= blocks * AESCTR_BLOCK_SIZE;
+	if (Size) {
+		blocks *= AESCTR_BLOCK_SIZE;
+		if (In) XorBuffers(In + blocks, Context->CurrentCipherBlock, Out + blocks, (uint32_t)Size);
+		else memcpy(Out + blocks, Context->CurrentCipherBlock, Size);
+		Context->StreamIndex += Size;
+	}
+}
+
 /*
  *  AesCtrInitialise
  *
@@ -85,7 +240,7 @@ LIBHASH_INLINE_API void AesCtrInitialise(AesCtrContext *Context,const AesContext
 LIBHASH_INLINE_API int AesCtrInitialiseWithKey(AesCtrContext *Context,const uint8_t *Key,uint32_t KeySize,
 					  const uint8_t IV[AES_CTR_IV_SIZE]) {
 	AesContext aes;
-	if (AesInitialise(&aes, Key, KeySize) != 0) return -1;
+	if (AesInitialiseEncryptOnly(&aes, Key, KeySize) != 0) return -1;
 	AesCtrInitialise(Context, &aes, IV);
 	return 0;
 }
@@ -106,6 +261,114 @@ LIBHASH_INLINE_API void AesCtrSetStreamIndex(AesCtrContext *Context, uint64_t St
 	}
 }
 
+/*
+ *  AesCtrInitialiseShared
+ *
+ * Initialises an AesCtrSharedContext over an already initialised AesContext and
+ * an IV. The key schedule is referenced, not copied, so only the IV and the
+ * first keystream block are written.
+ */
+LIBHASH_INLINE_API void AesCtrInitialiseShared(AesCtrSharedContext *Context,const AesContext *InitialisedAesContext,
+					  const uint8_t IV[AES_CTR_IV_SIZE]) {
+	Context->Aes = InitialisedAesContext;
+	memcpy(Context->IV, IV, AES_CTR_IV_SIZE);
+	Context->StreamIndex = 0;
+	Context->CurrentCipherBlockIndex = 0;
+	AesCtrSharedCurrentBlock(Context);
+}
+
+/*
+ *  AesCtrSharedSetStreamIndex
+ *
+ * AesCtrSetStreamIndex for an AesCtrSharedContext.
+ */
+LIBHASH_INLINE_API void AesCtrSharedSetStreamIndex(AesCtrSharedContext *Context, uint64_t StreamIndex) {
+	uint64_t blockIndex = StreamIndex / AESCTR_BLOCK_SIZE;
+	Context->StreamIndex = StreamIndex;
+	if (blockIndex != Context->CurrentCipherBlockIndex) {
+		Context->CurrentCipherBlockIndex = blockIndex;
+		AesCtrSharedCurrentBlock(Context);
+	}
+}
+
+static size_t AesCtrParallelThreshold = AES_CTR_PARALLEL_THRESHOLD;
+
+/*
+ *  AesCtrSetParallelThreshold
+ *
+ * Sets the buffer size from which AesCtrXor and AesCtrOutput split the work into contiguous segments running on the
+ * worker thread pool. 0 keeps every call on the calling thread. The default is AES_CTR_PARALLEL_THRESHOLD. May be
+ * called while other threads encrypt; a call already running keeps the value it started with.
+ */
+LIBHASH_INLINE_API void AesCtrSetParallelThreshold(size_t Bytes) {
+	LIBHASH_ATOMIC_STORE(&AesCtrParallelThreshold, Bytes);
+}
+
+typedef struct {
+	const AesCtrSharedContext* Context;
+	const uint8_t* In;
+	uint8_t* Out;
+	size_t Size;
+	size_t Segment;
+} AesCtrJob;
+
+/*
+ *  AesCtrSegment
+ *
+ * Pool task: runs segment Index of the job on a private copy of the stream state seeked to the segment start.
+ */
+static void AesCtrSegment(void* Arg, uint32_t Index) {
+	const AesCtrJob* job = (const AesCtrJob*)Arg;
+	size_t offset = (size_t)Index * job->Segment;
+	size_t size = (job->Size - offset < job->Segment) ? job->Size - offset : job->Segment;
+	AesCtrSharedContext worker = *job->Context;
+	AesCtrSharedSetStreamIndex(&worker, job->Context->StreamIndex + offset);
+	AesCtrProcess(&worker, job->In ? job->In + offset : NULL, job->Out + offset, size);
+}
+
+/*
+ *  AesCtrRun
+ *
+ * AesCtrProcess, split across the thread pool when Size reaches the parallel threshold. Every segment is a multiple
+ * of the block size and the context ends up exactly as the serial path would leave it.
+ */
+static inline void AesCtrRun(AesCtrSharedContext *Context, const uint8_t *In, uint8_t *Out, size_t Size) {
+	size_t threshold = LIBHASH_ATOMIC_LOAD(&AesCtrParallelThreshold), segments;
+	uint32_t threads;
+	AesCtrJob job;
+	if (threshold && Size >= threshold && Size >= 2 * AES_CTR_PARALLEL_SEGMENT_MIN && (threads = libhash_pool_threads()) > 1) {
+		segments = Size / AES_CTR_PARALLEL_SEGMENT_MIN;
+		if (segments > threads) segments = threads;
+		job.Context = Context;
+		job.In = In;
+		job.Out = Out;
+		job.Size = Size;
+		job.Segment = ((Size + segments - 1) / segments + AESCTR_BLOCK_SIZE - 1) & ~(size_t)(AESCTR_BLOCK_SIZE - 1);
+		libhash_pool_run(AesCtrSegment, &job, (uint32_t)((Size + job.Segment - 1) / job.Segment));
+		AesCtrSharedSetStreamIndex(Context, Context->StreamIndex + Size);
+		return;
+	}
+	AesCtrProcess(Context, In, Out, Size);
+}
+
+/*
+ *  AesCtrRunOwned
+ *
+ * AesCtrRun for an AesCtrContext: the stream state is moved into a shared view of the embedded key schedule and back.
+ */
+static inline void AesCtrRunOwned(AesCtrContext *Context, const uint8_t *In, uint8_t *Out, size_t Size) {
+	AesCtrSharedContext view;
+	view.Aes = &Context->Aes;
+	memcpy(view.IV, Context->IV, AES_CTR_IV_SIZE);
+	view.StreamIndex = Context->StreamIndex;
+	view.CurrentCipherBlockIndex = Context->CurrentCipherBlockIndex;
+	memcpy(view.CurrentCipherBlock, Context->CurrentCipherBlock, AESCTR_BLOCK_SIZE);
+	AesCtrRun(&view, In, Out, Size);
+	Context->StreamIndex = view.StreamIndex;
+	Context->CurrentCipherBlockIndex = view.CurrentCipherBlockIndex;
+	memcpy(Context->CurrentCipherBlock, view.CurrentCipherBlock, AESCTR_BLOCK_SIZE);
+}
+
 /*
  *  AesCtrXor
  *
@@ -117,44 +380,7 @@ LIBHASH_INLINE_API void AesCtrSetStreamIndex(AesCtrContext *Context, uint64_t St
  * encrypting/decrypting
  */
 LIBHASH_INLINE_API void AesCtrXor(AesCtrContext *Context,const void *InBuffer,void *OutBuffer,uint32_t Size) {
-	uint32_t firstChunkSize, amountAvailableInBlock, loopStartingOutputOffset;
-	uint64_t loopStartingCipherBlockIndex, cipherBlockIndex = 0;
-	uint8_t preCipherBlock[AES_KEY_SIZE_128], encCipherBlock[AES_KEY_SIZE_128];
-	int numIterations, i;
-	amountAvailableInBlock = AESCTR_BLOCK_SIZE - (Context->StreamIndex % AESCTR_BLOCK_SIZE);
-	firstChunkSize = ((amountAvailableInBlock<Size)?amountAvailableInBlock:Size);
-	XorBuffers(hash_c_cast(uint8_t*,InBuffer), Context->CurrentCipherBlock +
-				(AESCTR_BLOCK_SIZE - amountAvailableInBlock), uhash_cast(uint8_t*,OutBuffer), firstChunkSize);
-	numIterations = ((Size - firstChunkSize) + AESCTR_BLOCK_SIZE) / AESCTR_BLOCK_SIZE;
-	loopStartingCipherBlockIndex = Context->CurrentCipherBlockIndex + 1;
-	loopStartingOutputOffset = firstChunkSize;
-	memcpy(preCipherBlock, Context->IV, AES_CTR_IV_SIZE);
-#ifdef _OPENMP
-#pragma omp parallel for firstprivate(preCipherBlock, cipherBlockIndex) \
-	lastprivate(encCipherBlock, cipherBlockIndex)
-#endif
-	for (i = 0; i < numIterations; i++) {
-		uint32_t outputOffset = loopStartingOutputOffset + (AESCTR_BLOCK_SIZE * i);
-		uint32_t amountLeft = Size-outputOffset;
-		uint32_t chunkSize = ((amountLeft < AESCTR_BLOCK_SIZE) ? amountLeft : AESCTR_BLOCK_SIZE);
-		cipherBlockIndex = loopStartingCipherBlockIndex + i;
-		(preCipherBlock + AES_CTR_IV_SIZE)[0] = hash_cast(uint8_t,((cipherBlockIndex >> 56) & 255));
-		(preCipherBlock + AES_CTR_IV_SIZE)[1] = hash_cast(uint8_t,((cipherBlockIndex >> 48) & 255));
-		(preCipherBlock + AES_CTR_IV_SIZE)[2] = hash_cast(uint8_t,((cipherBlockIndex >> 40) & 255));
-		(preCipherBlock + AES_CTR_IV_SIZE)[3] = hash_cast(uint8_t,((cipherBlockIndex >> 32) & 255));
-		(preCipherBlock + AES_CTR_IV_SIZE)[4] = hash_cast(uint8_t,((cipherBlockIndex >> 24) & 255));
-		(preCipherBlock + AES_CTR_IV_SIZE)[5] = hash_cast(uint8_t,((cipherBlockIndex >> 16) & 255));
-		(preCipherBlock + AES_CTR_IV_SIZE)[6] = hash_cast(uint8_t,((cipherBlockIndex >> 8) & 255));
-		(preCipherBlock + AES_CTR_IV_SIZE)[7] = hash_cast(uint8_t,(cipherBlockIndex & 255));
-		AesEncrypt(&Context->Aes, preCipherBlock, encCipherBlock);
-		XorBuffers(hash_c_cast(uint8_t*,InBuffer) + outputOffset, encCipherBlock,
-				      uhash_cast(uint8_t*,OutBuffer)+outputOffset, chunkSize);
-	}
-	Context->StreamIndex += Size;
-	if (numIterations > 0) {
-		Context->CurrentCipherBlockIndex = cipherBlockIndex;
-		memcpy(Context->CurrentCipherBlock, encCipherBlock, AESCTR_BLOCK_SIZE);
-	}
+	AesCtrRunOwned(Context, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size);
 }
 
 /*
@@ -164,8 +390,44 @@ LIBHASH_INLINE_API void AesCtrXor(AesCtrContext *Context,const void *InBuffer,vo
  * position. This will advance the stream index by that number of bytes.
  */
 LIBHASH_INLINE_API void AesCtrOutput(AesCtrContext *Context,void *Buffer,uint32_t Size) {
-	memset(Buffer, 0, Size);
-	AesCtrXor(Context, Buffer, Buffer, Size);
+	AesCtrRunOwned(Context, NULL, uhash_cast(uint8_t*,Buffer), Size);
+}
+
+/*
+ *  AesCtrXorLarge
+ *
+ * AesCtrXor for a size_t length. The buffer is handed to the batched (and, above
+ * the parallel threshold, threaded) keystream generation in one piece.
+ */
+LIBHASH_INLINE_API void AesCtrXorLarge(AesCtrContext *Context,const void *InBuffer,void *OutBuffer,size_t Size) {
+	AesCtrRunOwned(Context, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size);
+}
+
+/*
+ *  AesCtrOutputLarge
+ *
+ * AesCtrOutput for a size_t length.
+ */
+LIBHASH_INLINE_API void AesCtrOutputLarge(AesCtrContext *Context,void *Buffer,size_t Size) {
+	AesCtrRunOwned(Context, NULL, uhash_cast(uint8_t*,Buffer), Size);
+}
+
+/*
+ *  AesCtrSharedXor
+ *
+ * AesCtrXor for an AesCtrSharedContext.
+ */
+LIBHASH_INLINE_API void AesCtrSharedXor(AesCtrSharedContext *Context,const void *InBuffer,void *OutBuffer,uint32_t Size) {
+	AesCtrRun(Context, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size);
+}
+
+/*
+ *  AesCtrSharedOutput
+ *
+ * AesCtrOutput for an AesCtrSharedContext.
+ */
+LIBHASH_INLINE_API void AesCtrSharedOutput(AesCtrSharedContext *Context,void *Buffer,uint32_t Size) {
+	AesCtrRun(Context, NULL, uhash_cast(uint8_t*,Buffer), Size);
 }
 
 /*
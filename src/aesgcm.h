@@ -0,0 +1,694 @@
+/**
+ * WjCryptLib_AesGcm
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __AESGCM_H__
+#define __AESGCM_H__
+
+#include <aes.h>
+#include <aesctr.h>
+
+#define AESGCM_BLOCK_SIZE AES_BLOCK_SIZE
+#define AES_GCM_IV_SIZE 12
+#define AES_GCM_TAG_SIZE 16
+
+// Most plaintext bytes one IV may protect (2^39 - 256 bits, NIST SP 800-38D)
+#define AES_GCM_MAX_DATA_SIZE	((((uint64_t)1) << 36) - 32)
+
+#define AES_GCM_PIPELINE 8
+// Blocks the portable path encrypts before hashing them, small enough to stay in L1
+#define AES_GCM_CHUNK_BLOCKS 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	AesContext Aes;
+	uint64_t HL[16];					// 4-bit multiplication table of H (portable GHASH)
+	uint64_t HH[16];
+	uint8_t HPowers[AES_GCM_PIPELINE][AESGCM_BLOCK_SIZE];	// H^1 .. H^8 byte reversed (PCLMULQDQ GHASH)
+	uint8_t J0[AESGCM_BLOCK_SIZE];				// pre-counter block of the current message
+	uint8_t Ghash[AESGCM_BLOCK_SIZE];			// running GHASH value
+	uint8_t Buffer[AESGCM_BLOCK_SIZE];			// partial AAD or ciphertext block not hashed yet
+	uint8_t CurrentCipherBlock[AESGCM_BLOCK_SIZE];		// keystream of the block DataSize is in
+	uint64_t AadSize;
+	uint64_t DataSize;
+	uint32_t Flags;
+} AesGcmContext;
+
+// HPowers is set up and GHASH runs on PCLMULQDQ
+#define AES_GCM_PCLMUL	0x1
+// The AAD is closed, the message data is being processed
+#define AES_GCM_DATA	0x2
+
+static inline uint32_t AesGcmLoad32(const uint8_t* p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void AesGcmStore32(uint8_t* p, uint32_t v) {
+	p[0] = hash_cast(uint8_t, v >> 24); p[1] = hash_cast(uint8_t, v >> 16);
+	p[2] = hash_cast(uint8_t, v >> 8); p[3] = hash_cast(uint8_t, v);
+}
+
+static inline void AesGcmStore64(uint8_t* p, uint64_t v) {
+	AesGcmStore32(p, (uint32_t)(v >> 32));
+	AesGcmStore32(p + 4, (uint32_t)v);
+}
+
+// -----------------------------------------------------------------------------
+// Portable GHASH: Shoup's 4-bit tables, 16 multiples of H and a remainder table
+// -----------------------------------------------------------------------------
+
+static const uint64_t AesGcmLast4[16] = {
+	0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+	0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/*
+ *  AesGcmTableInitialise
+ *
+ * Fills HL/HH with i*H for every 4-bit i, in the bit-reflected GCM field representation.
+ */
+static inline void AesGcmTableInitialise(AesGcmContext* Context, const uint8_t H[AESGCM_BLOCK_SIZE]) {
+	uint64_t vh = ((uint64_t)AesGcmLoad32(H) << 32) | AesGcmLoad32(H + 4);
+	uint64_t vl = ((uint64_t)AesGcmLoad32(H + 8) << 32) | AesGcmLoad32(H + 12);
+	uint32_t i, j, t;
+	Context->HL[0] = Context->HH[0] = 0;
+	Context->HL[8] = vl;
+	Context->HH[8] = vh;
+	for (i = 4; i > 0; i >>= 1) {
+		t = (uint32_t)(vl & 1) * 0xe1000000U;
+		vl = (vh << 63) | (vl >> 1);
+		vh = (vh >> 1) ^ ((uint64_t)t << 32);
+		Context->HL[i] = vl;
+		Context->HH[i] = vh;
+	}
+	for (i = 2; i <= 8; i *= 2) {
+		for (j = 1; j < i; j++) {
+			Context->HH[i + j] = Context->HH[i] ^ Context->HH[j];
+			Context->HL[i + j] = Context->HL[i] ^ Context->HL[j];
+		}
+	}
+}
+
+/*
+ *  AesGcmTableMultiply
+ *
+ * X = X * H, one nibble of X at a time from the last byte to the first.
+ */
+static inline void AesGcmTableMultiply(const AesGcmContext* Context, uint8_t X[AESGCM_BLOCK_SIZE]) {
+	uint32_t lo = X[15] & 0xf, hi, rem;
+	uint64_t zh = Context->HH[lo], zl = Context->HL[lo];
+	int i;
+	for (i = 15; i >= 0; i--) {
+		lo = X[i] & 0xf;
+		hi = X[i] >> 4;
+		if (i != 15) {
+			rem = (uint32_t)(zl & 0xf);
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4) ^ (AesGcmLast4[rem] << 48) ^ Context->HH[lo];
+			zl ^= Context->HL[lo];
+		}
+		rem = (uint32_t)(zl & 0xf);
+		zl = (zh << 60) | (zl >> 4);
+		zh = (zh >> 4) ^ (AesGcmLast4[rem] << 48) ^ Context->HH[hi];
+		zl ^= Context->HL[hi];
+	}
+	AesGcmStore64(X, zh);
+	AesGcmStore64(X + 8, zl);
+}
+
+// -----------------------------------------------------------------------------
+// PCLMULQDQ GHASH
+//
+// Blocks are byte reversed into registers so the carry-less products can use the
+// reduction of the Intel GCM white paper (shift the 256-bit product left by one,
+// then fold with x^128 + x^7 + x^2 + x + 1). Eight blocks are multiplied by
+// H^8 .. H^1 and summed before a single reduction.
+// -----------------------------------------------------------------------------
+
+#if HASH_USE_CPU_DISPATCH
+#define AES_GCM_BSWAP		_mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)
+#define AES_GCM_LOAD(p)		_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p)), bswap)
+#define AES_GCM_CLMUL(a, b)	lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00)); \
+				hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11)); \
+				mid = _mm_xor_si128(mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x01), \
+								       _mm_clmulepi64_si128(a, b, 0x10)))
+
+/*
+ *  AesGcmReduce
+ *
+ * Reduces the unreduced 256-bit product Hi:Mid:Lo (Mid holding the summed cross products) to one field element.
+ */
+LIBHASH_TARGET("sse2")
+static inline __m128i AesGcmReduce(__m128i Lo, __m128i Mid, __m128i Hi) {
+	__m128i t1, t2, t3;
+	Lo = _mm_xor_si128(Lo, _mm_slli_si128(Mid, 8));
+	Hi = _mm_xor_si128(Hi, _mm_srli_si128(Mid, 8));
+	t1 = _mm_srli_epi32(Lo, 31);
+	t2 = _mm_srli_epi32(Hi, 31);
+	Lo = _mm_or_si128(_mm_slli_epi32(Lo, 1), _mm_slli_si128(t1, 4));
+	Hi = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(Hi, 1), _mm_slli_si128(t2, 4)), _mm_srli_si128(t1, 12));
+	t1 = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(Lo, 31), _mm_slli_epi32(Lo, 30)), _mm_slli_epi32(Lo, 25));
+	t2 = _mm_srli_si128(t1, 4);
+	Lo = _mm_xor_si128(Lo, _mm_slli_si128(t1, 12));
+	t3 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(Lo, 1), _mm_srli_epi32(Lo, 2)), _mm_srli_epi32(Lo, 7));
+	Lo = _mm_xor_si128(Lo, _mm_xor_si128(t3, t2));
+	return _mm_xor_si128(Hi, Lo);
+}
+
+/*
+ *  AesGcmPowersPclmul
+ *
+ * Stores H^1 .. H^AES_GCM_PIPELINE, byte reversed, into HPowers.
+ */
+LIBHASH_TARGET("pclmul,ssse3")
+static void AesGcmPowersPclmul(AesGcmContext* Context, const uint8_t H[AESGCM_BLOCK_SIZE]) {
+	const __m128i bswap = AES_GCM_BSWAP;
+	__m128i h = AES_GCM_LOAD(H), p = h, lo, mid, hi;
+	int i;
+	_mm_storeu_si128((__m128i*)Context->HPowers[0], h);
+	for (i = 1; i < AES_GCM_PIPELINE; i++) {
+		lo = mid = hi = _mm_setzero_si128();
+		AES_GCM_CLMUL(p, h);
+		p = AesGcmReduce(lo, mid, hi);
+		_mm_storeu_si128((__m128i*)Context->HPowers[i], p);
+	}
+}
+
+/*
+ *  AesGcmGhashPclmul
+ *
+ * Folds Blocks whole blocks into the running GHASH value, AES_GCM_PIPELINE at a time with one reduction each.
+ */
+LIBHASH_TARGET("pclmul,ssse3")
+static void AesGcmGhashPclmul(AesGcmContext* Context, const uint8_t* Data, size_t Blocks) {
+	const __m128i bswap = AES_GCM_BSWAP;
+	__m128i h[AES_GCM_PIPELINE], x, c, lo, mid, hi;
+	int i;
+	for (i = 0; i < AES_GCM_PIPELINE; i++) h[i] = _mm_loadu_si128((const __m128i*)Context->HPowers[i]);
+	x = AES_GCM_LOAD(Context->Ghash);
+	for (; Blocks >= AES_GCM_PIPELINE; Blocks -= AES_GCM_PIPELINE, Data += AES_GCM_PIPELINE * AESGCM_BLOCK_SIZE) {
+		lo = mid = hi = _mm_setzero_si128();
+		c = _mm_xor_si128(AES_GCM_LOAD(Data), x);
+		AES_GCM_CLMUL(c, h[7]);
+		for (i = 1; i < AES_GCM_PIPELINE; i++) {
+			c = AES_GCM_LOAD(Data + AESGCM_BLOCK_SIZE * i);
+			AES_GCM_CLMUL(c, h[7 - i]);
+		}
+		x = AesGcmReduce(lo, mid, hi);
+	}
+	for (; Blocks; Blocks--, Data += AESGCM_BLOCK_SIZE) {
+		lo = mid = hi = _mm_setzero_si128();
+		c = _mm_xor_si128(AES_GCM_LOAD(Data), x);
+		AES_GCM_CLMUL(c, h[0]);
+		x = AesGcmReduce(lo, mid, hi);
+	}
+	_mm_storeu_si128((__m128i*)Context->Ghash, _mm_shuffle_epi8(x, bswap));
+}
+#endif
+
+/*
+ *  AesGcmGhash
+ *
+ * Folds Blocks whole blocks of Data into the running GHASH value.
+ */
+static inline void AesGcmGhash(AesGcmContext* Context, const uint8_t* Data, size_t Blocks) {
+#if HASH_USE_CPU_DISPATCH
+	if (Context->Flags & AES_GCM_PCLMUL) {
+		AesGcmGhashPclmul(Context, Data, Blocks);
+		return;
+	}
+#endif
+	for (; Blocks; Blocks--, Data += AESGCM_BLOCK_SIZE) {
+		XorAesBlock(Context->Ghash, Data);
+		AesGcmTableMultiply(Context, Context->Ghash);
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Counter mode
+//
+// GCM counter blocks are the first 96 bits of J0 followed by a 32-bit big endian
+// counter that wraps on its own (inc32). That is the AesCtr counter block with
+// the IV set to the first 64 bits of J0 and the block index holding the next 32
+// bits in its upper half, as long as a run does not cross a wrap of the counter.
+// -----------------------------------------------------------------------------
+
+/*
+ *  AesGcmCtrBlocks
+ *
+ * XORs the keystream of Blocks whole blocks starting at 32-bit Counter onto In, through AesCtrXorBlocks.
+ */
+static inline void AesGcmCtrBlocks(const AesGcmContext* Context, uint32_t Counter, const uint8_t* In, uint8_t* Out,
+				   size_t Blocks) {
+	uint64_t upper = (uint64_t)AesGcmLoad32(Context->J0 + 8) << 32, run;
+	while (Blocks) {
+		run = (((uint64_t)1) << 32) - Counter;
+		if (run > Blocks) run = Blocks;
+		AesCtrXorBlocks(&Context->Aes, Context->J0, upper | Counter, In, Out, (size_t)run);
+		In += run * AESGCM_BLOCK_SIZE;
+		Out += run * AESGCM_BLOCK_SIZE;
+		Blocks -= (size_t)run;
+		Counter += (uint32_t)run;
+	}
+}
+
+#if HASH_USE_CPU_DISPATCH
+// The counter block is kept byte reversed so inc32 is a 32-bit add on its lowest lane
+#define AES_GCM_NI_COUNTER(j)	_mm_xor_si128(_mm_shuffle_epi8(_mm_add_epi32(counter, _mm_set_epi32(0, 0, 0, j)), bswap), k[0])
+#define AES_GCM_NI_EACH(OP, x)	b0 = OP(b0, x); b1 = OP(b1, x); b2 = OP(b2, x); b3 = OP(b3, x); \
+				b4 = OP(b4, x); b5 = OP(b5, x); b6 = OP(b6, x); b7 = OP(b7, x)
+#define AES_GCM_NI_ROUND(r)	AES_GCM_NI_EACH(_mm_aesenc_si128, k[r])
+#define AES_GCM_NI_HASH(j)	c = AES_GCM_LOAD(hash + AESGCM_BLOCK_SIZE * (j)); AES_GCM_CLMUL(c, h[7 - (j)])
+#define AES_GCM_NI_STORE(b, j)	_mm_storeu_si128((__m128i*)(Out + AESGCM_BLOCK_SIZE * (j)), \
+						 _mm_xor_si128(b, _mm_loadu_si128((const __m128i*)(In + AESGCM_BLOCK_SIZE * (j)))))
+
+/*
+ *  AesGcmCryptBlocksAesNi
+ *
+ * Encrypts or decrypts Blocks whole blocks and folds the ciphertext into GHASH in the same pass. Each group of
+ * AES_GCM_PIPELINE counter blocks goes through the AES rounds while the carry-less multiplies of a ciphertext group
+ * are issued between them: the group being decrypted, or when encrypting the group produced by the previous
+ * iteration. AESENC and PCLMULQDQ run on different ports, so the hashing mostly hides behind the cipher.
+ */
+LIBHASH_TARGET("aes,pclmul,ssse3")
+static void AesGcmCryptBlocksAesNi(AesGcmContext* Context, uint32_t Counter, const uint8_t* In, uint8_t* Out,
+				   size_t Blocks, int Encrypt) {
+	const __m128i* rk = (const __m128i*)Context->Aes.eK;
+	const __m128i bswap = AES_GCM_BSWAP;
+	__m128i k[15], h[AES_GCM_PIPELINE], x, c, lo, mid, hi, counter, b0, b1, b2, b3, b4, b5, b6, b7;
+	const uint8_t* hash = NULL;
+	uint_fast32_t nr = Context->Aes.Nr, r;
+	uint8_t block[AESGCM_BLOCK_SIZE];
+	memcpy(block, Context->J0, AESGCM_BLOCK_SIZE);
+	AesGcmStore32(block + 12, Counter);
+	counter = AES_GCM_LOAD(block);
+	for (r = 0; r <= nr; r++) k[r] = _mm_loadu_si128(rk + r);
+	for (r = 0; r < AES_GCM_PIPELINE; r++) h[r] = _mm_loadu_si128((const __m128i*)Context->HPowers[r]);
+	x = AES_GCM_LOAD(Context->Ghash);
+	for (; Blocks >= AES_GCM_PIPELINE; Blocks -= AES_GCM_PIPELINE, Counter += AES_GCM_PIPELINE) {
+		if (!Encrypt) hash = In;
+		b0 = AES_GCM_NI_COUNTER(0); b1 = AES_GCM_NI_COUNTER(1); b2 = AES_GCM_NI_COUNTER(2); b3 = AES_GCM_NI_COUNTER(3);
+		b4 = AES_GCM_NI_COUNTER(4); b5 = AES_GCM_NI_COUNTER(5); b6 = AES_GCM_NI_COUNTER(6); b7 = AES_GCM_NI_COUNTER(7);
+		counter = _mm_add_epi32(counter, _mm_set_epi32(0, 0, 0, AES_GCM_PIPELINE));
+		if (hash) {
+			lo = mid = hi = _mm_setzero_si128();
+			AES_GCM_NI_ROUND(1); c = _mm_xor_si128(AES_GCM_LOAD(hash), x); AES_GCM_CLMUL(c, h[7]);
+			AES_GCM_NI_ROUND(2); AES_GCM_NI_HASH(1);
+			AES_GCM_NI_ROUND(3); AES_GCM_NI_HASH(2);
+			AES_GCM_NI_ROUND(4); AES_GCM_NI_HASH(3);
+			AES_GCM_NI_ROUND(5); AES_GCM_NI_HASH(4);
+			AES_GCM_NI_ROUND(6); AES_GCM_NI_HASH(5);
+			AES_GCM_NI_ROUND(7); AES_GCM_NI_HASH(6);
+			AES_GCM_NI_ROUND(8); AES_GCM_NI_HASH(7);
+			for (r = 9; r < nr; r++) {
+				AES_GCM_NI_ROUND(r);
+			}
+			x = AesGcmReduce(lo, mid, hi);
+		} else {
+			for (r = 1; r < nr; r++) {
+				AES_GCM_NI_ROUND(r);
+			}
+		}
+		AES_GCM_NI_EACH(_mm_aesenclast_si128, k[nr]);
+		AES_GCM_NI_STORE(b0, 0); AES_GCM_NI_STORE(b1, 1); AES_GCM_NI_STORE(b2, 2); AES_GCM_NI_STORE(b3, 3);
+		AES_GCM_NI_STORE(b4, 4); AES_GCM_NI_STORE(b5, 5); AES_GCM_NI_STORE(b6, 6); AES_GCM_NI_STORE(b7, 7);
+		if (Encrypt) hash = Out;
+		In += AES_GCM_PIPELINE * AESGCM_BLOCK_SIZE;
+		Out += AES_GCM_PIPELINE * AESGCM_BLOCK_SIZE;
+	}
+	_mm_storeu_si128((__m128i*)Context->Ghash, _mm_shuffle_epi8(x, bswap));
+	if (Encrypt && hash) AesGcmGhashPclmul(Context, hash, AES_GCM_PIPELINE);
+	if (Blocks) {
+		if (!Encrypt) AesGcmGhashPclmul(Context, In, Blocks);
+		AesGcmCtrBlocks(Context, Counter, In, Out, Blocks);
+		if (Encrypt) AesGcmGhashPclmul(Context, Out, Blocks);
+	}
+}
+
+#undef AES_GCM_NI_COUNTER
+#undef AES_GCM_NI_EACH
+#undef AES_GCM_NI_ROUND
+#undef AES_GCM_NI_HASH
+#undef AES_GCM_NI_STORE
+#undef AES_GCM_BSWAP
+#undef AES_GCM_LOAD
+#undef AES_GCM_CLMUL
+#endif
+
+/*
+ *  AesGcmCryptBlocks
+ *
+ * Encrypts (Encrypt != 0) or decrypts Blocks whole blocks starting at 32-bit Counter and hashes the ciphertext. The
+ * portable path alternates CTR and GHASH over AES_GCM_CHUNK_BLOCKS blocks so the second pass reads from L1.
+ */
+static inline void AesGcmCryptBlocks(AesGcmContext* Context, uint32_t Counter, const uint8_t* In, uint8_t* Out,
+				     size_t Blocks, int Encrypt) {
+	size_t n;
+#if HASH_USE_CPU_DISPATCH
+	if ((Context->Flags & AES_GCM_PCLMUL) && (Context->Aes.Flags & AES_CONTEXT_AESNI)) {
+		AesGcmCryptBlocksAesNi(Context, Counter, In, Out, Blocks, Encrypt);
+		return;
+	}
+#endif
+	while (Blocks) {
+		n = (Blocks < AES_GCM_CHUNK_BLOCKS) ? Blocks : AES_GCM_CHUNK_BLOCKS;
+		if (!Encrypt) AesGcmGhash(Context, In, n);
+		AesGcmCtrBlocks(Context, Counter, In, Out, n);
+		if (Encrypt) AesGcmGhash(Context, Out, n);
+		In += n * AESGCM_BLOCK_SIZE;
+		Out += n * AESGCM_BLOCK_SIZE;
+		Counter += (uint32_t)n;
+		Blocks -= n;
+	}
+}
+
+/*
+ *  AesGcmCloseAad
+ *
+ * Pads and hashes the last partial AAD block the first time message data (or the tag) is processed.
+ */
+static inline void AesGcmCloseAad(AesGcmContext* Context) {
+	uint32_t rest = (uint32_t)(Context->AadSize % AESGCM_BLOCK_SIZE);
+	if (Context->Flags & AES_GCM_DATA) return;
+	if (rest) {
+		memset(Context->Buffer + rest, 0, AESGCM_BLOCK_SIZE - rest);
+		AesGcmGhash(Context, Context->Buffer, 1);
+	}
+	Context->Flags |= AES_GCM_DATA;
+}
+
+/*
+ *  AesGcmProcess
+ *
+ * Common body of AesGcmEncrypt and AesGcmDecrypt. The keystream block and the ciphertext of a partial block are kept
+ * in the context (CurrentCipherBlock, Buffer) so a message can be fed in pieces of any size.
+ */
+static inline int AesGcmProcess(AesGcmContext* Context, const uint8_t* In, uint8_t* Out, uint32_t Size, int Encrypt) {
+	uint32_t offset = (uint32_t)(Context->DataSize % AESGCM_BLOCK_SIZE), chunk, counter;
+	size_t blocks;
+	if (Context->DataSize + Size > AES_GCM_MAX_DATA_SIZE) return -1;
+	AesGcmCloseAad(Context);
+	if (Size == 0) return 0;
+	if (offset) {
+		chunk = AESGCM_BLOCK_SIZE - offset;
+		if (chunk > Size) chunk = Size;
+		if (!Encrypt) memcpy(Context->Buffer + offset, In, chunk);
+		XorBuffers(In, Context->CurrentCipherBlock + offset, Out, chunk);
+		if (Encrypt) memcpy(Context->Buffer + offset, Out, chunk);
+		Context->DataSize += chunk;
+		if (Context->DataSize % AESGCM_BLOCK_SIZE) return 0;
+		AesGcmGhash(Context, Context->Buffer, 1);
+		In += chunk;
+		Out += chunk;
+		Size -= chunk;
+	}
+	counter = AesGcmLoad32(Context->J0 + 12) + 1 + (uint32_t)(Context->DataSize / AESGCM_BLOCK_SIZE);
+	blocks = Size / AESGCM_BLOCK_SIZE;
+	if (blocks) {
+		AesGcmCryptBlocks(Context, counter, In, Out, blocks, Encrypt);
+		In += blocks * AESGCM_BLOCK_SIZE;
+		Out += blocks * AESGCM_BLOCK_SIZE;
+		Context->DataSize += (uint64_t)blocks * AESGCM_BLOCK_SIZE;
+		counter += (uint32_t)blocks;
+		Size %= AESGCM_BLOCK_SIZE;
+	}
+	if (Size) {
+		memcpy(Context->CurrentCipherBlock, Context->J0, AESGCM_BLOCK_SIZE);
+		AesGcmStore32(Context->CurrentCipherBlock + 12, counter);
+		AesEncryptInPlace(&Context->Aes, Context->CurrentCipherBlock);
+		if (!Encrypt) memcpy(Context->Buffer, In, Size);
+		XorBuffers(In, Context->CurrentCipherBlock, Out, Size);
+		if (Encrypt) memcpy(Context->Buffer, Out, Size);
+		Context->DataSize += Size;
+	}
+	return 0;
+}
+
+/*
+ *  AesGcmInitialise
+ *
+ * Initialises an AesGcmContext with an already initialised AesContext: derives
+ * the hash key H and its GHASH tables. A message is then started with
+ * AesGcmStart; the context can be reused for any number of messages.
+ */
+LIBHASH_INLINE_API void AesGcmInitialise(AesGcmContext *Context,const AesContext *InitialisedAesContext) {
+	uint8_t h[AESGCM_BLOCK_SIZE] = { 0 };
+	Context->Aes = *InitialisedAesContext;
+	AesEncryptInPlace(&Context->Aes, h);
+	AesGcmTableInitialise(Context, h);
+	Context->Flags = 0;
+#if HASH_USE_CPU_DISPATCH
+	if ((libhash_cpu_features() & (HASH_CPU_PCLMUL | HASH_CPU_SSSE3)) == (HASH_CPU_PCLMUL | HASH_CPU_SSSE3)) {
+		AesGcmPowersPclmul(Context, h);
+		Context->Flags |= AES_GCM_PCLMUL;
+	}
+#endif
+	memset(Context->Ghash, 0, AESGCM_BLOCK_SIZE);
+	memset(Context->J0, 0, AESGCM_BLOCK_SIZE);
+	Context->AadSize = 0;
+	Context->DataSize = 0;
+}
+
+/*
+ *  AesGcmInitialiseWithKey
+ *
+ * Initialises an AesGcmContext with an AES Key. KeySize must be 16, 24, or 32
+ * (for 128, 192, or 256 bit key size) Returns 0 if successful, or -1 if invalid
+ * KeySize provided
+ */
+LIBHASH_INLINE_API int AesGcmInitialiseWithKey(AesGcmContext *Context,const uint8_t *Key,uint32_t KeySize) {
+	AesContext aes;
+	if (AesInitialiseEncryptOnly(&aes, Key, KeySize) != 0) return -1;
+	AesGcmInitialise(Context, &aes);
+	return 0;
+}
+
+/*
+ *  AesGcmStart
+ *
+ * Starts a new message under IV. 12 byte IVs (AES_GCM_IV_SIZE) are used as
+ * is, any other non-zero size is hashed into the pre-counter block. Returns 0
+ * if successful, or -1 if IVSize is 0
+ */
+LIBHASH_INLINE_API int AesGcmStart(AesGcmContext *Context,const uint8_t *IV,uint32_t IVSize) {
+	uint8_t block[AESGCM_BLOCK_SIZE];
+	if (IVSize == 0) return -1;
+	memset(Context->Ghash, 0, AESGCM_BLOCK_SIZE);
+	if (IVSize == AES_GCM_IV_SIZE) {
+		memcpy(Context->J0, IV, AES_GCM_IV_SIZE);
+		AesGcmStore32(Context->J0 + 12, 1);
+	} else {
+		AesGcmGhash(Context, IV, IVSize / AESGCM_BLOCK_SIZE);
+		if (IVSize % AESGCM_BLOCK_SIZE) {
+			memset(block, 0, AESGCM_BLOCK_SIZE);
+			memcpy(block, IV + IVSize - IVSize % AESGCM_BLOCK_SIZE, IVSize % AESGCM_BLOCK_SIZE);
+			AesGcmGhash(Context, block, 1);
+		}
+		memset(block, 0, 8);
+		AesGcmStore64(block + 8, (uint64_t)IVSize * 8);
+		AesGcmGhash(Context, block, 1);
+		memcpy(Context->J0, Context->Ghash, AESGCM_BLOCK_SIZE);
+		memset(Context->Ghash, 0, AESGCM_BLOCK_SIZE);
+	}
+	Context->AadSize = 0;
+	Context->DataSize = 0;
+	Context->Flags &= ~(uint32_t)AES_GCM_DATA;
+	return 0;
+}
+
+/*
+ *  AesGcmUpdateAad
+ *
+ * Adds Size bytes of additional authenticated data to the current message.
+ * Can be called any number of times, but only before the first AesGcmEncrypt
+ * or AesGcmDecrypt of the message. Returns 0 if successful, or -1 if message
+ * data has already been processed
+ */
+LIBHASH_INLINE_API int AesGcmUpdateAad(AesGcmContext *Context,const void *Aad,uint32_t Size) {
+	const uint8_t* in = hash_c_cast(const uint8_t*,Aad);
+	uint32_t offset = (uint32_t)(Context->AadSize % AESGCM_BLOCK_SIZE), chunk;
+	if (Context->Flags & AES_GCM_DATA) return -1;
+	Context->AadSize += Size;
+	if (offset) {
+		chunk = AESGCM_BLOCK_SIZE - offset;
+		if (chunk > Size) chunk = Size;
+		memcpy(Context->Buffer + offset, in, chunk);
+		if (offset + chunk < AESGCM_BLOCK_SIZE) return 0;
+		AesGcmGhash(Context, Context->Buffer, 1);
+		in += chunk;
+		Size -= chunk;
+	}
+	AesGcmGhash(Context, in, Size / AESGCM_BLOCK_SIZE);
+	if (Size % AESGCM_BLOCK_SIZE) memcpy(Context->Buffer, in + Size - Size % AESGCM_BLOCK_SIZE, Size % AESGCM_BLOCK_SIZE);
+	return 0;
+}
+
+/*
+ *  AesGcmEncrypt
+ *
+ * Encrypts Size bytes of the current message and authenticates the resulting
+ * ciphertext in the same pass. Can be called any number of times with pieces
+ * of any size. InBuffer and OutBuffer can point to the same location. Returns
+ * 0 if successful, or -1 if the message would exceed AES_GCM_MAX_DATA_SIZE
+ */
+LIBHASH_INLINE_API int AesGcmEncrypt(AesGcmContext *Context,const void *InBuffer,void *OutBuffer,uint32_t Size) {
+	return AesGcmProcess(Context, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size, 1);
+}
+
+/*
+ *  AesGcmDecrypt
+ *
+ * Decrypts Size bytes of the current message, authenticating the ciphertext
+ * in the same pass. The plaintext must not be trusted before AesGcmVerify has
+ * succeeded. Returns 0 if successful, or -1 if the message would exceed
+ * AES_GCM_MAX_DATA_SIZE
+ */
+LIBHASH_INLINE_API int AesGcmDecrypt(AesGcmContext *Context,const void *InBuffer,void *OutBuffer,uint32_t Size) {
+	return AesGcmProcess(Context, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size, 0);
+}
+
+/*
+ *  AesGcmUpdateAadLarge
+ *
+ * AesGcmUpdateAad for a size_t length.
+ */
+LIBHASH_INLINE_API int AesGcmUpdateAadLarge(AesGcmContext *Context,const void *Aad,size_t Size) {
+	const uint8_t* in = hash_c_cast(const uint8_t*,Aad);
+	if (Context->Flags & AES_GCM_DATA) return -1;
+	for (; Size > HASH_LARGE_STRIDE; in += HASH_LARGE_STRIDE, Size -= HASH_LARGE_STRIDE)
+		AesGcmUpdateAad(Context, in, HASH_LARGE_STRIDE);
+	return AesGcmUpdateAad(Context, in, hash_cast(uint32_t,Size));
+}
+
+/*
+ *  AesGcmProcessLarge
+ *
+ * AesGcmProcess for a size_t length. The size limit is checked up front so a message that is too long is refused
+ * before any of it is processed.
+ */
+static inline int AesGcmProcessLarge(AesGcmContext* Context, const uint8_t* In, uint8_t* Out, size_t Size, int Encrypt) {
+	if (Size > AES_GCM_MAX_DATA_SIZE || Context->DataSize + Size > AES_GCM_MAX_DATA_SIZE) return -1;
+	for (; Size > HASH_LARGE_STRIDE; In += HASH_LARGE_STRIDE, Out += HASH_LARGE_STRIDE, Size -= HASH_LARGE_STRIDE)
+		AesGcmProcess(Context, In, Out, HASH_LARGE_STRIDE, Encrypt);
+	return AesGcmProcess(Context, In, Out, hash_cast(uint32_t,Size), Encrypt);
+}
+
+/*
+ *  AesGcmEncryptLarge
+ *
+ * AesGcmEncrypt for a size_t length.
+ */
+LIBHASH_INLINE_API int AesGcmEncryptLarge(AesGcmContext *Context,const void *InBuffer,void *OutBuffer,size_t Size) {
+	return AesGcmProcessLarge(Context, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size, 1);
+}
+
+/*
+ *  AesGcmDecryptLarge
+ *
+ * AesGcmDecrypt for a size_t length.
+ */
+LIBHASH_INLINE_API int AesGcmDecryptLarge(AesGcmContext *Context,const void *InBuffer,void *OutBuffer,size_t Size) {
+	return AesGcmProcessLarge(Context, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size, 0);
+}
+
+/*
+ *  AesGcmFinish
+ *
+ * Completes the current message and writes its 16 byte authentication tag.
+ * Start the next message with AesGcmStart.
+ */
+LIBHASH_INLINE_API void AesGcmFinish(AesGcmContext *Context,uint8_t Tag[AES_GCM_TAG_SIZE]) {
+	uint8_t block[AESGCM_BLOCK_SIZE];
+	uint32_t rest = (uint32_t)(Context->DataSize % AESGCM_BLOCK_SIZE);
+	AesGcmCloseAad(Context);
+	if (rest) {
+		memset(Context->Buffer + rest, 0, AESGCM_BLOCK_SIZE - rest);
+		AesGcmGhash(Context, Context->Buffer, 1);
+	}
+	AesGcmStore64(block, Context->AadSize * 8);
+	AesGcmStore64(block + 8, Context->DataSize * 8);
+	AesGcmGhash(Context, block, 1);
+	AesEncrypt(&Context->Aes, Context->J0, block);
+	XorBuffers(block, Context->Ghash, Tag, AES_GCM_TAG_SIZE);
+}
+
+/*
+ *  AesGcmVerify
+ *
+ * Completes the current message like AesGcmFinish and compares the first
+ * TagSize bytes of its tag with Tag in constant time. TagSize must be between
+ * 4 and 16. Returns 0 if the tag matches, or -1 otherwise
+ */
+LIBHASH_INLINE_API int AesGcmVerify(AesGcmContext *Context,const uint8_t *Tag,uint32_t TagSize) {
+	uint8_t tag[AES_GCM_TAG_SIZE];
+	uint8_t diff = 0;
+	uint32_t i;
+	if (TagSize < 4 || TagSize > AES_GCM_TAG_SIZE) return -1;
+	AesGcmFinish(Context, tag);
+	for (i = 0; i < TagSize; i++) diff |= tag[i] ^ Tag[i];
+	return diff ? -1 : 0;
+}
+
+/*
+ *  AesGcmEncryptWithKey
+ *
+ * This function combines AesGcmInitialiseWithKey, AesGcmStart, AesGcmUpdateAad,
+ * AesGcmEncrypt and AesGcmFinish for a message encrypted in one go. Returns 0
+ * if successful, or -1 if invalid KeySize, IVSize or BufferSize provided
+ */
+LIBHASH_INLINE_API int AesGcmEncryptWithKey(const uint8_t *Key,uint32_t KeySize,const uint8_t *IV,uint32_t IVSize,
+				       const void *Aad,uint32_t AadSize,const void *InBuffer,void *OutBuffer,
+				       uint32_t BufferSize,uint8_t Tag[AES_GCM_TAG_SIZE]) {
+	AesGcmContext context;
+	if (AesGcmInitialiseWithKey(&context, Key, KeySize) != 0) return -1;
+	if (AesGcmStart(&context, IV, IVSize) != 0) return -1;
+	AesGcmUpdateAad(&context, Aad, AadSize);
+	if (AesGcmEncrypt(&context, InBuffer, OutBuffer, BufferSize) != 0) return -1;
+	AesGcmFinish(&context, Tag);
+	return 0;
+}
+
+/*
+ *  AesGcmDecryptWithKey
+ *
+ * Decrypts and authenticates a message in one go. On a tag mismatch OutBuffer
+ * is cleared. Returns 0 if successful, or -1 if invalid KeySize, IVSize or
+ * TagSize provided or the message does not authenticate
+ */
+LIBHASH_INLINE_API int AesGcmDecryptWithKey(const uint8_t *Key,uint32_t KeySize,const uint8_t *IV,uint32_t IVSize,
+				       const void *Aad,uint32_t AadSize,const void *InBuffer,void *OutBuffer,
+				       uint32_t BufferSize,const uint8_t *Tag,uint32_t TagSize) {
+	AesGcmContext context;
+	if (AesGcmInitialiseWithKey(&context, Key, KeySize) != 0) return -1;
+	if (AesGcmStart(&context, IV, IVSize) != 0) return -1;
+	AesGcmUpdateAad(&context, Aad, AadSize);
+	if (AesGcmDecrypt(&context, InBuffer, OutBuffer, BufferSize) != 0 || AesGcmVerify(&context, Tag, TagSize) != 0) {
+		memset(OutBuffer, 0, BufferSize);
+		return -1;
+	}
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AESGCM_H__ */
@@ -21,31 +21,69 @@
 #define __AESOFB_H__
 
 #include <aes.h>
+#include "threadpool.h"
 
 #define AESOFB_BLOCK_SIZE AES_BLOCK_SIZE
+// Largest run of keystream AesOfbRefill generates before publishing it to the reader
+#define AES_OFB_REFILL_CHUNK	(1U << 10)
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * AesOfbKeystream
+ *
+ * Ring buffer of keystream generated ahead of the data (see AesOfbEnableKeystream). Bytes [ReadIndex, WriteIndex) of
+ * the stream are ready in Buffer. One writer (AesOfbRefill) and one reader (AesOfbXor) may run on different threads.
+ */
+typedef struct AesOfbKeystream {
+	uint8_t* Buffer;
+	uint32_t Size;				// multiple of AESOFB_BLOCK_SIZE
+	uint64_t ReadIndex;			// keystream bytes consumed
+	uint64_t WriteIndex;			// keystream bytes generated, always whole blocks
+	uint8_t Chain[AESOFB_BLOCK_SIZE];	// last generated block, input of the next encryption
+	int Filling;				// a thread is generating keystream
+	int Stopped;				// AesOfbStopRefill was called
+#if HASH_USE_THREADS
+	libhash_mutex_t Lock;			// guards every field above but Buffer, Size and Chain
+	libhash_cond_t Moved;			// an index moved or Filling was cleared
+#endif
+} AesOfbKeystream;
+
 typedef struct {
 	AesContext Aes;
 	uint8_t CurrentCipherBlock[AESOFB_BLOCK_SIZE];
 	uint32_t IndexWithinCipherBlock;
+	AesOfbKeystream* Keystream;		// NULL unless AesOfbEnableKeystream was called
 } AesOfbContext;
 
+/*
+ * AesOfbSharedContext
+ *
+ * OFB stream state over an externally owned key schedule. The AesContext is only read, so one initialised schedule
+ * can back any number of streams on any number of threads; it must outlive them.
+ */
+typedef struct {
+	const AesContext* Aes;
+	uint8_t CurrentCipherBlock[AESOFB_BLOCK_SIZE];
+	uint32_t IndexWithinCipherBlock;
+} AesOfbSharedContext;
+
 /*
  *  AesOfbInitialise
  *
  * Initialises an AesOfbContext with an already initialised AesContext and a IV.
  * This function can quickly be used to change the IV without requiring the more
- * lengthy processes of reinitialising an AES key.
+ * lengthy processes of reinitialising an AES key. Any keystream buffer must be
+ * released with AesOfbDisableKeystream first.
  */
 LIBHASH_INLINE_API void AesOfbInitialise(AesOfbContext *Context,const AesContext *InitialisedAesContext,
 				    const uint8_t IV[AESOFB_BLOCK_SIZE]) {
 	Context->Aes = *InitialisedAesContext;
 	memcpy(Context->CurrentCipherBlock, IV, sizeof(Context->CurrentCipherBlock));
 	Context->IndexWithinCipherBlock = 0;
+	Context->Keystream = NULL;
 	AesEncryptInPlace(&Context->Aes, Context->CurrentCipherBlock);
 }
 
@@ -60,45 +98,207 @@ LIBHASH_INLINE_API void AesOfbInitialise(AesOfbContext *Context,const AesContext
 LIBHASH_INLINE_API int AesOfbInitialiseWithKey(AesOfbContext *Context,const uint8_t *Key, uint32_t KeySize,
 					  const uint8_t IV[AESOFB_BLOCK_SIZE]) {
 	AesContext aes;
-	if (0 != AesInitialise(&aes, Key, KeySize)) return -1;
+	if (0 != AesInitialiseEncryptOnly(&aes, Key, KeySize)) return -1;
 	AesOfbInitialise(Context, &aes, IV);
 	return 0;
 }
 
+#if HASH_USE_THREADS
+#define AES_OFB_LOCK(m)		LIBHASH_MUTEX_LOCK(m)
+#define AES_OFB_UNLOCK(m)	LIBHASH_MUTEX_UNLOCK(m)
+#define AES_OFB_WAIT(c, m)	LIBHASH_COND_WAIT(c, m)
+#define AES_OFB_WAKE(c)		LIBHASH_COND_BROADCAST(c)
+#else
+#define AES_OFB_LOCK(m)		((void)0)
+#define AES_OFB_UNLOCK(m)	((void)0)
+#define AES_OFB_WAIT(c, m)	((void)0)
+#define AES_OFB_WAKE(c)		((void)0)
+#endif
+
+#if HASH_USE_CPU_DISPATCH
 /*
- *  AesOfbXor
+ *  AesOfbChainAesNi
  *
- * XORs the stream of byte of the AesOfbContext from its current stream position
- * onto the specified buffer. This will advance the stream index by that number
- * of bytes. Use once over data to encrypt it. Use it a second time over the
- * same data from the same stream position and the data will be decrypted.
- * InBuffer and OutBuffer can point to the same location for in-place
- * encrypting/decrypting
+ * AES-NI OFB chain: Out[i] = E(Out[i-1]) with Out[-1] = Chain, which is updated to the last block. Every block
+ * depends on the one before, so nothing is interleaved; the round keys just stay in registers across the blocks.
  */
-LIBHASH_INLINE_API void AesOfbXor(AesOfbContext *Context,const void *InBuffer, void *OutBuffer,uint32_t Size) {
+LIBHASH_TARGET("aes,sse2")
+static void AesOfbChainAesNi(const AesContext* Aes, uint8_t Chain[AESOFB_BLOCK_SIZE], uint8_t* Out, size_t Blocks) {
+	const __m128i* rk = (const __m128i*)Aes->eK;
+	__m128i k[15], b = _mm_loadu_si128((const __m128i*)Chain);
+	uint_fast32_t nr = Aes->Nr, r;
+	for (r = 0; r <= nr; r++) k[r] = _mm_loadu_si128(rk + r);
+	for (; Blocks; Blocks--, Out += AESOFB_BLOCK_SIZE) {
+		b = _mm_xor_si128(b, k[0]);
+		for (r = 1; r < nr; r++) b = _mm_aesenc_si128(b, k[r]);
+		b = _mm_aesenclast_si128(b, k[nr]);
+		_mm_storeu_si128((__m128i*)Out, b);
+	}
+	_mm_storeu_si128((__m128i*)Chain, b);
+}
+#endif
+
+/*
+ *  AesOfbChain
+ *
+ * Generates Blocks keystream blocks following Chain into Out and leaves the last of them in Chain.
+ */
+static inline void AesOfbChain(const AesContext* Aes, uint8_t Chain[AESOFB_BLOCK_SIZE], uint8_t* Out, size_t Blocks) {
+	if (Blocks == 0) return;
+#if HASH_USE_CPU_DISPATCH
+	if (Aes->Flags & AES_CONTEXT_AESNI) {
+		AesOfbChainAesNi(Aes, Chain, Out, Blocks);
+		return;
+	}
+#endif
+	for (; Blocks; Blocks--, Out += AESOFB_BLOCK_SIZE) {
+		AesEncrypt(Aes, Chain, Out);
+		memcpy(Chain, Out, AESOFB_BLOCK_SIZE);
+	}
+}
+
+/*
+ *  AesOfbKeystreamSpace
+ *
+ * Free whole blocks of the ring in bytes; the slot of a partly read block is not free yet. Called with Lock held.
+ */
+static inline uint32_t AesOfbKeystreamSpace(const AesOfbKeystream* Ring) {
+	uint32_t space = Ring->Size - (uint32_t)(Ring->WriteIndex - Ring->ReadIndex);
+	return space - space % AESOFB_BLOCK_SIZE;
+}
+
+/*
+ *  AesOfbKeystreamFill
+ *
+ * Generates up to Max bytes (rounded up to whole blocks) into the free part of the ring and returns the number of
+ * bytes added. Only one thread generates at a time: it claims the ring by setting Filling, and any other caller
+ * returns 0 at once, or with Wait sleeps until the ring is unclaimed and has a free block (returning 0 once
+ * AesOfbStopRefill was called). Lock is dropped while blocks are encrypted and every run of at most
+ * AES_OFB_REFILL_CHUNK bytes is published on its own, so a waiting reader resumes after one run.
+ */
+static inline uint32_t AesOfbKeystreamFill(const AesContext* Aes, AesOfbKeystream* Ring, uint32_t Max, int Wait) {
+	uint64_t write;
+	uint32_t space, offset, chunk, total = 0;
+	AES_OFB_LOCK(&Ring->Lock);
+#if HASH_USE_THREADS
+	while (Wait && !Ring->Stopped && (Ring->Filling || AesOfbKeystreamSpace(Ring) == 0))
+		AES_OFB_WAIT(&Ring->Moved, &Ring->Lock);
+#endif
+	if (Ring->Filling || (Wait && Ring->Stopped)) {
+		AES_OFB_UNLOCK(&Ring->Lock);
+		return 0;
+	}
+	Ring->Filling = 1;
+	while (total < Max && (space = AesOfbKeystreamSpace(Ring)) != 0) {
+		write = Ring->WriteIndex;
+		AES_OFB_UNLOCK(&Ring->Lock);
+		offset = (uint32_t)(write % Ring->Size);
+		chunk = Ring->Size - offset;
+		if (chunk > space) chunk = space;
+		if (chunk > AES_OFB_REFILL_CHUNK) chunk = AES_OFB_REFILL_CHUNK;
+		if (chunk > Max - total) chunk = (Max - total + AESOFB_BLOCK_SIZE - 1) / AESOFB_BLOCK_SIZE * AESOFB_BLOCK_SIZE;
+		AesOfbChain(Aes, Ring->Chain, Ring->Buffer + offset, chunk / AESOFB_BLOCK_SIZE);
+		AES_OFB_LOCK(&Ring->Lock);
+		Ring->WriteIndex += chunk;
+		total += chunk;
+		AES_OFB_WAKE(&Ring->Moved);
+	}
+	Ring->Filling = 0;
+	AES_OFB_WAKE(&Ring->Moved);
+	AES_OFB_UNLOCK(&Ring->Lock);
+	return total;
+}
+
+/*
+ *  AesOfbKeystreamXor
+ *
+ * AesOfbXor through the ring: ready keystream is XORed straight from the buffer. When the ring runs dry the reader
+ * waits for the next run if another thread is generating, and otherwise generates just what the call still needs.
+ */
+static inline void AesOfbKeystreamXor(const AesContext* Aes, AesOfbKeystream* Ring, const uint8_t* In, uint8_t* Out,
+				      uint32_t Size) {
+	uint64_t read;
+	uint32_t ready, offset, chunk;
+	while (Size) {
+		AES_OFB_LOCK(&Ring->Lock);
+		ready = (uint32_t)(Ring->WriteIndex - Ring->ReadIndex);
+		read = Ring->ReadIndex;
+		if (ready == 0 && Ring->Filling) {
+			AES_OFB_WAIT(&Ring->Moved, &Ring->Lock);
+			AES_OFB_UNLOCK(&Ring->Lock);
+			continue;
+		}
+		AES_OFB_UNLOCK(&Ring->Lock);
+		if (ready == 0) {
+			AesOfbKeystreamFill(Aes, Ring, Size, 0);
+			continue;
+		}
+		offset = (uint32_t)(read % Ring->Size);
+		chunk = Ring->Size - offset;
+		if (chunk > ready) chunk = ready;
+		if (chunk > Size) chunk = Size;
+		XorBuffers(In, Ring->Buffer + offset, Out, chunk);
+		AES_OFB_LOCK(&Ring->Lock);
+		Ring->ReadIndex += chunk;
+		AES_OFB_WAKE(&Ring->Moved);
+		AES_OFB_UNLOCK(&Ring->Lock);
+		In += chunk;
+		Out += chunk;
+		Size -= chunk;
+	}
+}
+
+/*
+ *  AesOfbProcess
+ *
+ * Common body of AesOfbXor and AesOfbSharedXor over the key schedule and the stream state fields.
+ */
+static inline void AesOfbProcess(const AesContext* Aes, uint8_t CurrentCipherBlock[AESOFB_BLOCK_SIZE],
+				 uint32_t* IndexWithinCipherBlock, const uint8_t* InBuffer, uint8_t* OutBuffer, uint32_t Size) {
 	uint32_t amountLeft = Size, outputOffset = 0, chunkSize, amountAvailableInBlock;
-	amountAvailableInBlock = AESOFB_BLOCK_SIZE - Context->IndexWithinCipherBlock;
+	amountAvailableInBlock = AESOFB_BLOCK_SIZE - *IndexWithinCipherBlock;
 	chunkSize = (((amountAvailableInBlock) < (amountLeft)) ? (amountAvailableInBlock) : (amountLeft));
-	XorBuffers(hash_c_cast(uint8_t*,InBuffer), Context->CurrentCipherBlock +
-		   (AESOFB_BLOCK_SIZE - amountAvailableInBlock), uhash_cast(uint8_t*,OutBuffer), chunkSize);
+	XorBuffers(InBuffer, CurrentCipherBlock +
+		   (AESOFB_BLOCK_SIZE - amountAvailableInBlock), OutBuffer, chunkSize);
 	amountLeft -= chunkSize;
 	outputOffset += chunkSize;
-	Context->IndexWithinCipherBlock += chunkSize;
+	*IndexWithinCipherBlock += chunkSize;
 	while (amountLeft > 0) {
-		AesEncryptInPlace(&Context->Aes, Context->CurrentCipherBlock);
+		AesEncryptInPlace(Aes, CurrentCipherBlock);
 		chunkSize = (((amountLeft)<(AESOFB_BLOCK_SIZE))?(amountLeft):(AESOFB_BLOCK_SIZE));
-		XorBuffers(	hash_c_cast(uint8_t*,InBuffer)+outputOffset, Context->CurrentCipherBlock,
-					(uhash_cast(uint8_t*,OutBuffer)+outputOffset), chunkSize);
+		XorBuffers(	InBuffer+outputOffset, CurrentCipherBlock,
+					(OutBuffer+outputOffset), chunkSize);
 		amountLeft -= chunkSize;
 		outputOffset += chunkSize;
-		Context->IndexWithinCipherBlock = chunkSize; // Note: Not incremented
+		*IndexWithinCipherBlock = chunkSize; // Note: Not incremented
 	}
 	if (AESOFB_BLOCK_SIZE == chunkSize) {
-		AesEncryptInPlace(&Context->Aes, Context->CurrentCipherBlock);
-		Context->IndexWithinCipherBlock = 0;
+		AesEncryptInPlace(Aes, CurrentCipherBlock);
+		*IndexWithinCipherBlock = 0;
 	}
 }
 
+/*
+ *  AesOfbXor
+ *
+ * XORs the stream of byte of the AesOfbContext from its current stream position
+ * onto the specified buffer. This will advance the stream index by that number
+ * of bytes. Use once over data to encrypt it. Use it a second time over the
+ * same data from the same stream position and the data will be decrypted.
+ * InBuffer and OutBuffer can point to the same location for in-place
+ * encrypting/decrypting. With a keystream buffer enabled the stream is taken
+ * from the buffer, so the call only XORs while keystream is ready.
+ */
+LIBHASH_INLINE_API void AesOfbXor(AesOfbContext *Context,const void *InBuffer, void *OutBuffer,uint32_t Size) {
+	if (Context->Keystream) {
+		AesOfbKeystreamXor(&Context->Aes, Context->Keystream, hash_c_cast(const uint8_t*,InBuffer),
+				   uhash_cast(uint8_t*,OutBuffer), Size);
+		return;
+	}
+	AesOfbProcess(&Context->Aes, Context->CurrentCipherBlock, &Context->IndexWithinCipherBlock,
+		      hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size);
+}
+
 /*
  *  AesOfbOutput
  *
@@ -110,6 +310,160 @@ LIBHASH_INLINE_API void AesOfbOutput(AesOfbContext *Context, void *Buffer, uint3
 	AesOfbXor(Context, Buffer, Buffer, Size);
 }
 
+/*
+ *  AesOfbXorLarge
+ *
+ * AesOfbXor for a size_t length.
+ */
+LIBHASH_INLINE_API void AesOfbXorLarge(AesOfbContext *Context,const void *InBuffer, void *OutBuffer,size_t Size) {
+	const uint8_t *in = hash_c_cast(const uint8_t*,InBuffer);
+	uint8_t *out = uhash_cast(uint8_t*,OutBuffer);
+	for (; Size > HASH_LARGE_STRIDE; in += HASH_LARGE_STRIDE, out += HASH_LARGE_STRIDE, Size -= HASH_LARGE_STRIDE)
+		AesOfbXor(Context, in, out, HASH_LARGE_STRIDE);
+	AesOfbXor(Context, in, out, hash_cast(uint32_t,Size));
+}
+
+/*
+ *  AesOfbEnableKeystream
+ *
+ * Attaches a ring buffer of Size bytes (rounded down to whole blocks, at least one) in which keystream is generated
+ * ahead of the data by AesOfbRefill. The stream continues from the current position; the output is the same as
+ * without the buffer. Returns 0 if successful, or -1 if Size is too small, the context already has a buffer, or the
+ * allocation failed.
+ */
+LIBHASH_INLINE_API int AesOfbEnableKeystream(AesOfbContext *Context, uint32_t Size) {
+	AesOfbKeystream* ring;
+	Size -= Size % AESOFB_BLOCK_SIZE;
+	if (Size == 0 || Context->Keystream) return -1;
+	ring = (AesOfbKeystream*)malloc(sizeof(AesOfbKeystream));
+	if (ring == NULL) return -1;
+	ring->Buffer = (uint8_t*)malloc(Size);
+	if (ring->Buffer == NULL) {
+		free(ring);
+		return -1;
+	}
+	ring->Size = Size;
+	// The block in use becomes the first block of the ring, already read up to IndexWithinCipherBlock
+	memcpy(ring->Buffer, Context->CurrentCipherBlock, AESOFB_BLOCK_SIZE);
+	memcpy(ring->Chain, Context->CurrentCipherBlock, AESOFB_BLOCK_SIZE);
+	ring->ReadIndex = Context->IndexWithinCipherBlock;
+	ring->WriteIndex = AESOFB_BLOCK_SIZE;
+	ring->Filling = 0;
+	ring->Stopped = 0;
+#if HASH_USE_THREADS
+	LIBHASH_MUTEX_INIT(&ring->Lock);
+	LIBHASH_COND_INIT(&ring->Moved);
+#endif
+	Context->Keystream = ring;
+	return 0;
+}
+
+/*
+ *  AesOfbRefill
+ *
+ * Fills the free part of the keystream buffer and returns the number of bytes generated (0 when the buffer is full,
+ * another thread is filling it, or it is not enabled). Never blocks; meant to be called while idle on the thread
+ * that encrypts. A helper thread should loop on AesOfbRefillWait instead.
+ */
+LIBHASH_INLINE_API uint32_t AesOfbRefill(AesOfbContext *Context) {
+	if (Context->Keystream == NULL) return 0;
+	return AesOfbKeystreamFill(&Context->Aes, Context->Keystream, Context->Keystream->Size, 0);
+}
+
+/*
+ *  AesOfbRefillWait
+ *
+ * AesOfbRefill for a helper thread running while another thread calls AesOfbXor on the same context: sleeps until
+ * the buffer has a free block, then fills it. Returns the number of bytes generated, or 0 once AesOfbStopRefill was
+ * called (or if the buffer is not enabled), which is the signal for the helper to exit.
+ */
+LIBHASH_INLINE_API uint32_t AesOfbRefillWait(AesOfbContext *Context) {
+	if (Context->Keystream == NULL) return 0;
+	return AesOfbKeystreamFill(&Context->Aes, Context->Keystream, Context->Keystream->Size, 1);
+}
+
+/*
+ *  AesOfbStopRefill
+ *
+ * Wakes every AesOfbRefillWait sleeping on the context and makes it, and any later call, return 0. The helper must
+ * be joined before AesOfbDisableKeystream.
+ */
+LIBHASH_INLINE_API void AesOfbStopRefill(AesOfbContext *Context) {
+	AesOfbKeystream* ring = Context->Keystream;
+	if (ring == NULL) return;
+	AES_OFB_LOCK(&ring->Lock);
+	ring->Stopped = 1;
+	AES_OFB_WAKE(&ring->Moved);
+	AES_OFB_UNLOCK(&ring->Lock);
+}
+
+/*
+ *  AesOfbDisableKeystream
+ *
+ * Releases the keystream buffer; the stream carries on from the current position without it. No AesOfbRefill or
+ * AesOfbRefillWait may be running on the context.
+ */
+LIBHASH_INLINE_API void AesOfbDisableKeystream(AesOfbContext *Context) {
+	AesOfbKeystream* ring = Context->Keystream;
+	uint64_t block;
+	if (ring == NULL) return;
+	if (ring->ReadIndex < ring->WriteIndex) {
+		block = ring->ReadIndex - ring->ReadIndex % AESOFB_BLOCK_SIZE;
+		memcpy(Context->CurrentCipherBlock, ring->Buffer + block % ring->Size, AESOFB_BLOCK_SIZE);
+	} else {
+		AesEncrypt(&Context->Aes, ring->Chain, Context->CurrentCipherBlock);
+	}
+	Context->IndexWithinCipherBlock = (uint32_t)(ring->ReadIndex % AESOFB_BLOCK_SIZE);
+#if HASH_USE_THREADS
+	LIBHASH_MUTEX_DESTROY(&ring->Lock);
+	LIBHASH_COND_DESTROY(&ring->Moved);
+#endif
+	memset(ring->Buffer, 0, ring->Size);
+	free(ring->Buffer);
+	memset(ring, 0, sizeof(*ring));
+	free(ring);
+	Context->Keystream = NULL;
+}
+
+#undef AES_OFB_LOCK
+#undef AES_OFB_UNLOCK
+#undef AES_OFB_WAIT
+#undef AES_OFB_WAKE
+
+/*
+ *  AesOfbInitialiseShared
+ *
+ * Initialises an AesOfbSharedContext over an already initialised AesContext and
+ * an IV. The key schedule is referenced, not copied.
+ */
+LIBHASH_INLINE_API void AesOfbInitialiseShared(AesOfbSharedContext *Context,const AesContext *InitialisedAesContext,
+					  const uint8_t IV[AESOFB_BLOCK_SIZE]) {
+	Context->Aes = InitialisedAesContext;
+	memcpy(Context->CurrentCipherBlock, IV, sizeof(Context->CurrentCipherBlock));
+	Context->IndexWithinCipherBlock = 0;
+	AesEncryptInPlace(Context->Aes, Context->CurrentCipherBlock);
+}
+
+/*
+ *  AesOfbSharedXor
+ *
+ * AesOfbXor for an AesOfbSharedContext.
+ */
+LIBHASH_INLINE_API void AesOfbSharedXor(AesOfbSharedContext *Context,const void *InBuffer, void *OutBuffer,uint32_t Size) {
+	AesOfbProcess(Context->Aes, Context->CurrentCipherBlock, &Context->IndexWithinCipherBlock,
+		      hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size);
+}
+
+/*
+ *  AesOfbSharedOutput
+ *
+ * AesOfbOutput for an AesOfbSharedContext.
+ */
+LIBHASH_INLINE_API void AesOfbSharedOutput(AesOfbSharedContext *Context, void *Buffer, uint32_t Size) {
+	memset(Buffer, 0, Size);
+	AesOfbSharedXor(Context, Buffer, Buffer, Size);
+}
+
 /*
  *  AesOfbXorWithKey
  *
@@ -0,0 +1,406 @@
+/**
+ * WjCryptLib_AesXts
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __AESXTS_H__
+#define __AESXTS_H__
+
+#include <aes.h>
+#include "threadpool.h"
+
+#define AESXTS_BLOCK_SIZE AES_BLOCK_SIZE
+#define AES_XTS_PIPELINE 8
+
+// Sector batches of at least this many bytes are split across the worker threads (see AesXtsSetParallelThreshold)
+#ifndef AES_XTS_PARALLEL_THRESHOLD
+#define AES_XTS_PARALLEL_THRESHOLD	(1U << 20)
+#endif
+// Smallest run of sectors handed to one thread
+#define AES_XTS_PARALLEL_SEGMENT_MIN	(64U << 10)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	AesContext Data;	// Key1: encrypts and decrypts the data units
+	AesContext Tweak;	// Key2: encrypts the data unit (sector) numbers
+} AesXtsContext;
+
+/*
+ *  AesXtsMultiplyAlpha
+ *
+ * Tweak = Tweak * x in GF(2^128), the tweak being a 128-bit little endian value reduced by x^128 + x^7 + x^2 + x + 1.
+ */
+static inline void AesXtsMultiplyAlpha(uint8_t Tweak[AESXTS_BLOCK_SIZE]) {
+	uint64_t lo = 0, hi = 0, carry;
+	int i;
+	for (i = 7; i >= 0; i--) {
+		lo = (lo << 8) | Tweak[i];
+		hi = (hi << 8) | Tweak[8 + i];
+	}
+	carry = hi >> 63;
+	hi = (hi << 1) | (lo >> 63);
+	lo = (lo << 1) ^ (carry * 0x87);
+	for (i = 0; i < 8; i++) {
+		Tweak[i] = hash_cast(uint8_t, lo >> (8 * i));
+		Tweak[8 + i] = hash_cast(uint8_t, hi >> (8 * i));
+	}
+}
+
+#if HASH_USE_CPU_DISPATCH
+// Tweak * x on both 64-bit halves at once: the top bit of each half is spread into a mask that selects the carry into
+// the high half and the 0x87 reduction of the low half
+#define AES_XTS_NI_NEXT(t)	_mm_xor_si128(_mm_add_epi64(t, t), _mm_and_si128(_mm_srai_epi32(_mm_shuffle_epi32(t, 0x13), 31), poly))
+#define AES_XTS_NI_EACH(OP, x)	b0 = OP(b0, x); b1 = OP(b1, x); b2 = OP(b2, x); b3 = OP(b3, x); \
+				b4 = OP(b4, x); b5 = OP(b5, x); b6 = OP(b6, x); b7 = OP(b7, x)
+#define AES_XTS_NI_LOAD(j)	_mm_xor_si128(_mm_xor_si128(_mm_loadu_si128((const __m128i*)(In + AESXTS_BLOCK_SIZE * (j))), t[j]), k[0])
+#define AES_XTS_NI_STORE(b, j)	_mm_storeu_si128((__m128i*)(Out + AESXTS_BLOCK_SIZE * (j)), _mm_xor_si128(b, t[j]))
+
+/*
+ *  AesXtsCryptBlocksAesNi
+ *
+ * AES-NI XTS over Blocks whole blocks of one data unit. The tweaks of AES_XTS_PIPELINE blocks are derived in registers
+ * and the blocks go through the rounds interleaved. Tweak holds the tweak of the first block and is advanced past
+ * the last one.
+ */
+LIBHASH_TARGET("aes,sse2")
+static void AesXtsCryptBlocksAesNi(const AesContext* Aes, int Decrypt, uint8_t Tweak[AESXTS_BLOCK_SIZE],
+				   const uint8_t* In, uint8_t* Out, size_t Blocks) {
+	const __m128i* rk = (const __m128i*)(Decrypt ? Aes->dK : Aes->eK);
+	const __m128i poly = _mm_set_epi32(0, 1, 0, 0x87);
+	__m128i k[15], t[AES_XTS_PIPELINE], b0, b1, b2, b3, b4, b5, b6, b7;
+	uint_fast32_t nr = Aes->Nr, r;
+	for (r = 0; r <= nr; r++) k[r] = _mm_loadu_si128(rk + r);
+	t[0] = _mm_loadu_si128((const __m128i*)Tweak);
+	for (; Blocks >= AES_XTS_PIPELINE; Blocks -= AES_XTS_PIPELINE) {
+		t[1] = AES_XTS_NI_NEXT(t[0]); t[2] = AES_XTS_NI_NEXT(t[1]); t[3] = AES_XTS_NI_NEXT(t[2]);
+		t[4] = AES_XTS_NI_NEXT(t[3]); t[5] = AES_XTS_NI_NEXT(t[4]); t[6] = AES_XTS_NI_NEXT(t[5]);
+		t[7] = AES_XTS_NI_NEXT(t[6]);
+		b0 = AES_XTS_NI_LOAD(0); b1 = AES_XTS_NI_LOAD(1); b2 = AES_XTS_NI_LOAD(2); b3 = AES_XTS_NI_LOAD(3);
+		b4 = AES_XTS_NI_LOAD(4); b5 = AES_XTS_NI_LOAD(5); b6 = AES_XTS_NI_LOAD(6); b7 = AES_XTS_NI_LOAD(7);
+		if (Decrypt) {
+			for (r = 1; r < nr; r++) {
+				AES_XTS_NI_EACH(_mm_aesdec_si128, k[r]);
+			}
+			AES_XTS_NI_EACH(_mm_aesdeclast_si128, k[nr]);
+		} else {
+			for (r = 1; r < nr; r++) {
+				AES_XTS_NI_EACH(_mm_aesenc_si128, k[r]);
+			}
+			AES_XTS_NI_EACH(_mm_aesenclast_si128, k[nr]);
+		}
+		AES_XTS_NI_STORE(b0, 0); AES_XTS_NI_STORE(b1, 1); AES_XTS_NI_STORE(b2, 2); AES_XTS_NI_STORE(b3, 3);
+		AES_XTS_NI_STORE(b4, 4); AES_XTS_NI_STORE(b5, 5); AES_XTS_NI_STORE(b6, 6); AES_XTS_NI_STORE(b7, 7);
+		t[0] = AES_XTS_NI_NEXT(t[7]);
+		In += AES_XTS_PIPELINE * AESXTS_BLOCK_SIZE;
+		Out += AES_XTS_PIPELINE * AESXTS_BLOCK_SIZE;
+	}
+	for (; Blocks; Blocks--) {
+		b0 = AES_XTS_NI_LOAD(0);
+		if (Decrypt) {
+			for (r = 1; r < nr; r++) b0 = _mm_aesdec_si128(b0, k[r]);
+			b0 = _mm_aesdeclast_si128(b0, k[nr]);
+		} else {
+			for (r = 1; r < nr; r++) b0 = _mm_aesenc_si128(b0, k[r]);
+			b0 = _mm_aesenclast_si128(b0, k[nr]);
+		}
+		AES_XTS_NI_STORE(b0, 0);
+		t[0] = AES_XTS_NI_NEXT(t[0]);
+		In += AESXTS_BLOCK_SIZE;
+		Out += AESXTS_BLOCK_SIZE;
+	}
+	_mm_storeu_si128((__m128i*)Tweak, t[0]);
+}
+
+#undef AES_XTS_NI_NEXT
+#undef AES_XTS_NI_EACH
+#undef AES_XTS_NI_LOAD
+#undef AES_XTS_NI_STORE
+#endif
+
+/*
+ *  AesXtsCryptBlocks
+ *
+ * Encrypts (Decrypt == 0) or decrypts Blocks whole blocks of one data unit, advancing Tweak past them. The portable
+ * path lays out the tweaks of AES_XTS_PIPELINE blocks and applies them word-wide around the block cipher, which also
+ * keeps in-place buffers correct.
+ */
+static inline void AesXtsCryptBlocks(const AesContext* Aes, int Decrypt, uint8_t Tweak[AESXTS_BLOCK_SIZE],
+				     const uint8_t* In, uint8_t* Out, size_t Blocks) {
+	uint8_t tweaks[AES_XTS_PIPELINE * AESXTS_BLOCK_SIZE], buffer[AES_XTS_PIPELINE * AESXTS_BLOCK_SIZE];
+	uint32_t n, j;
+#if HASH_USE_CPU_DISPATCH
+	if (Aes->Flags & AES_CONTEXT_AESNI) {
+		AesXtsCryptBlocksAesNi(Aes, Decrypt, Tweak, In, Out, Blocks);
+		return;
+	}
+#endif
+	while (Blocks) {
+		n = (Blocks < AES_XTS_PIPELINE) ? (uint32_t)Blocks : AES_XTS_PIPELINE;
+		for (j = 0; j < n; j++) {
+			memcpy(tweaks + AESXTS_BLOCK_SIZE * j, Tweak, AESXTS_BLOCK_SIZE);
+			AesXtsMultiplyAlpha(Tweak);
+		}
+		XorBuffers(In, tweaks, buffer, n * AESXTS_BLOCK_SIZE);
+		if (Decrypt) AesDecryptBlocks(Aes, buffer, buffer, n);
+		else AesEncryptBlocks(Aes, buffer, buffer, n);
+		XorBuffers(buffer, tweaks, Out, n * AESXTS_BLOCK_SIZE);
+		In += n * AESXTS_BLOCK_SIZE;
+		Out += n * AESXTS_BLOCK_SIZE;
+		Blocks -= n;
+	}
+}
+
+/*
+ *  AesXtsSectorTweak
+ *
+ * Writes the data unit number Sector as the 128-bit little endian block that Key2 encrypts into the initial tweak.
+ */
+static inline void AesXtsSectorTweak(uint64_t Sector, uint8_t Tweak[AESXTS_BLOCK_SIZE]) {
+	int i;
+	for (i = 0; i < 8; i++) Tweak[i] = hash_cast(uint8_t, Sector >> (8 * i));
+	memset(Tweak + 8, 0, 8);
+}
+
+/*
+ *  AesXtsCryptSectorTweak
+ *
+ * XTS over one data unit of Size (>= 16) bytes whose initial tweak (the encrypted sector number) is already in Tweak,
+ * which is used as scratch. A trailing partial block is handled with ciphertext stealing as in IEEE 1619: the last two
+ * blocks swap tweaks and the partial block borrows the tail of the block before it.
+ */
+static inline void AesXtsCryptSectorTweak(const AesXtsContext* Context, uint8_t Tweak[AESXTS_BLOCK_SIZE],
+					  const uint8_t* In, uint8_t* Out, uint32_t Size, int Decrypt) {
+	uint8_t previous[AESXTS_BLOCK_SIZE], full[AESXTS_BLOCK_SIZE], stolen[AESXTS_BLOCK_SIZE];
+	uint32_t blocks = Size / AESXTS_BLOCK_SIZE, rest = Size % AESXTS_BLOCK_SIZE;
+	if (rest == 0) {
+		AesXtsCryptBlocks(&Context->Data, Decrypt, Tweak, In, Out, blocks);
+		return;
+	}
+	AesXtsCryptBlocks(&Context->Data, Decrypt, Tweak, In, Out, blocks - 1);
+	In += (blocks - 1) * AESXTS_BLOCK_SIZE;
+	Out += (blocks - 1) * AESXTS_BLOCK_SIZE;
+	if (Decrypt) {
+		memcpy(previous, Tweak, AESXTS_BLOCK_SIZE);
+		AesXtsMultiplyAlpha(Tweak);
+		AesXtsCryptBlocks(&Context->Data, 1, Tweak, In, full, 1);
+		memcpy(Tweak, previous, AESXTS_BLOCK_SIZE);
+	} else {
+		AesXtsCryptBlocks(&Context->Data, 0, Tweak, In, full, 1);
+	}
+	memcpy(stolen, In + AESXTS_BLOCK_SIZE, rest);
+	memcpy(stolen + rest, full + rest, AESXTS_BLOCK_SIZE - rest);
+	memcpy(Out + AESXTS_BLOCK_SIZE, full, rest);
+	AesXtsCryptBlocks(&Context->Data, Decrypt, Tweak, stolen, Out, 1);
+}
+
+/*
+ *  AesXtsCryptSector
+ *
+ * XTS over one data unit of Size (>= 16) bytes with sequence number Sector.
+ */
+static inline void AesXtsCryptSector(const AesXtsContext* Context, uint64_t Sector, const uint8_t* In, uint8_t* Out,
+				     uint32_t Size, int Decrypt) {
+	uint8_t tweak[AESXTS_BLOCK_SIZE];
+	AesXtsSectorTweak(Sector, tweak);
+	AesEncryptInPlace(&Context->Tweak, tweak);
+	AesXtsCryptSectorTweak(Context, tweak, In, Out, Size, Decrypt);
+}
+
+/*
+ *  AesXtsInitialise
+ *
+ * Initialises an AesXtsContext with two already initialised AesContexts: the
+ * data key (Key1) and the tweak key (Key2). The data key gets its decryption
+ * schedule derived if it was initialised encrypt-only.
+ */
+LIBHASH_INLINE_API void AesXtsInitialise(AesXtsContext *Context,const AesContext *DataKey,const AesContext *TweakKey) {
+	Context->Data = *DataKey;
+	Context->Tweak = *TweakKey;
+	AesExpandDecryptKey(&Context->Data);
+}
+
+/*
+ *  AesXtsInitialiseWithKey
+ *
+ * Initialises an AesXtsContext with an XTS key: Key1 followed by Key2, both of
+ * the same AES size. KeySize must be 32, 48, or 64 (for XTS-AES-128, -192, or
+ * -256) Returns 0 if successful, or -1 if invalid KeySize provided
+ */
+LIBHASH_INLINE_API int AesXtsInitialiseWithKey(AesXtsContext *Context,const uint8_t *Key,uint32_t KeySize) {
+	if (KeySize % 2 != 0) return -1;
+	if (AesInitialise(&Context->Data, Key, KeySize / 2) != 0) return -1;
+	return AesInitialiseEncryptOnly(&Context->Tweak, Key + KeySize / 2, KeySize / 2);
+}
+
+/*
+ *  AesXtsEncryptSector
+ *
+ * Encrypts one data unit (sector) of Size bytes with sequence number Sector.
+ * Size need not be a multiple of 16; the last partial block is handled with
+ * ciphertext stealing. InBuffer and OutBuffer can point to the same location.
+ * Returns 0 if successful, or -1 if Size is less than 16
+ */
+LIBHASH_INLINE_API int AesXtsEncryptSector(const AesXtsContext *Context,uint64_t Sector,const void *InBuffer,
+				      void *OutBuffer,uint32_t Size) {
+	if (Size < AESXTS_BLOCK_SIZE) return -1;
+	AesXtsCryptSector(Context, Sector, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size, 0);
+	return 0;
+}
+
+/*
+ *  AesXtsDecryptSector
+ *
+ * Decrypts one data unit (sector) encrypted with AesXtsEncryptSector. Returns
+ * 0 if successful, or -1 if Size is less than 16
+ */
+LIBHASH_INLINE_API int AesXtsDecryptSector(const AesXtsContext *Context,uint64_t Sector,const void *InBuffer,
+				      void *OutBuffer,uint32_t Size) {
+	if (Size < AESXTS_BLOCK_SIZE) return -1;
+	AesXtsCryptSector(Context, Sector, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer), Size, 1);
+	return 0;
+}
+
+static size_t AesXtsParallelThreshold = AES_XTS_PARALLEL_THRESHOLD;
+
+/*
+ *  AesXtsSetParallelThreshold
+ *
+ * Sets the batch size in bytes from which AesXtsEncryptSectors and AesXtsDecryptSectors split the sectors into runs
+ * processed on the worker thread pool. 0 keeps every call on the calling thread. The default is
+ * AES_XTS_PARALLEL_THRESHOLD. Safe to change while other threads process sectors; a batch already under way uses
+ * the value it read when it started.
+ */
+LIBHASH_INLINE_API void AesXtsSetParallelThreshold(size_t Bytes) {
+	LIBHASH_ATOMIC_STORE(&AesXtsParallelThreshold, Bytes);
+}
+
+typedef struct {
+	const AesXtsContext* Context;
+	uint64_t FirstSector;
+	uint32_t SectorSize;
+	const uint8_t* In;
+	uint8_t* Out;
+	size_t Sectors;
+	size_t Segment;
+	int Decrypt;
+} AesXtsJob;
+
+/*
+ *  AesXtsCryptSectors
+ *
+ * XTS over Sectors consecutive data units. The initial tweaks of AES_XTS_PIPELINE sectors are encrypted together with
+ * AesEncryptBlocks before the sectors themselves are processed.
+ */
+static inline void AesXtsCryptSectors(const AesXtsContext* Context, uint64_t FirstSector, uint32_t SectorSize,
+				      const uint8_t* In, uint8_t* Out, size_t Sectors, int Decrypt) {
+	uint8_t tweaks[AES_XTS_PIPELINE * AESXTS_BLOCK_SIZE];
+	uint32_t n, j;
+	while (Sectors) {
+		n = (Sectors < AES_XTS_PIPELINE) ? (uint32_t)Sectors : AES_XTS_PIPELINE;
+		for (j = 0; j < n; j++) AesXtsSectorTweak(FirstSector + j, tweaks + AESXTS_BLOCK_SIZE * j);
+		AesEncryptBlocks(&Context->Tweak, tweaks, tweaks, n);
+		for (j = 0; j < n; j++, In += SectorSize, Out += SectorSize)
+			AesXtsCryptSectorTweak(Context, tweaks + AESXTS_BLOCK_SIZE * j, In, Out, SectorSize, Decrypt);
+		FirstSector += n;
+		Sectors -= n;
+	}
+}
+
+/*
+ *  AesXtsSegment
+ *
+ * Pool task: runs sectors [Index * Segment, (Index + 1) * Segment) of the job. Sectors are independent, so no state
+ * is shared between the tasks.
+ */
+static void AesXtsSegment(void* Arg, uint32_t Index) {
+	const AesXtsJob* job = (const AesXtsJob*)Arg;
+	size_t first = (size_t)Index * job->Segment;
+	size_t count = (job->Sectors - first < job->Segment) ? job->Sectors - first : job->Segment;
+	size_t offset = first * job->SectorSize;
+	AesXtsCryptSectors(job->Context, job->FirstSector + first, job->SectorSize, job->In + offset, job->Out + offset,
+			   count, job->Decrypt);
+}
+
+/*
+ *  AesXtsRun
+ *
+ * AesXtsCryptSectors, split across the thread pool in runs of whole sectors when the batch reaches the parallel
+ * threshold.
+ */
+static inline void AesXtsRun(const AesXtsContext* Context, uint64_t FirstSector, uint32_t SectorSize,
+			     const uint8_t* In, uint8_t* Out, size_t Sectors, int Decrypt) {
+	size_t threshold = LIBHASH_ATOMIC_LOAD(&AesXtsParallelThreshold), bytes = Sectors * SectorSize, segments;
+	uint32_t threads;
+	AesXtsJob job;
+	if (threshold && bytes >= threshold && bytes >= 2 * AES_XTS_PARALLEL_SEGMENT_MIN && Sectors > 1 &&
+	    (threads = libhash_pool_threads()) > 1) {
+		segments = bytes / AES_XTS_PARALLEL_SEGMENT_MIN;
+		if (segments > threads) segments = threads;
+		if (segments > Sectors) segments = Sectors;
+		job.Context = Context;
+		job.FirstSector = FirstSector;
+		job.SectorSize = SectorSize;
+		job.In = In;
+		job.Out = Out;
+		job.Sectors = Sectors;
+		job.Segment = (Sectors + segments - 1) / segments;
+		job.Decrypt = Decrypt;
+		libhash_pool_run(AesXtsSegment, &job, (uint32_t)((Sectors + job.Segment - 1) / job.Segment));
+		return;
+	}
+	AesXtsCryptSectors(Context, FirstSector, SectorSize, In, Out, Sectors, Decrypt);
+}
+
+/*
+ *  AesXtsEncryptSectors
+ *
+ * Encrypts Sectors consecutive data units of SectorSize bytes each, numbered
+ * from FirstSector, laid out back to back in InBuffer. Large batches are split
+ * across the worker thread pool. InBuffer and OutBuffer can point to the same
+ * location. Returns 0 if successful, or -1 if SectorSize is less than 16
+ */
+LIBHASH_INLINE_API int AesXtsEncryptSectors(const AesXtsContext *Context,uint64_t FirstSector,uint32_t SectorSize,
+				       const void *InBuffer,void *OutBuffer,size_t Sectors) {
+	if (SectorSize < AESXTS_BLOCK_SIZE) return -1;
+	AesXtsRun(Context, FirstSector, SectorSize, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer),
+		  Sectors, 0);
+	return 0;
+}
+
+/*
+ *  AesXtsDecryptSectors
+ *
+ * Decrypts Sectors consecutive data units encrypted with AesXtsEncryptSectors
+ * or AesXtsEncryptSector. Returns 0 if successful, or -1 if SectorSize is less
+ * than 16
+ */
+LIBHASH_INLINE_API int AesXtsDecryptSectors(const AesXtsContext *Context,uint64_t FirstSector,uint32_t SectorSize,
+				       const void *InBuffer,void *OutBuffer,size_t Sectors) {
+	if (SectorSize < AESXTS_BLOCK_SIZE) return -1;
+	AesXtsRun(Context, FirstSector, SectorSize, hash_c_cast(const uint8_t*,InBuffer), uhash_cast(uint8_t*,OutBuffer),
+		  Sectors, 1);
+	return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AESXTS_H__ */
@@ -0,0 +1,163 @@
+/**
+ * WjCryptLib_CpuFeatures
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CPUFEATURES_H__
+#define __CPUFEATURES_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// Runtime CPU dispatch
+//
+// User can define HASH_USE_CPU_DISPATCH to 0 before including any header to
+// build the portable code only. When enabled, accelerated backends are compiled
+// with per-function target attributes and selected at runtime through cpuid, so
+// the library itself never needs -msse4/-mavx2/... compiler flags.
+// -----------------------------------------------------------------------------
+
+#ifndef HASH_USE_CPU_DISPATCH
+# if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && \
+	((defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__) || defined(_MSC_VER))
+#  define HASH_USE_CPU_DISPATCH 1
+# else
+#  define HASH_USE_CPU_DISPATCH 0
+# endif
+#endif
+
+#define HASH_CPU_SSE2		(1U << 0)
+#define HASH_CPU_SSSE3		(1U << 1)
+#define HASH_CPU_SSE41		(1U << 2)
+#define HASH_CPU_SSE42		(1U << 3)
+#define HASH_CPU_AVX		(1U << 4)
+#define HASH_CPU_AVX2		(1U << 5)
+#define HASH_CPU_AVX512F	(1U << 6)
+#define HASH_CPU_SHA		(1U << 7)
+#define HASH_CPU_AESNI		(1U << 8)
+#define HASH_CPU_PCLMUL		(1U << 9)
+#define HASH_CPU_BMI2		(1U << 10)
+#define HASH_CPU_DETECTED	(1U << 31)
+
+#if HASH_USE_CPU_DISPATCH
+# if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#  define LIBHASH_TARGET(x)
+#  define LIBHASH_FORCE_INLINE __forceinline
+# else
+#  include <cpuid.h>
+#  define LIBHASH_TARGET(x) __attribute__ ((target (x)))
+#  define LIBHASH_FORCE_INLINE inline __attribute__ ((always_inline))
+# endif
+# include <immintrin.h>
+#endif
+
+// Helpers shared by a portable and an accelerated backend are forced inline so they get compiled for the caller's target
+#ifndef LIBHASH_FORCE_INLINE
+# define LIBHASH_FORCE_INLINE inline
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if HASH_USE_CPU_DISPATCH
+static inline void libhash_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	int r[4];
+	__cpuidex(r, (int)leaf, (int)subleaf);
+	regs[0] = (uint32_t)r[0]; regs[1] = (uint32_t)r[1];
+	regs[2] = (uint32_t)r[2]; regs[3] = (uint32_t)r[3];
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static inline uint64_t libhash_xgetbv(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	return (uint64_t)_xgetbv(0);
+#else
+	uint32_t eax, edx;
+	__asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+	return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+/*
+ * libhash_cpu_detect
+ *
+ * Queries cpuid (and XCR0 for the AVX register states) and returns the HASH_CPU_* flags supported by this CPU and
+ * operating system. The environment variable LIBHASH_CPUMASK (hex) can be used to mask features off, e.g. to run the
+ * test-suite against the portable fallbacks on a machine that has the extensions.
+ */
+static inline uint32_t libhash_cpu_detect(void) {
+	uint32_t regs[4], maxLeaf, features = 0;
+	uint64_t xcr0 = 0;
+	const char* mask;
+
+	libhash_cpuid(0, 0, regs);
+	maxLeaf = regs[0];
+	if (maxLeaf < 1) return 0;
+
+	libhash_cpuid(1, 0, regs);
+	if (regs[3] & (1U << 26)) features |= HASH_CPU_SSE2;
+	if (regs[2] & (1U << 9))  features |= HASH_CPU_SSSE3;
+	if (regs[2] & (1U << 19)) features |= HASH_CPU_SSE41;
+	if (regs[2] & (1U << 20)) features |= HASH_CPU_SSE42;
+	if (regs[2] & (1U << 25)) features |= HASH_CPU_AESNI;
+	if (regs[2] & (1U << 1))  features |= HASH_CPU_PCLMUL;
+	if ((regs[2] & (1U << 27)) && (regs[2] & (1U << 28))) {
+		xcr0 = libhash_xgetbv();
+		if ((xcr0 & 0x06) == 0x06) features |= HASH_CPU_AVX;
+	}
+
+	if (maxLeaf >= 7) {
+		libhash_cpuid(7, 0, regs);
+		if (regs[1] & (1U << 29)) features |= HASH_CPU_SHA;
+		if (regs[1] & (1U << 8))  features |= HASH_CPU_BMI2;
+		if ((features & HASH_CPU_AVX) && (regs[1] & (1U << 5))) features |= HASH_CPU_AVX2;
+		if ((features & HASH_CPU_AVX2) && (regs[1] & (1U << 16)) && (xcr0 & 0xE6) == 0xE6)
+			features |= HASH_CPU_AVX512F;
+	}
+
+	if ((mask = getenv("LIBHASH_CPUMASK")) != NULL) features &= (uint32_t)strtoul(mask, NULL, 16);
+	return features;
+}
+#endif
+
+/*
+ * libhash_cpu_features
+ *
+ * Returns the HASH_CPU_* flags of the running CPU. Detection runs once and is cached; concurrent first calls are
+ * harmless since every caller stores the same value.
+ */
+static inline uint32_t libhash_cpu_features(void) {
+#if HASH_USE_CPU_DISPATCH
+	static volatile uint32_t features = 0;
+	if (features == 0) features = libhash_cpu_detect() | HASH_CPU_DETECTED;
+	return features;
+#else
+	return HASH_CPU_DETECTED;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CPUFEATURES_H__ */
@@ -24,6 +24,9 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "cpufeatures.h"
+#include "threadpool.h"
+
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
 #define inline __inline
 #endif
@@ -130,6 +133,410 @@ LIBHASH_INLINE_API uint32_t ccrc32(uint32_t crc, const void *data,size_t len,con
     return crc;
 }
 
+/*
+ * GF(2) polynomial arithmetic modulo a reflected polynomial: bit 31 is x^0, bit 0 is x^31. A CRC register
+ * followed by n zero bytes becomes crc32_multmodp(crc32_x8nmodp(n, poly), crc, poly).
+ */
+static inline uint32_t crc32_multmodp(uint32_t a, uint32_t b, uint32_t poly) {
+    uint32_t m = 1U << 31, p = 0;
+    for (;;) {
+	if (a & m) {
+	    p ^= b;
+	    if ((a & (m - 1)) == 0) break;
+	}
+	m >>= 1;
+	b = (b >> 1) ^ (poly & (0U - (b & 1U)));
+    }
+    return p;
+}
+
+// x^(8n) modulo poly, by squaring x^8
+static inline uint32_t crc32_x8nmodp(uint64_t n, uint32_t poly) {
+    uint32_t p = 1U << 31, x2k = 1U << 23;
+    for (; n; n >>= 1) {
+	if (n & 1) p = crc32_multmodp(x2k, p, poly);
+	x2k = crc32_multmodp(x2k, x2k, poly);
+    }
+    return p;
+}
+
+/*
+ * Lookup tables of the seven reflected variants, shared by every caller. Each is built on first use under
+ * LIBHASH_ONCE, so concurrent first calls are safe and later calls only check the once flag.
+ *
+ * Slice[0] is the byte-wise table; Slice[k][i] is the CRC of byte i followed by k zero bytes. Slicing-by-N
+ * XORs one lookup per input byte into the new CRC, so the N lookups of a step are independent instead of
+ * chained through crc.
+ */
+#define CRC32_SLICES		16
+// Buffers from this size use slicing-by-16, shorter ones slicing-by-8 (raise it where 16 KB of tables crowd the L1)
+#ifndef CRC32_SLICE16_THRESHOLD
+#define CRC32_SLICE16_THRESHOLD	16
+#endif
+
+typedef struct {
+    uint32_t Poly;
+    uint32_t Slice[CRC32_SLICES][256];
+    uint64_t Fold[7];		// carry-less multiply constants, see crc32_fold_constants
+    uint32_t Power[64];		// x^(8*2^k) modulo the polynomial, to shift a CRC past any number of bytes
+} crc32_tables;
+
+static inline uint64_t crc32_reverse_bits(uint64_t v, int bits) {
+    uint64_t r = 0;
+    for (; bits; --bits, v >>= 1) r = (r << 1) | (v & 1);
+    return r;
+}
+
+/*
+ * Constants of the PCLMULQDQ folding for a reflected polynomial (Gopal et al., "Fast CRC Computation for Generic
+ * Polynomials Using PCLMULQDQ Instruction"). Each fold constant is x^N mod P bit-reflected and shifted left by one,
+ * which is crc32_x8nmodp(N / 8) << 1 in this file's representation:
+ *   Fold[0], Fold[1]	N = 4*128+32, 4*128-32	four 128-bit lanes forward by 64 bytes
+ *   Fold[2], Fold[3]	N = 128+32, 128-32	one lane forward by 16 bytes
+ *   Fold[4]		N = 64			128 to 64 bits
+ *   Fold[5], Fold[6]	P' and u' = floor(x^64 / P), both reflected over 33 bits, for the Barrett reduction
+ */
+static inline void crc32_fold_constants(uint64_t fold[7], uint32_t poly) {
+    uint64_t p = (1ULL << 32) | crc32_reverse_bits(poly, 32), rem = p << 32, q = 1ULL << 32;
+    int i;
+    fold[0] = hash_cast(uint64_t, crc32_x8nmodp(68, poly)) << 1;
+    fold[1] = hash_cast(uint64_t, crc32_x8nmodp(60, poly)) << 1;
+    fold[2] = hash_cast(uint64_t, crc32_x8nmodp(20, poly)) << 1;
+    fold[3] = hash_cast(uint64_t, crc32_x8nmodp(12, poly)) << 1;
+    fold[4] = hash_cast(uint64_t, crc32_x8nmodp(8, poly)) << 1;
+    fold[5] = (hash_cast(uint64_t, poly) << 1) | 1;
+    // x^64 / P by long division; the first step (x^64 - x^32 P) has already been applied to rem
+    for (i = 63; i >= 32; --i)
+	if ((rem >> i) & 1) {
+	    q |= 1ULL << (i - 32);
+	    rem ^= p << (i - 32);
+	}
+    fold[6] = crc32_reverse_bits(q, 33);
+}
+
+static inline void crc32_tables_build(crc32_tables* tables, uint32_t poly) {
+    uint32_t i, k;
+    tables->Poly = poly;
+    crc32_reflected_table(tables->Slice[0], poly);
+    for (k = 1; k < CRC32_SLICES; ++k)
+	for (i = 0; i < 256; ++i)
+	    tables->Slice[k][i] = (tables->Slice[k - 1][i] >> 8) ^ tables->Slice[0][tables->Slice[k - 1][i] & 0xFFU];
+    crc32_fold_constants(tables->Fold, poly);
+    tables->Power[0] = 1U << 23;
+    for (k = 1; k < 64; ++k)
+	tables->Power[k] = crc32_multmodp(tables->Power[k - 1], tables->Power[k - 1], poly);
+}
+
+// crc32_x8nmodp with the powers of the shared tables
+static inline uint32_t crc32_tables_x8n(const crc32_tables* tables, uint64_t n) {
+    uint32_t p = 1U << 31;
+    int k;
+    for (k = 0; n; n >>= 1, ++k)
+	if (n & 1) p = crc32_multmodp(tables->Power[k], p, tables->Poly);
+    return p;
+}
+
+static inline uint32_t crc32_load_le(const uint8_t* p) {
+    return hash_cast(uint32_t,p[0]) | (hash_cast(uint32_t,p[1]) << 8) | (hash_cast(uint32_t,p[2]) << 16) |
+	   (hash_cast(uint32_t,p[3]) << 24);
+}
+
+#define CRC32_SLICE4(t, w, k) \
+	((t)[(k) + 3][(w) & 0xFFU] ^ (t)[(k) + 2][((w) >> 8) & 0xFFU] ^ (t)[(k) + 1][((w) >> 16) & 0xFFU] ^ (t)[k][(w) >> 24])
+
+static inline uint32_t crc32_slice8(const uint32_t (*t)[256], uint32_t crc, const uint8_t* p, size_t len) {
+    for (; len >= 8; p += 8, len -= 8) {
+	uint32_t a = crc32_load_le(p) ^ crc, b = crc32_load_le(p + 4);
+	crc = CRC32_SLICE4(t, a, 4) ^ CRC32_SLICE4(t, b, 0);
+    }
+    while (len--)
+	crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFFU];
+    return crc;
+}
+
+static inline uint32_t crc32_slice16(const uint32_t (*t)[256], uint32_t crc, const uint8_t* p, size_t len) {
+    for (; len >= 16; p += 16, len -= 16) {
+	uint32_t a = crc32_load_le(p) ^ crc, b = crc32_load_le(p + 4), c = crc32_load_le(p + 8), d = crc32_load_le(p + 12);
+	crc = CRC32_SLICE4(t, a, 12) ^ CRC32_SLICE4(t, b, 8) ^ CRC32_SLICE4(t, c, 4) ^ CRC32_SLICE4(t, d, 0);
+    }
+    return crc32_slice8(t, crc, p, len);
+}
+
+#undef CRC32_SLICE4
+
+#if HASH_USE_CPU_DISPATCH
+/*
+ * CRC-32C with the SSE4.2 crc32 instruction. One crc32 has a latency of 3 cycles but a throughput of 1, so
+ * the buffer is taken in runs of three equal blocks checksummed as independent streams. The first stream's
+ * CRC is then moved past the other two blocks with a table driven multiply by x^(8*block) and XORed in.
+ * Runs use CRC32C_HW_LONG byte blocks while they fit, then CRC32C_HW_SHORT, then a single stream.
+ */
+#define CRC32C_HW_LONG	8192
+#define CRC32C_HW_SHORT	256
+
+typedef struct {
+    uint32_t Long[4][256];	// register followed by CRC32C_HW_LONG zero bytes, one table per register byte
+    uint32_t Short[4][256];	// the same for CRC32C_HW_SHORT
+} crc32c_hw_tables;
+
+static crc32c_hw_tables crc32c_hw;
+
+static void crc32c_hw_build(void) {
+    uint32_t lop = crc32_x8nmodp(CRC32C_HW_LONG, CRC32C_POLY_REFLECTED);
+    uint32_t sop = crc32_x8nmodp(CRC32C_HW_SHORT, CRC32C_POLY_REFLECTED);
+    uint32_t i, k;
+    for (k = 0; k < 4; ++k)
+	for (i = 0; i < 256; ++i) {
+	    crc32c_hw.Long[k][i] = crc32_multmodp(lop, i << (8 * k), CRC32C_POLY_REFLECTED);
+	    crc32c_hw.Short[k][i] = crc32_multmodp(sop, i << (8 * k), CRC32C_POLY_REFLECTED);
+	}
+}
+
+static inline uint32_t crc32c_hw_shift(const uint32_t (*zeros)[256], uint32_t crc) {
+    return zeros[0][crc & 0xFFU] ^ zeros[1][(crc >> 8) & 0xFFU] ^ zeros[2][(crc >> 16) & 0xFFU] ^ zeros[3][crc >> 24];
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+typedef uint64_t crc32c_hw_word;
+#define CRC32C_HW_STEP(c, p)	((c) = _mm_crc32_u64((c), crc32c_hw_load(p)))
+#else
+typedef uint32_t crc32c_hw_word;
+#define CRC32C_HW_STEP(c, p)	((c) = _mm_crc32_u32((c), crc32c_hw_load(p)))
+#endif
+
+static LIBHASH_FORCE_INLINE crc32c_hw_word crc32c_hw_load(const uint8_t* p) {
+    crc32c_hw_word w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+// The streams stay in full-width registers inside a run, the upper half of a 64-bit crc32 result is always zero
+#define CRC32C_HW_RUNS(block, zeros) \
+    while (len >= 3 * (block)) { \
+	const uint8_t *end = p + (block); \
+	crc32c_hw_word crc0 = crc, crc1 = 0, crc2 = 0; \
+	do { \
+	    CRC32C_HW_STEP(crc0, p); \
+	    CRC32C_HW_STEP(crc1, p + (block)); \
+	    CRC32C_HW_STEP(crc2, p + 2 * (block)); \
+	    p += sizeof(crc32c_hw_word); \
+	} while (p < end); \
+	crc = crc32c_hw_shift((zeros), hash_c_cast(uint32_t, crc0)) ^ hash_c_cast(uint32_t, crc1); \
+	crc = crc32c_hw_shift((zeros), crc) ^ hash_c_cast(uint32_t, crc2); \
+	p += 2 * (block); \
+	len -= 3 * (block); \
+    }
+
+LIBHASH_TARGET("sse4.2")
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* p, size_t len) {
+    static libhash_once_t once = LIBHASH_ONCE_INIT;
+    for (; len && (hash_c_cast(uintptr_t, p) & (sizeof(crc32c_hw_word) - 1)); --len)
+	crc = _mm_crc32_u8(crc, *p++);
+    if (len >= 3 * CRC32C_HW_SHORT) {
+	LIBHASH_ONCE(&once, crc32c_hw_build);
+	CRC32C_HW_RUNS(CRC32C_HW_LONG, crc32c_hw.Long)
+	CRC32C_HW_RUNS(CRC32C_HW_SHORT, crc32c_hw.Short)
+    }
+    {
+	crc32c_hw_word crc0 = crc;
+	for (; len >= sizeof(crc32c_hw_word); p += sizeof(crc32c_hw_word), len -= sizeof(crc32c_hw_word))
+	    CRC32C_HW_STEP(crc0, p);
+	crc = hash_c_cast(uint32_t, crc0);
+    }
+    while (len--)
+	crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+#undef CRC32C_HW_RUNS
+#undef CRC32C_HW_STEP
+
+/*
+ * Folding with PCLMULQDQ for any reflected polynomial. Four 128-bit lanes are carried forward over 64 bytes per
+ * step (two carry-less multiplies each, against the polynomial's constants) and XORed with the next data, then
+ * folded into one lane, reduced to 64 bits and finished with a Barrett reduction. Len must be a multiple of 16
+ * and at least 64; the result is the CRC register, like every other kernel here.
+ */
+// Buffers from this size (64 at least) use the folding kernel when the CPU has PCLMULQDQ
+#ifndef CRC32_FOLD_THRESHOLD
+#define CRC32_FOLD_THRESHOLD	64
+#endif
+
+#define CRC32_FOLD(x, k, next) \
+	x = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), (next))
+
+LIBHASH_TARGET("pclmul,sse2")
+static uint32_t crc32_fold_pclmul(const uint64_t fold[7], uint32_t crc, const uint8_t* p, size_t len) {
+    const __m128i mask32 = _mm_setr_epi32(-1, 0, 0, 0);
+    __m128i x0, x1, x2, x3, k, t;
+    x0 = _mm_xor_si128(_mm_loadu_si128(hash_c_cast(const __m128i*, p)), _mm_cvtsi32_si128(hash_cast(int, crc)));
+    x1 = _mm_loadu_si128(hash_c_cast(const __m128i*, p + 16));
+    x2 = _mm_loadu_si128(hash_c_cast(const __m128i*, p + 32));
+    x3 = _mm_loadu_si128(hash_c_cast(const __m128i*, p + 48));
+    k = _mm_set_epi64x(hash_cast(long long, fold[1]), hash_cast(long long, fold[0]));
+    for (p += 64, len -= 64; len >= 64; p += 64, len -= 64) {
+	CRC32_FOLD(x0, k, _mm_loadu_si128(hash_c_cast(const __m128i*, p)));
+	CRC32_FOLD(x1, k, _mm_loadu_si128(hash_c_cast(const __m128i*, p + 16)));
+	CRC32_FOLD(x2, k, _mm_loadu_si128(hash_c_cast(const __m128i*, p + 32)));
+	CRC32_FOLD(x3, k, _mm_loadu_si128(hash_c_cast(const __m128i*, p + 48)));
+    }
+    k = _mm_set_epi64x(hash_cast(long long, fold[3]), hash_cast(long long, fold[2]));
+    CRC32_FOLD(x0, k, x1);
+    CRC32_FOLD(x0, k, x2);
+    CRC32_FOLD(x0, k, x3);
+    for (; len >= 16; p += 16, len -= 16)
+	CRC32_FOLD(x0, k, _mm_loadu_si128(hash_c_cast(const __m128i*, p)));
+    // 128 to 64 bits (this also appends the 32 zero bits the CRC definition implies), then 64 to 32 with Barrett
+    x0 = _mm_xor_si128(_mm_clmulepi64_si128(k, x0, 0x01), _mm_srli_si128(x0, 8));
+    t = _mm_clmulepi64_si128(_mm_and_si128(x0, mask32), _mm_set_epi64x(0, hash_cast(long long, fold[4])), 0x00);
+    x0 = _mm_xor_si128(_mm_srli_si128(x0, 4), t);
+    k = _mm_set_epi64x(hash_cast(long long, fold[6]), hash_cast(long long, fold[5]));
+    t = _mm_clmulepi64_si128(_mm_and_si128(x0, mask32), k, 0x10);
+    t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), k, 0x00);
+    x0 = _mm_xor_si128(x0, t);
+    return hash_cast(uint32_t, _mm_cvtsi128_si32(_mm_srli_si128(x0, 4)));
+}
+
+#undef CRC32_FOLD
+#endif
+
+#define CRC32_SHARED_TABLES(name, poly_reflected) \
+static crc32_tables crc32_tables_##name; \
+static void crc32_tables_##name##_build(void) { \
+    crc32_tables_build(&crc32_tables_##name, (poly_reflected)); \
+} \
+static inline const crc32_tables* crc32_tables_##name##_get(void) { \
+    static libhash_once_t once = LIBHASH_ONCE_INIT; \
+    LIBHASH_ONCE(&once, crc32_tables_##name##_build); \
+    return &crc32_tables_##name; \
+}
+
+CRC32_SHARED_TABLES(ieee,CRC32_POLY_REFLECTED)
+CRC32_SHARED_TABLES(c,CRC32C_POLY_REFLECTED)
+CRC32_SHARED_TABLES(k,CRC32K_POLY_REFLECTED)
+CRC32_SHARED_TABLES(q,CRC32Q_POLY_REFLECTED)
+CRC32_SHARED_TABLES(d,CRC32D_POLY_REFLECTED)
+CRC32_SHARED_TABLES(xfer,CRC32_XFER_POLY_REFLECTED)
+CRC32_SHARED_TABLES(autosar,CRC32_AUTOSAR_POLY_REFLECTED)
+
+#undef CRC32_SHARED_TABLES
+
+// Shared tables of a reflected polynomial, or NULL if it is not one of the seven variants
+static inline const crc32_tables* crc32_tables_get(uint32_t poly_reflected) {
+    switch (poly_reflected) {
+    case CRC32_POLY_REFLECTED:		return crc32_tables_ieee_get();
+    case CRC32C_POLY_REFLECTED:		return crc32_tables_c_get();
+    case CRC32K_POLY_REFLECTED:		return crc32_tables_k_get();
+    case CRC32Q_POLY_REFLECTED:		return crc32_tables_q_get();
+    case CRC32D_POLY_REFLECTED:		return crc32_tables_d_get();
+    case CRC32_XFER_POLY_REFLECTED:	return crc32_tables_xfer_get();
+    case CRC32_AUTOSAR_POLY_REFLECTED:	return crc32_tables_autosar_get();
+    default:				return NULL;
+    }
+}
+
+// Continue a reflected CRC-32 (no final XOR) with the shared tables of one variant
+static inline uint32_t crc32_tables_update(const crc32_tables* tables, uint32_t crc, const void* data, size_t len) {
+    const uint8_t *p = uhash_cast(const uint8_t*,data);
+#if HASH_USE_CPU_DISPATCH
+    uint32_t features = libhash_cpu_features();
+    if (tables->Poly == CRC32C_POLY_REFLECTED && (features & HASH_CPU_SSE42))
+	return crc32c_sse42(crc, p, len);
+    if (len >= CRC32_FOLD_THRESHOLD && (features & HASH_CPU_PCLMUL)) {
+	size_t folded = len & ~hash_cast(size_t, 15);
+	crc = crc32_fold_pclmul(tables->Fold, crc, p, folded);
+	p += folded;
+	len -= folded;
+    }
+#endif
+    if (len >= CRC32_SLICE16_THRESHOLD) return crc32_slice16(tables->Slice, crc, p, len);
+    return crc32_slice8(tables->Slice, crc, p, len);
+}
+
+// Shared reflected lookup table of one of the CRC32_*_POLY_REFLECTED polynomials, or NULL for any other polynomial
+LIBHASH_INLINE_API const uint32_t* crc32_shared_table(uint32_t poly_reflected) {
+    const crc32_tables* tables = crc32_tables_get(poly_reflected);
+    return tables ? tables->Slice[0] : NULL;
+}
+
+// Continue a reflected CRC-32 (no final XOR) over a buffer. The CRC32_*_POLY_REFLECTED polynomials use the shared
+// tables and the fastest kernel available; any other polynomial is processed byte-wise with a table built per call.
+LIBHASH_INLINE_API uint32_t crc32_update(uint32_t poly_reflected, uint32_t crc, const void* data, size_t len) {
+    const crc32_tables* tables = crc32_tables_get(poly_reflected);
+    uint32_t table[256];
+    if (tables) return crc32_tables_update(tables, crc, data, len);
+    crc32_reflected_table(table, poly_reflected);
+    return ccrc32_reflected(crc, data, len, table);
+}
+
+/*
+ * crc32_combine
+ *
+ * CRC of a buffer A followed by a buffer B of len_b bytes, from the CRC of A and the CRC of B. Works on final CRCs
+ * that share the initial value and final XOR (such as the crc32* functions in crc32_ext.h), and on registers from
+ * crc32_update when crc_b was started from 0. Costs O(log len_b) carry-less multiplies, independent of the data.
+ */
+LIBHASH_INLINE_API uint32_t crc32_combine(uint32_t crc_a, uint32_t crc_b, uint64_t len_b, uint32_t poly_reflected) {
+    const crc32_tables* tables = crc32_tables_get(poly_reflected);
+    uint32_t op = tables ? crc32_tables_x8n(tables, len_b) : crc32_x8nmodp(len_b, poly_reflected);
+    return crc32_multmodp(op, crc_a, poly_reflected) ^ crc_b;
+}
+
+// Buffers of at least this many bytes are split into segments checksummed on the worker threads
+#ifndef CRC32_PARALLEL_THRESHOLD
+#define CRC32_PARALLEL_THRESHOLD	(4U << 20)
+#endif
+#define CRC32_PARALLEL_SEGMENT_MIN	(1U << 20)
+
+typedef struct {
+    const crc32_tables* Tables;
+    const uint8_t* Data;
+    size_t Size;
+    size_t Segment;
+    uint32_t Crcs[HASH_POOL_THREADS_MAX];	// register of every segment, the first one continuing the caller's
+} crc32_job;
+
+// Pool task: checksums segment Index of the job
+static void crc32_segment(void* Arg, uint32_t Index) {
+    crc32_job* job = (crc32_job*)Arg;
+    size_t offset = hash_c_cast(size_t, Index) * job->Segment;
+    size_t size = (job->Size - offset < job->Segment) ? job->Size - offset : job->Segment;
+    job->Crcs[Index] = crc32_tables_update(job->Tables, job->Crcs[Index], job->Data + offset, size);
+}
+
+/*
+ * crc32_update_parallel
+ *
+ * crc32_update that splits buffers of CRC32_PARALLEL_THRESHOLD bytes and more into one contiguous segment per
+ * thread of the worker pool, then merges the segment CRCs with crc32_combine. The result is the same as
+ * crc32_update; smaller buffers, other polynomials and single-threaded builds simply run crc32_update.
+ */
+LIBHASH_INLINE_API uint32_t crc32_update_parallel(uint32_t poly_reflected, uint32_t crc, const void* data, size_t len) {
+    const crc32_tables* tables = crc32_tables_get(poly_reflected);
+    uint32_t threads, count, i, op;
+    size_t segments;
+    crc32_job job;
+    if (!tables || len < CRC32_PARALLEL_THRESHOLD || len < 2 * CRC32_PARALLEL_SEGMENT_MIN ||
+	(threads = libhash_pool_threads()) < 2)
+	return crc32_update(poly_reflected, crc, data, len);
+    segments = len / CRC32_PARALLEL_SEGMENT_MIN;
+    if (segments > threads) segments = threads;
+    job.Tables = tables;
+    job.Data = uhash_cast(const uint8_t*,data);
+    job.Size = len;
+    job.Segment = ((len + segments - 1) / segments + 63) & ~hash_cast(size_t, 63);
+    count = hash_cast(uint32_t, (len + job.Segment - 1) / job.Segment);
+    memset(job.Crcs, 0, sizeof(job.Crcs));
+    job.Crcs[0] = crc;
+    libhash_pool_run(crc32_segment, &job, count);
+    op = crc32_tables_x8n(tables, job.Segment);
+    for (crc = job.Crcs[0], i = 1; i < count; ++i) {
+	if (i == count - 1) op = crc32_tables_x8n(tables, len - hash_c_cast(size_t, i) * job.Segment);
+	crc = crc32_multmodp(op, crc, poly_reflected) ^ job.Crcs[i];
+    }
+    return crc;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,6 +3,7 @@
 #define __CRC32_EXT_H__
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <crc32.h>
 
 /*
@@ -17,55 +18,80 @@ extern "C" {
 #endif
 
 /* === Compute CRC-32 over memory === */
-#define __CRC32_FUNCTION__(name, poly_reflected) \
+#define __CRC32_FUNCTION__(name, variant) \
 LIBHASH_INLINE_API uint32_t name(const void *data, size_t len) { \
     if (!data || len == 0) \
 	return 0; \
-    uint32_t table[256]; \
-    crc32_reflected_table(table, (poly_reflected)); \
-    return ccrc32_reflected(0xFFFFFFFFU, data, len, table) ^ 0xFFFFFFFFU; \
+    return crc32_tables_update(crc32_tables_##variant##_get(), 0xFFFFFFFFU, data, len) ^ 0xFFFFFFFFU; \
 }
 
 /* === Compute CRC-32 over file === */
-#define __CRC32_FILE_FUNCTION__(name, poly_reflected) \
+#define __CRC32_FILE_FUNCTION__(name, variant) \
 LIBHASH_INLINE_API uint32_t name##_file(const char *path) { \
     if (!path) return 0; \
     FILE *fp = fopen(path, "rb"); \
     if (!fp) return 0; \
-    uint32_t table[256]; \
-    crc32_reflected_table(table, (poly_reflected)); \
+    const crc32_tables *tables = crc32_tables_##variant##_get(); \
     uint32_t crc = 0xFFFFFFFFU; \
     uint8_t buf[4096]; \
     size_t n; \
     while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) \
-	crc = ccrc32_reflected(crc, buf, n, table); \
+	crc = crc32_tables_update(tables, crc, buf, n); \
     fclose(fp); \
     return crc ^ 0xFFFFFFFFU; \
 }
 
 /* === Standard CRC-32 families === */
-__CRC32_FUNCTION__(crc32,CRC32_POLY_REFLECTED)
-__CRC32_FUNCTION__(crc32_ieee,CRC32_POLY_REFLECTED)
-__CRC32_FUNCTION__(crc32c,CRC32C_POLY_REFLECTED)
-__CRC32_FUNCTION__(crc32k,CRC32K_POLY_REFLECTED)
-__CRC32_FUNCTION__(crc32q,CRC32Q_POLY_REFLECTED)
-__CRC32_FUNCTION__(crc32d,CRC32D_POLY_REFLECTED)
-__CRC32_FUNCTION__(crc32_xfer,CRC32_XFER_POLY_REFLECTED)
-__CRC32_FUNCTION__(crc32_autosar,CRC32_AUTOSAR_POLY_REFLECTED)
+__CRC32_FUNCTION__(crc32,ieee)
+__CRC32_FUNCTION__(crc32_ieee,ieee)
+__CRC32_FUNCTION__(crc32c,c)
+__CRC32_FUNCTION__(crc32k,k)
+__CRC32_FUNCTION__(crc32q,q)
+__CRC32_FUNCTION__(crc32d,d)
+__CRC32_FUNCTION__(crc32_xfer,xfer)
+__CRC32_FUNCTION__(crc32_autosar,autosar)
 
 /* === File-based variants === */
-__CRC32_FILE_FUNCTION__(crc32,CRC32_POLY_REFLECTED)
-__CRC32_FILE_FUNCTION__(crc32_ieee,CRC32_POLY_REFLECTED)
-__CRC32_FILE_FUNCTION__(crc32c,CRC32C_POLY_REFLECTED)
-__CRC32_FILE_FUNCTION__(crc32k,CRC32K_POLY_REFLECTED)
-__CRC32_FILE_FUNCTION__(crc32q,CRC32Q_POLY_REFLECTED)
-__CRC32_FILE_FUNCTION__(crc32d,CRC32D_POLY_REFLECTED)
-__CRC32_FILE_FUNCTION__(crc32_xfer,CRC32_XFER_POLY_REFLECTED)
-__CRC32_FILE_FUNCTION__(crc32_autosar,CRC32_AUTOSAR_POLY_REFLECTED)
+__CRC32_FILE_FUNCTION__(crc32,ieee)
+__CRC32_FILE_FUNCTION__(crc32_ieee,ieee)
+__CRC32_FILE_FUNCTION__(crc32c,c)
+__CRC32_FILE_FUNCTION__(crc32k,k)
+__CRC32_FILE_FUNCTION__(crc32q,q)
+__CRC32_FILE_FUNCTION__(crc32d,d)
+__CRC32_FILE_FUNCTION__(crc32_xfer,xfer)
+__CRC32_FILE_FUNCTION__(crc32_autosar,autosar)
 
 #undef __CRC32_FUNCTION__
 #undef __CRC32_FILE_FUNCTION__
 
+/* === Parallel CRC-32 over memory and files, any CRC32_*_POLY_REFLECTED === */
+#define CRC32_FILE_PARALLEL_CHUNK	(8U << 20)
+
+LIBHASH_INLINE_API uint32_t crc32_parallel(const void *data, size_t len, uint32_t poly_reflected) {
+    if (!data || len == 0)
+	return 0;
+    return crc32_update_parallel(poly_reflected, 0xFFFFFFFFU, data, len) ^ 0xFFFFFFFFU;
+}
+
+/* The file is read in CRC32_FILE_PARALLEL_CHUNK pieces, each checksummed across the worker threads */
+LIBHASH_INLINE_API uint32_t crc32_file_parallel(const char *path, uint32_t poly_reflected) {
+    if (!path) return 0;
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+    uint8_t small[4096], *buf = uhash_cast(uint8_t*, malloc(CRC32_FILE_PARALLEL_CHUNK));
+    size_t size = CRC32_FILE_PARALLEL_CHUNK, n;
+    uint32_t crc = 0xFFFFFFFFU;
+    if (!buf) {
+	buf = small;
+	size = sizeof(small);
+    }
+    while ((n = fread(buf, 1, size, fp)) > 0)
+	crc = crc32_update_parallel(poly_reflected, crc, buf, n);
+    if (buf != small) free(buf);
+    fclose(fp);
+    return crc ^ 0xFFFFFFFFU;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,6 +16,8 @@
 #include "aescbc.h"
 #include "aesctr.h"
 #include "aesofb.h"
+#include "aesgcm.h"
+#include "aesxts.h"
 
 #include "crc32.h"
 #include "crc32_ext.h"
@@ -35,3 +37,5 @@
 #include "sha256.h"
 #include "sha384.h"
 #include "sha512.h"
+#include "sha512_224.h"
+#include "sha512_256.h"
@@ -55,6 +55,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes (a multiple of every block size)
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -183,6 +188,30 @@ LIBHASH_INLINE_API void Md2Calculate(const void *data, uint32_t len, MD2_HASH *d
     Md2Finalise(&ctx, digest);
 }
 
+/*
+ * Md2UpdateLarge
+ *
+ * Md2Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Md2UpdateLarge(Md2Context* ctx, const void* data, size_t len) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, data);
+	for(; len > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, len -= HASH_LARGE_STRIDE)
+		Md2Update(ctx, p, HASH_LARGE_STRIDE);
+	Md2Update(ctx, p, hash_cast(uint32_t, len));
+}
+
+/*
+ * Md2CalculateLarge
+ *
+ * Md2Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Md2CalculateLarge(const void* data, size_t len, MD2_HASH* digest) {
+	Md2Context context;
+	Md2Initialise(&context);
+	Md2UpdateLarge(&context, data, len);
+	Md2Finalise(&context, digest);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -56,6 +56,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes (a multiple of every block size)
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -185,7 +190,7 @@ LIBHASH_INLINE_API void Md4Finalise(Md4Context *ctx, MD4_HASH *digest) {
 	used = 0; mfree = 64;
     }
     memset(&ctx->buffer[used], 0, mfree - 8);
-    uint64_t bits = (hash_cast(uint64_t,ctx->hi) << 29) | (ctx->lo << 3);
+    uint64_t bits = (hash_cast(uint64_t,ctx->hi) << 32) | (hash_cast(uint64_t,ctx->lo) << 3);
     for (int i = 0; i < 8; ++i)
 	ctx->buffer[56 + i] = (uint8_t)(bits >> (8 * i));
     uint32_t state[4] = { ctx->a, ctx->b, ctx->c, ctx->d };
@@ -207,6 +212,30 @@ LIBHASH_INLINE_API void Md4Calculate(const void *data, uint32_t len, MD4_HASH *d
     Md4Finalise(&ctx, digest);
 }
 
+/*
+ * Md4UpdateLarge
+ *
+ * Md4Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Md4UpdateLarge(Md4Context* ctx, const void* data, size_t len) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, data);
+	for(; len > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, len -= HASH_LARGE_STRIDE)
+		Md4Update(ctx, p, HASH_LARGE_STRIDE);
+	Md4Update(ctx, p, hash_cast(uint32_t, len));
+}
+
+/*
+ * Md4CalculateLarge
+ *
+ * Md4Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Md4CalculateLarge(const void* data, size_t len, MD4_HASH* digest) {
+	Md4Context context;
+	Md4Initialise(&context);
+	Md4UpdateLarge(&context, data, len);
+	Md4Finalise(&context, digest);
+}
+
 #undef F4
 #undef G4
 #undef H4
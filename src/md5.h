@@ -24,6 +24,10 @@
 #include <stdint.h>
 #include <memory.h>
 #include <string.h>
+#include <stddef.h>
+
+#include "cpufeatures.h"
+#include "multibuffer.h"
 
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
 #define inline __inline
@@ -57,6 +61,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes (a multiple of every block size)
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -83,6 +92,7 @@
 	(hash_cast(uint32_t,ptr[(n) * 4 + 2]) << 16) | (hash_cast(uint32_t,ptr[(n) * 4 + 3]) << 24))
 
 #define MD5_HASH_SIZE  16
+#define MD5_BLOCK_SIZE 64
 
 typedef struct {
 	uint32_t lo;
@@ -99,6 +109,15 @@ typedef struct {
 	uint8_t bytes[MD5_HASH_SIZE];
 } MD5_HASH;
 
+// Md5MultiContext - Multi-buffer MD5 scheduler, initialise with Md5MultiInitialise. Do not modify directly.
+typedef struct {
+	HashLane  Lanes[HASH_LANES_MAX];
+	MD5_HASH* Digests[HASH_LANES_MAX];	// destination of each busy lane, NULL when the lane is free
+	uint32_t  State[4][HASH_LANES_MAX];	// a, b, c, d of every lane (transposed)
+	uint32_t  Width;			// lanes in use: 16 (AVX-512), 8 (AVX2) or 1 (one message at a time)
+	uint32_t  Busy;
+} Md5MultiContext;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -304,6 +323,255 @@ LIBHASH_INLINE_API void Md5Calculate(const void* Buffer, uint32_t BufferSize, MD
 	Md5Finalise(&context, Digest);
 }
 
+/*
+ * Md5UpdateLarge
+ *
+ * Md5Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Md5UpdateLarge(Md5Context* Context, const void* Buffer, size_t BufferSize) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, Buffer);
+	for(; BufferSize > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, BufferSize -= HASH_LARGE_STRIDE)
+		Md5Update(Context, p, HASH_LARGE_STRIDE);
+	Md5Update(Context, p, hash_cast(uint32_t, BufferSize));
+}
+
+/*
+ * Md5CalculateLarge
+ *
+ * Md5Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Md5CalculateLarge(const void* Buffer, size_t BufferSize, MD5_HASH* Digest) {
+	Md5Context context;
+	Md5Initialise(&context);
+	Md5UpdateLarge(&context, Buffer, BufferSize);
+	Md5Finalise(&context, Digest);
+}
+
+/*
+ * Multi-buffer MD5
+ *
+ * A single MD5 stream is bound by the latency of its dependency chain, but independent messages can share a vector
+ * register, one per 32-bit lane. State and message words are kept transposed: State[j][lane] and W[i][lane].
+ */
+
+// The 64 MD5 steps as STEP(function, a, b, c, d, message word, constant, shift)
+#define MD5_LANE_STEPS(STEP) \
+	STEP(F, a, b, c, d, 0,  0xd76aa478, 7)  STEP(F, d, a, b, c, 1,  0xe8c7b756, 12) \
+	STEP(F, c, d, a, b, 2,  0x242070db, 17) STEP(F, b, c, d, a, 3,  0xc1bdceee, 22) \
+	STEP(F, a, b, c, d, 4,  0xf57c0faf, 7)  STEP(F, d, a, b, c, 5,  0x4787c62a, 12) \
+	STEP(F, c, d, a, b, 6,  0xa8304613, 17) STEP(F, b, c, d, a, 7,  0xfd469501, 22) \
+	STEP(F, a, b, c, d, 8,  0x698098d8, 7)  STEP(F, d, a, b, c, 9,  0x8b44f7af, 12) \
+	STEP(F, c, d, a, b, 10, 0xffff5bb1, 17) STEP(F, b, c, d, a, 11, 0x895cd7be, 22) \
+	STEP(F, a, b, c, d, 12, 0x6b901122, 7)  STEP(F, d, a, b, c, 13, 0xfd987193, 12) \
+	STEP(F, c, d, a, b, 14, 0xa679438e, 17) STEP(F, b, c, d, a, 15, 0x49b40821, 22) \
+	STEP(G, a, b, c, d, 1,  0xf61e2562, 5)  STEP(G, d, a, b, c, 6,  0xc040b340, 9)  \
+	STEP(G, c, d, a, b, 11, 0x265e5a51, 14) STEP(G, b, c, d, a, 0,  0xe9b6c7aa, 20) \
+	STEP(G, a, b, c, d, 5,  0xd62f105d, 5)  STEP(G, d, a, b, c, 10, 0x02441453, 9)  \
+	STEP(G, c, d, a, b, 15, 0xd8a1e681, 14) STEP(G, b, c, d, a, 4,  0xe7d3fbc8, 20) \
+	STEP(G, a, b, c, d, 9,  0x21e1cde6, 5)  STEP(G, d, a, b, c, 14, 0xc33707d6, 9)  \
+	STEP(G, c, d, a, b, 3,  0xf4d50d87, 14) STEP(G, b, c, d, a, 8,  0x455a14ed, 20) \
+	STEP(G, a, b, c, d, 13, 0xa9e3e905, 5)  STEP(G, d, a, b, c, 2,  0xfcefa3f8, 9)  \
+	STEP(G, c, d, a, b, 7,  0x676f02d9, 14) STEP(G, b, c, d, a, 12, 0x8d2a4c8a, 20) \
+	STEP(H, a, b, c, d, 5,  0xfffa3942, 4)  STEP(H, d, a, b, c, 8,  0x8771f681, 11) \
+	STEP(H, c, d, a, b, 11, 0x6d9d6122, 16) STEP(H, b, c, d, a, 14, 0xfde5380c, 23) \
+	STEP(H, a, b, c, d, 1,  0xa4beea44, 4)  STEP(H, d, a, b, c, 4,  0x4bdecfa9, 11) \
+	STEP(H, c, d, a, b, 7,  0xf6bb4b60, 16) STEP(H, b, c, d, a, 10, 0xbebfbc70, 23) \
+	STEP(H, a, b, c, d, 13, 0x289b7ec6, 4)  STEP(H, d, a, b, c, 0,  0xeaa127fa, 11) \
+	STEP(H, c, d, a, b, 3,  0xd4ef3085, 16) STEP(H, b, c, d, a, 6,  0x04881d05, 23) \
+	STEP(H, a, b, c, d, 9,  0xd9d4d039, 4)  STEP(H, d, a, b, c, 12, 0xe6db99e5, 11) \
+	STEP(H, c, d, a, b, 15, 0x1fa27cf8, 16) STEP(H, b, c, d, a, 2,  0xc4ac5665, 23) \
+	STEP(I, a, b, c, d, 0,  0xf4292244, 6)  STEP(I, d, a, b, c, 7,  0x432aff97, 10) \
+	STEP(I, c, d, a, b, 14, 0xab9423a7, 15) STEP(I, b, c, d, a, 5,  0xfc93a039, 21) \
+	STEP(I, a, b, c, d, 12, 0x655b59c3, 6)  STEP(I, d, a, b, c, 3,  0x8f0ccc92, 10) \
+	STEP(I, c, d, a, b, 10, 0xffeff47d, 15) STEP(I, b, c, d, a, 1,  0x85845dd1, 21) \
+	STEP(I, a, b, c, d, 8,  0x6fa87e4f, 6)  STEP(I, d, a, b, c, 15, 0xfe2ce6e0, 10) \
+	STEP(I, c, d, a, b, 6,  0xa3014314, 15) STEP(I, b, c, d, a, 13, 0x4e0811a1, 21) \
+	STEP(I, a, b, c, d, 4,  0xf7537e82, 6)  STEP(I, d, a, b, c, 11, 0xbd3af235, 10) \
+	STEP(I, c, d, a, b, 2,  0x2ad7d2bb, 15) STEP(I, b, c, d, a, 9,  0xeb86d391, 21)
+
+#if HASH_USE_CPU_DISPATCH
+#define MD5X8_F(x, y, z) _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+#define MD5X8_G(x, y, z) _mm256_xor_si256(y, _mm256_and_si256(z, _mm256_xor_si256(x, y)))
+#define MD5X8_H(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define MD5X8_I(x, y, z) _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, ones)))
+#define MD5X8_STEP(f, a, b, c, d, k, t, s) \
+	a = _mm256_add_epi32(a, _mm256_add_epi32(MD5X8_##f(b, c, d), \
+			     _mm256_add_epi32(w[k], _mm256_set1_epi32(hash_cast(int, t))))); \
+	a = _mm256_or_si256(_mm256_slli_epi32(a, s), _mm256_srli_epi32(a, 32 - (s))); \
+	a = _mm256_add_epi32(a, b);
+
+/*
+ * Md5CompressX8Avx2
+ *
+ * Compresses one block in each of 8 lanes.
+ */
+LIBHASH_TARGET("avx2")
+static void Md5CompressX8Avx2(uint32_t State[4][HASH_LANES_MAX], const uint32_t W[16][HASH_LANES_MAX]) {
+	const __m256i ones = _mm256_set1_epi32(-1);
+	__m256i w[16], a, b, c, d;
+	int i;
+	for(i = 0; i < 16; i++) w[i] = _mm256_loadu_si256(uhash_c_cast(const __m256i*, W[i]));
+	a = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[0]));
+	b = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[1]));
+	c = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[2]));
+	d = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[3]));
+	MD5_LANE_STEPS(MD5X8_STEP)
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[0]), _mm256_add_epi32(a, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[0]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[1]), _mm256_add_epi32(b, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[1]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[2]), _mm256_add_epi32(c, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[2]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[3]), _mm256_add_epi32(d, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[3]))));
+}
+
+// F, G, H and I are each a single VPTERNLOGD
+#define MD5X16_STEP(f, a, b, c, d, k, t, s) \
+	a = _mm512_add_epi32(a, _mm512_add_epi32(_mm512_ternarylogic_epi32(b, c, d, MD5X16_##f), \
+			     _mm512_add_epi32(w[k], _mm512_set1_epi32(hash_cast(int, t))))); \
+	a = _mm512_add_epi32(_mm512_rol_epi32(a, s), b);
+#define MD5X16_F 0xCA
+#define MD5X16_G 0xE4
+#define MD5X16_H 0x96
+#define MD5X16_I 0x39
+
+/*
+ * Md5CompressX16Avx512
+ *
+ * Compresses one block in each of 16 lanes.
+ */
+LIBHASH_TARGET("avx512f")
+static void Md5CompressX16Avx512(uint32_t State[4][HASH_LANES_MAX], const uint32_t W[16][HASH_LANES_MAX]) {
+	__m512i w[16], a, b, c, d;
+	int i;
+	for(i = 0; i < 16; i++) w[i] = _mm512_loadu_si512(W[i]);
+	a = _mm512_loadu_si512(State[0]);
+	b = _mm512_loadu_si512(State[1]);
+	c = _mm512_loadu_si512(State[2]);
+	d = _mm512_loadu_si512(State[3]);
+	MD5_LANE_STEPS(MD5X16_STEP)
+	_mm512_storeu_si512(State[0], _mm512_add_epi32(a, _mm512_loadu_si512(State[0])));
+	_mm512_storeu_si512(State[1], _mm512_add_epi32(b, _mm512_loadu_si512(State[1])));
+	_mm512_storeu_si512(State[2], _mm512_add_epi32(c, _mm512_loadu_si512(State[2])));
+	_mm512_storeu_si512(State[3], _mm512_add_epi32(d, _mm512_loadu_si512(State[3])));
+}
+
+#undef MD5X8_F
+#undef MD5X8_G
+#undef MD5X8_H
+#undef MD5X8_I
+#undef MD5X8_STEP
+#undef MD5X16_STEP
+#undef MD5X16_F
+#undef MD5X16_G
+#undef MD5X16_H
+#undef MD5X16_I
+#endif
+
+#undef MD5_LANE_STEPS
+
+/*
+ * Md5MultiStep
+ *
+ * Compresses the next block of every busy lane (idle lanes hash a zero block that is never read back). Lanes whose
+ * message is complete get their digest written and are freed. Returns the number of completed messages.
+ */
+static inline size_t Md5MultiStep(Md5MultiContext* Context) {
+#if HASH_USE_CPU_DISPATCH
+	uint32_t message[16][HASH_LANES_MAX];
+	const uint8_t* block;
+#endif
+	size_t done = 0;
+	uint32_t l, i;
+#if HASH_USE_CPU_DISPATCH
+	for(l = 0; l < Context->Width; l++) {
+		block = Context->Digests[l] ? HashLaneNext(&Context->Lanes[l]) : HashLaneZeroBlock;
+		for(i = 0; i < 16; i++) {
+			message[i][l] = hash_cast(uint32_t, block[4 * i]) | (hash_cast(uint32_t, block[4 * i + 1]) << 8) |
+					(hash_cast(uint32_t, block[4 * i + 2]) << 16) | (hash_cast(uint32_t, block[4 * i + 3]) << 24);
+		}
+	}
+	if(Context->Width == 16) Md5CompressX16Avx512(Context->State, message);
+	else Md5CompressX8Avx2(Context->State, message);
+#endif
+	for(l = 0; l < Context->Width; l++) {
+		if(Context->Digests[l] == NULL || !HashLaneDone(&Context->Lanes[l])) continue;
+		for(i = 0; i < MD5_HASH_SIZE; i++)
+			Context->Digests[l]->bytes[i] = hash_cast(uint8_t, (Context->State[i >> 2][l] >> (8 * (i & 3))) & 255);
+		Context->Digests[l] = NULL;
+		Context->Busy--;
+		done++;
+	}
+	return done;
+}
+
+/*
+ * Md5MultiInitialise
+ *
+ * Initialises a multi-buffer MD5 scheduler, using 16 lanes with AVX-512, 8 with AVX2 and hashing one message at a
+ * time otherwise.
+ */
+LIBHASH_INLINE_API void Md5MultiInitialise(Md5MultiContext* Context) {
+	uint32_t l;
+	Context->Width = 1;
+#if HASH_USE_CPU_DISPATCH
+	if(libhash_cpu_features() & HASH_CPU_AVX512F) Context->Width = 16;
+	else if(libhash_cpu_features() & HASH_CPU_AVX2) Context->Width = 8;
+#endif
+	Context->Busy = 0;
+	for(l = 0; l < HASH_LANES_MAX; l++) Context->Digests[l] = NULL;
+}
+
+/*
+ * Md5MultiSubmit
+ *
+ * Queues a message of BufferSize bytes whose MD5 will be written to Digest. When every lane is busy, lanes are
+ * advanced until one finishes and the message takes its place. Buffer must stay valid until its digest has been
+ * written, at the latest by Md5MultiFlush. Returns the number of digests completed during the call.
+ */
+LIBHASH_INLINE_API size_t Md5MultiSubmit(Md5MultiContext* Context, const void* Buffer, size_t BufferSize,
+					 MD5_HASH* Digest) {
+	size_t done = 0;
+	uint32_t l;
+	if(Context->Width < 2) {
+		Md5CalculateLarge(Buffer, BufferSize, Digest);
+		return 1;
+	}
+	while(Context->Busy == Context->Width) done += Md5MultiStep(Context);
+	for(l = 0; Context->Digests[l] != NULL; l++);
+	HashLaneLoad(&Context->Lanes[l], Buffer, BufferSize, MD5_BLOCK_SIZE, 8, HASH_LANE_LITTLE_ENDIAN);
+	Context->State[0][l] = 0x67452301;
+	Context->State[1][l] = 0xefcdab89;
+	Context->State[2][l] = 0x98badcfe;
+	Context->State[3][l] = 0x10325476;
+	Context->Digests[l] = Digest;
+	Context->Busy++;
+	return done;
+}
+
+/*
+ * Md5MultiFlush
+ *
+ * Runs every submitted message to completion. Returns the number of digests completed during the call.
+ */
+LIBHASH_INLINE_API size_t Md5MultiFlush(Md5MultiContext* Context) {
+	size_t done = 0;
+	while(Context->Busy > 0) done += Md5MultiStep(Context);
+	return done;
+}
+
+/*
+ * Md5CalculateBatch
+ *
+ * Calculates the MD5 hash of Count independent buffers (Buffers[i] of Sizes[i] bytes into Digests[i]) through the
+ * multi-buffer scheduler. Produces the same digests as calling Md5Calculate on each buffer.
+ */
+LIBHASH_INLINE_API void Md5CalculateBatch(const void* const* Buffers, const size_t* Sizes, size_t Count,
+					  MD5_HASH* Digests) {
+	Md5MultiContext context;
+	size_t i;
+	Md5MultiInitialise(&context);
+	for(i = 0; i < Count; i++) Md5MultiSubmit(&context, Buffers[i], Sizes[i], &Digests[i]);
+	Md5MultiFlush(&context);
+}
+
 #undef F5
 #undef G5
 #undef H5
@@ -0,0 +1,122 @@
+/**
+ * WjCryptLib_MultiBuffer
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MULTIBUFFER_H__
+#define __MULTIBUFFER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory.h>
+
+/*
+ * Multi-buffer hashing helpers
+ *
+ * A batch hasher runs the compression function of N independent messages in lockstep, one message per SIMD lane. Each
+ * lane is a HashLane: whole message blocks are read in place and the final partial block plus the Merkle-Damgard
+ * padding is prepared up front in Tail, so the kernels only ever see whole blocks. Lanes of different lengths simply
+ * finish at different steps and are refilled (or parked on HashLaneZeroBlock) by the caller.
+ */
+
+#define HASH_LANES_MAX		16
+#define HASH_LANE_BLOCK_MAX	128
+
+#define HASH_LANE_BIG_ENDIAN	0
+#define HASH_LANE_LITTLE_ENDIAN	1
+
+typedef struct {
+	const uint8_t*	Data;		// next whole block of the message
+	size_t		Blocks;		// whole blocks left at Data
+	uint32_t	BlockSize;
+	uint32_t	TailBlocks;	// padded blocks left in Tail
+	uint32_t	TailOffset;
+	uint8_t		Tail[2 * HASH_LANE_BLOCK_MAX];
+} HashLane;
+
+static const uint8_t HashLaneZeroBlock[HASH_LANE_BLOCK_MAX] = { 0 };
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * HashLaneLoad
+ *
+ * Prepares Lane for a message of Size bytes. The trailing partial block is copied into Tail followed by 0x80, zeros and
+ * the message bit length stored in the last LengthSize bytes (8 or 16) in the given byte order.
+ */
+static inline void HashLaneLoad(HashLane* Lane, const void* Buffer, size_t Size, uint32_t BlockSize,
+				uint32_t LengthSize, int ByteOrder) {
+	size_t rest = Size % BlockSize;
+	uint64_t bitsLow = (uint64_t)Size << 3, bitsHigh = (uint64_t)Size >> 61;
+	uint32_t total, i;
+	Lane->Data = (const uint8_t*)Buffer;
+	Lane->Blocks = Size / BlockSize;
+	Lane->BlockSize = BlockSize;
+	Lane->TailOffset = 0;
+	Lane->TailBlocks = (rest + 1 + LengthSize > BlockSize) ? 2 : 1;
+	total = Lane->TailBlocks * BlockSize;
+	if(rest) memcpy(Lane->Tail, Lane->Data + Lane->Blocks * BlockSize, rest);
+	memset(Lane->Tail + rest, 0, total - rest);
+	Lane->Tail[rest] = 0x80;
+	for(i = 0; i < 8; i++) {
+		if(ByteOrder == HASH_LANE_LITTLE_ENDIAN) {
+			Lane->Tail[total - LengthSize + i] = (uint8_t)(bitsLow >> (8 * i));
+		} else {
+			Lane->Tail[total - 1 - i] = (uint8_t)(bitsLow >> (8 * i));
+			if(LengthSize > 8) Lane->Tail[total - 9 - i] = (uint8_t)(bitsHigh >> (8 * i));
+		}
+	}
+}
+
+/*
+ * HashLaneNext
+ *
+ * Returns the next block of the lane (message blocks first, then the padded tail) or NULL once the lane is drained.
+ */
+static inline const uint8_t* HashLaneNext(HashLane* Lane) {
+	const uint8_t* block;
+	if(Lane->Blocks) {
+		block = Lane->Data;
+		Lane->Data += Lane->BlockSize;
+		Lane->Blocks--;
+		return block;
+	}
+	if(Lane->TailBlocks) {
+		block = Lane->Tail + Lane->TailOffset;
+		Lane->TailOffset += Lane->BlockSize;
+		Lane->TailBlocks--;
+		return block;
+	}
+	return NULL;
+}
+
+/*
+ * HashLaneDone
+ *
+ * Non-zero once every block of the lane has been handed out.
+ */
+static inline int HashLaneDone(const HashLane* Lane) {
+	return Lane->Blocks == 0 && Lane->TailBlocks == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MULTIBUFFER_H__ */
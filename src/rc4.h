@@ -10,6 +10,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 #include <memory.h>
 
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
@@ -44,6 +45,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -112,6 +118,18 @@ LIBHASH_INLINE_API void Rc4Output(Rc4Context *Context, void *Buffer, uint32_t Si
 	}
 }
 
+/*
+ *  Rc4OutputLarge
+ *
+ *  Rc4Output for a size_t length.
+ */
+LIBHASH_INLINE_API void Rc4OutputLarge(Rc4Context *Context, void *Buffer, size_t Size) {
+	uint8_t *out = uhash_cast(uint8_t*, Buffer);
+	for (; Size > HASH_LARGE_STRIDE; out += HASH_LARGE_STRIDE, Size -= HASH_LARGE_STRIDE)
+		Rc4Output(Context, out, HASH_LARGE_STRIDE);
+	Rc4Output(Context, out, hash_cast(uint32_t, Size));
+}
+
 /*
  *  Rc4Xor
  *
@@ -133,6 +151,19 @@ LIBHASH_INLINE_API void Rc4Xor(Rc4Context *Context, const void *InBuffer, void *
 	}
 }
 
+/*
+ *  Rc4XorLarge
+ *
+ *  Rc4Xor for a size_t length.
+ */
+LIBHASH_INLINE_API void Rc4XorLarge(Rc4Context *Context, const void *InBuffer, void *OutBuffer, size_t Size) {
+	const uint8_t *in = hash_c_cast(const uint8_t*, InBuffer);
+	uint8_t *out = uhash_cast(uint8_t*, OutBuffer);
+	for (; Size > HASH_LARGE_STRIDE; in += HASH_LARGE_STRIDE, out += HASH_LARGE_STRIDE, Size -= HASH_LARGE_STRIDE)
+		Rc4Xor(Context, in, out, HASH_LARGE_STRIDE);
+	Rc4Xor(Context, in, out, hash_cast(uint32_t, Size));
+}
+
 /*
  * Rc4XorWithKey
  *
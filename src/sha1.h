@@ -23,6 +23,8 @@
 #include <stdint.h>
 #include <memory.h>
 
+#include "cpufeatures.h"
+
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
 #define inline __inline
 #endif
@@ -55,6 +57,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes (a multiple of every block size)
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -104,47 +111,140 @@ extern "C" {
 #endif
 
 /*
- * Sha1TransformFunction
+ * Sha1TransformScalar
  *
- * Hash a single 512-bit block. This is the core of the algorithm
+ * Hash Blocks consecutive 512-bit blocks. This is the core of the algorithm. The chaining value is kept in locals
+ * across blocks and written back to state once.
  */
-static inline void Sha1TransformFunction(uint32_t state[5], const uint8_t buffer[SHA1_BLOCK_SIZE]) {
-	uint32_t a, b, c, d, e;
+static inline void Sha1TransformScalar(uint32_t state[5], const uint8_t* buffer, size_t Blocks) {
+	uint32_t a, b, c, d, e, h0, h1, h2, h3, h4;
 	uint8_t workspace[SHA1_BLOCK_SIZE];
 	typedef union {
 		uint8_t  c[SHA1_BLOCK_SIZE];
 		uint32_t l[16];
 	} CHAR64LONG16;
 	CHAR64LONG16* block = uhash_cast(CHAR64LONG16*,workspace);
-	memcpy(block->l,buffer,SHA1_BLOCK_SIZE);
-	a = state[0]; b = state[1]; c = state[2]; d = state[3]; e = state[4];
-	// 4 rounds of 20 operations each. Loop unS1led.
-	R0(a,b,c,d,e, 0); R0(e,a,b,c,d, 1); R0(d,e,a,b,c, 2); R0(c,d,e,a,b, 3);
-	R0(b,c,d,e,a, 4); R0(a,b,c,d,e, 5); R0(e,a,b,c,d, 6); R0(d,e,a,b,c, 7);
-	R0(c,d,e,a,b, 8); R0(b,c,d,e,a, 9); R0(a,b,c,d,e,10); R0(e,a,b,c,d,11);
-	R0(d,e,a,b,c,12); R0(c,d,e,a,b,13); R0(b,c,d,e,a,14); R0(a,b,c,d,e,15);
-	R1(e,a,b,c,d,16); R1(d,e,a,b,c,17); R1(c,d,e,a,b,18); R1(b,c,d,e,a,19);
-	R2(a,b,c,d,e,20); R2(e,a,b,c,d,21); R2(d,e,a,b,c,22); R2(c,d,e,a,b,23);
-	R2(b,c,d,e,a,24); R2(a,b,c,d,e,25); R2(e,a,b,c,d,26); R2(d,e,a,b,c,27);
-	R2(c,d,e,a,b,28); R2(b,c,d,e,a,29); R2(a,b,c,d,e,30); R2(e,a,b,c,d,31);
-	R2(d,e,a,b,c,32); R2(c,d,e,a,b,33); R2(b,c,d,e,a,34); R2(a,b,c,d,e,35);
-	R2(e,a,b,c,d,36); R2(d,e,a,b,c,37); R2(c,d,e,a,b,38); R2(b,c,d,e,a,39);
-	R3(a,b,c,d,e,40); R3(e,a,b,c,d,41); R3(d,e,a,b,c,42); R3(c,d,e,a,b,43);
-	R3(b,c,d,e,a,44); R3(a,b,c,d,e,45); R3(e,a,b,c,d,46); R3(d,e,a,b,c,47);
-	R3(c,d,e,a,b,48); R3(b,c,d,e,a,49); R3(a,b,c,d,e,50); R3(e,a,b,c,d,51);
-	R3(d,e,a,b,c,52); R3(c,d,e,a,b,53); R3(b,c,d,e,a,54); R3(a,b,c,d,e,55);
-	R3(e,a,b,c,d,56); R3(d,e,a,b,c,57); R3(c,d,e,a,b,58); R3(b,c,d,e,a,59);
-	R4(a,b,c,d,e,60); R4(e,a,b,c,d,61); R4(d,e,a,b,c,62); R4(c,d,e,a,b,63);
-	R4(b,c,d,e,a,64); R4(a,b,c,d,e,65); R4(e,a,b,c,d,66); R4(d,e,a,b,c,67);
-	R4(c,d,e,a,b,68); R4(b,c,d,e,a,69); R4(a,b,c,d,e,70); R4(e,a,b,c,d,71);
-	R4(d,e,a,b,c,72); R4(c,d,e,a,b,73); R4(b,c,d,e,a,74); R4(a,b,c,d,e,75);
-	R4(e,a,b,c,d,76); R4(d,e,a,b,c,77); R4(c,d,e,a,b,78); R4(b,c,d,e,a,79);
-	// Add the working vars back into context.state[]
-	state[0] += a;
-	state[1] += b;
-	state[2] += c;
-	state[3] += d;
-	state[4] += e;
+	h0 = state[0]; h1 = state[1]; h2 = state[2]; h3 = state[3]; h4 = state[4];
+	for(; Blocks > 0; Blocks--, buffer += SHA1_BLOCK_SIZE) {
+		memcpy(block->l,buffer,SHA1_BLOCK_SIZE);
+		a = h0; b = h1; c = h2; d = h3; e = h4;
+		// 4 rounds of 20 operations each. Loop unS1led.
+		R0(a,b,c,d,e, 0); R0(e,a,b,c,d, 1); R0(d,e,a,b,c, 2); R0(c,d,e,a,b, 3);
+		R0(b,c,d,e,a, 4); R0(a,b,c,d,e, 5); R0(e,a,b,c,d, 6); R0(d,e,a,b,c, 7);
+		R0(c,d,e,a,b, 8); R0(b,c,d,e,a, 9); R0(a,b,c,d,e,10); R0(e,a,b,c,d,11);
+		R0(d,e,a,b,c,12); R0(c,d,e,a,b,13); R0(b,c,d,e,a,14); R0(a,b,c,d,e,15);
+		R1(e,a,b,c,d,16); R1(d,e,a,b,c,17); R1(c,d,e,a,b,18); R1(b,c,d,e,a,19);
+		R2(a,b,c,d,e,20); R2(e,a,b,c,d,21); R2(d,e,a,b,c,22); R2(c,d,e,a,b,23);
+		R2(b,c,d,e,a,24); R2(a,b,c,d,e,25); R2(e,a,b,c,d,26); R2(d,e,a,b,c,27);
+		R2(c,d,e,a,b,28); R2(b,c,d,e,a,29); R2(a,b,c,d,e,30); R2(e,a,b,c,d,31);
+		R2(d,e,a,b,c,32); R2(c,d,e,a,b,33); R2(b,c,d,e,a,34); R2(a,b,c,d,e,35);
+		R2(e,a,b,c,d,36); R2(d,e,a,b,c,37); R2(c,d,e,a,b,38); R2(b,c,d,e,a,39);
+		R3(a,b,c,d,e,40); R3(e,a,b,c,d,41); R3(d,e,a,b,c,42); R3(c,d,e,a,b,43);
+		R3(b,c,d,e,a,44); R3(a,b,c,d,e,45); R3(e,a,b,c,d,46); R3(d,e,a,b,c,47);
+		R3(c,d,e,a,b,48); R3(b,c,d,e,a,49); R3(a,b,c,d,e,50); R3(e,a,b,c,d,51);
+		R3(d,e,a,b,c,52); R3(c,d,e,a,b,53); R3(b,c,d,e,a,54); R3(a,b,c,d,e,55);
+		R3(e,a,b,c,d,56); R3(d,e,a,b,c,57); R3(c,d,e,a,b,58); R3(b,c,d,e,a,59);
+		R4(a,b,c,d,e,60); R4(e,a,b,c,d,61); R4(d,e,a,b,c,62); R4(c,d,e,a,b,63);
+		R4(b,c,d,e,a,64); R4(a,b,c,d,e,65); R4(e,a,b,c,d,66); R4(d,e,a,b,c,67);
+		R4(c,d,e,a,b,68); R4(b,c,d,e,a,69); R4(a,b,c,d,e,70); R4(e,a,b,c,d,71);
+		R4(d,e,a,b,c,72); R4(c,d,e,a,b,73); R4(b,c,d,e,a,74); R4(a,b,c,d,e,75);
+		R4(e,a,b,c,d,76); R4(d,e,a,b,c,77); R4(c,d,e,a,b,78); R4(b,c,d,e,a,79);
+		// Add the working vars back into the chaining value
+		h0 += a;
+		h1 += b;
+		h2 += c;
+		h3 += d;
+		h4 += e;
+	}
+	state[0] = h0;
+	state[1] = h1;
+	state[2] = h2;
+	state[3] = h3;
+	state[4] = h4;
+}
+
+#if HASH_USE_CPU_DISPATCH
+// W[4g..4g+3] from the four previous message groups: A holds W[4g-16..], B, C, D the following groups
+#define SHA1NI_SCHEDULE(A, B, C, D) \
+	A = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(A, B), C), D);
+// Four rounds with message group M and round function F; Ecur carries e, Enext receives abcd for the next group
+#define SHA1NI_ROUNDS(Ecur, Enext, M, F) \
+	Ecur = _mm_sha1nexte_epu32(Ecur, M); \
+	Enext = abcd; \
+	abcd = _mm_sha1rnds4_epu32(abcd, Ecur, F);
+
+/*
+ * Sha1TransformShaNi
+ *
+ * SHA1RNDS4/SHA1NEXTE/SHA1MSG1/SHA1MSG2 backend. abcd holds A..D with A in the top lane, e0/e1 alternately carry E
+ * into each group of four rounds. State stays in registers across all Blocks.
+ */
+LIBHASH_TARGET("sha,sse4.1")
+static void Sha1TransformShaNi(uint32_t state[5], const uint8_t* buffer, size_t Blocks) {
+	const __m128i shuf = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+	__m128i abcd, e0, e1, abcdSave, e0Save, m0, m1, m2, m3;
+
+	abcd = _mm_shuffle_epi32(_mm_loadu_si128(uhash_c_cast(const __m128i*, state)), 0x1B);
+	e0 = _mm_set_epi32(hash_cast(int, state[4]), 0, 0, 0);
+
+	for(; Blocks > 0; Blocks--, buffer += SHA1_BLOCK_SIZE) {
+		abcdSave = abcd;
+		e0Save = e0;
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, buffer)), shuf);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, buffer + 16)), shuf);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, buffer + 32)), shuf);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, buffer + 48)), shuf);
+
+		// Rounds 0-3 add E directly, every later group goes through SHA1NEXTE
+		e0 = _mm_add_epi32(e0, m0);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+		SHA1NI_ROUNDS(e1, e0, m1, 0);
+		SHA1NI_ROUNDS(e0, e1, m2, 0);
+		SHA1NI_ROUNDS(e1, e0, m3, 0);
+		SHA1NI_SCHEDULE(m0, m1, m2, m3); SHA1NI_ROUNDS(e0, e1, m0, 0);
+		SHA1NI_SCHEDULE(m1, m2, m3, m0); SHA1NI_ROUNDS(e1, e0, m1, 1);
+		SHA1NI_SCHEDULE(m2, m3, m0, m1); SHA1NI_ROUNDS(e0, e1, m2, 1);
+		SHA1NI_SCHEDULE(m3, m0, m1, m2); SHA1NI_ROUNDS(e1, e0, m3, 1);
+		SHA1NI_SCHEDULE(m0, m1, m2, m3); SHA1NI_ROUNDS(e0, e1, m0, 1);
+		SHA1NI_SCHEDULE(m1, m2, m3, m0); SHA1NI_ROUNDS(e1, e0, m1, 1);
+		SHA1NI_SCHEDULE(m2, m3, m0, m1); SHA1NI_ROUNDS(e0, e1, m2, 2);
+		SHA1NI_SCHEDULE(m3, m0, m1, m2); SHA1NI_ROUNDS(e1, e0, m3, 2);
+		SHA1NI_SCHEDULE(m0, m1, m2, m3); SHA1NI_ROUNDS(e0, e1, m0, 2);
+		SHA1NI_SCHEDULE(m1, m2, m3, m0); SHA1NI_ROUNDS(e1, e0, m1, 2);
+		SHA1NI_SCHEDULE(m2, m3, m0, m1); SHA1NI_ROUNDS(e0, e1, m2, 2);
+		SHA1NI_SCHEDULE(m3, m0, m1, m2); SHA1NI_ROUNDS(e1, e0, m3, 3);
+		SHA1NI_SCHEDULE(m0, m1, m2, m3); SHA1NI_ROUNDS(e0, e1, m0, 3);
+		SHA1NI_SCHEDULE(m1, m2, m3, m0); SHA1NI_ROUNDS(e1, e0, m1, 3);
+		SHA1NI_SCHEDULE(m2, m3, m0, m1); SHA1NI_ROUNDS(e0, e1, m2, 3);
+		SHA1NI_SCHEDULE(m3, m0, m1, m2); SHA1NI_ROUNDS(e1, e0, m3, 3);
+
+		// e0 holds abcd from before the last group; SHA1NEXTE recovers its E and adds the saved one
+		e0 = _mm_sha1nexte_epu32(e0, e0Save);
+		abcd = _mm_add_epi32(abcd, abcdSave);
+	}
+
+	_mm_storeu_si128(uhash_c_cast(__m128i*, state), _mm_shuffle_epi32(abcd, 0x1B));
+	state[4] = hash_cast(uint32_t, _mm_extract_epi32(e0, 3));
+}
+
+#undef SHA1NI_SCHEDULE
+#undef SHA1NI_ROUNDS
+#endif
+
+/*
+ * Sha1TransformFunction
+ *
+ * Hash Blocks consecutive 512-bit blocks, using the SHA extensions when the CPU has them.
+ */
+static inline void Sha1TransformFunction(uint32_t state[5], const uint8_t* buffer, size_t Blocks) {
+#if HASH_USE_CPU_DISPATCH
+	if(libhash_cpu_features() & HASH_CPU_SHA) {
+		Sha1TransformShaNi(state, buffer, Blocks);
+		return;
+	}
+#endif
+	Sha1TransformScalar(state, buffer, Blocks);
 }
 
 /*
@@ -179,9 +279,11 @@ LIBHASH_INLINE_API void Sha1Update(Sha1Context* Context, const void* Buffer, uin
 	if((j+BufferSize)>63) {
 		i = SHA1_BLOCK_SIZE-j;
 		memcpy(&Context->Buffer[j],Buffer,i);
-		Sha1TransformFunction(Context->State, Context->Buffer);
-		for(; i + 63 < BufferSize; i += SHA1_BLOCK_SIZE)
-			Sha1TransformFunction(Context->State,uhash_c_cast(uint8_t*,Buffer) + i);
+		Sha1TransformFunction(Context->State, Context->Buffer, 1);
+		if(BufferSize - i >= SHA1_BLOCK_SIZE) {
+			Sha1TransformFunction(Context->State,uhash_c_cast(uint8_t*,Buffer) + i, (BufferSize - i) / SHA1_BLOCK_SIZE);
+			i += (BufferSize - i) & ~hash_cast(uint32_t, SHA1_BLOCK_SIZE - 1);
+		}
 		j = 0;
 	} else i = 0;
 	memcpy(&Context->Buffer[j], &(uhash_c_cast(uint8_t*,Buffer))[i], BufferSize - i);
@@ -221,6 +323,30 @@ LIBHASH_INLINE_API void Sha1Calculate(const void* Buffer, uint32_t BufferSize, S
 	Sha1Finalise(&context, Digest);
 }
 
+/*
+ * Sha1UpdateLarge
+ *
+ * Sha1Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha1UpdateLarge(Sha1Context* Context, const void* Buffer, size_t BufferSize) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, Buffer);
+	for(; BufferSize > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, BufferSize -= HASH_LARGE_STRIDE)
+		Sha1Update(Context, p, HASH_LARGE_STRIDE);
+	Sha1Update(Context, p, hash_cast(uint32_t, BufferSize));
+}
+
+/*
+ * Sha1CalculateLarge
+ *
+ * Sha1Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha1CalculateLarge(const void* Buffer, size_t BufferSize, SHA1_HASH* Digest) {
+	Sha1Context context;
+	Sha1Initialise(&context);
+	Sha1UpdateLarge(&context, Buffer, BufferSize);
+	Sha1Finalise(&context, Digest);
+}
+
 #undef R0
 #undef R1
 #undef R2
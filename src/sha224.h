@@ -27,6 +27,8 @@
 #include <stdint.h>
 #include <memory.h>
 
+#include "sha256.h"
+
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
 #define inline __inline
 #endif
@@ -70,13 +72,6 @@
 #define uhash_cast uhash_c_cast
 #endif
 
-#define S224(value, bits)  (((value) >> (bits)) | ((value) << (32 - (bits))))
-#define Sha224Round(a, b, c, d, e, f, g, h, i) \
-	t0 = h + (S224(e,6)^S224(e,11)^S224(e,25)) + (g^(e&(f^g))) + SHAK224[i] + W[i]; \
-	t1 = (S224(a,2)^S224(a,13)^S224(a,22))+(((a|b)&c)|(a&b)); \
-	d += t0; \
-	h  = t0+t1;
-
 #define SHA224_BLOCK_SIZE 64
 #define SHA224_HASH_SIZE  28
 
@@ -95,45 +90,13 @@ typedef struct {
 extern "C" {
 #endif
 
-static const uint32_t SHAK224[SHA224_BLOCK_SIZE] = {
-	0x428a2f98UL,0x71374491UL,0xb5c0fbcfUL,0xe9b5dba5UL,0x3956c25bUL,
-	0x59f111f1UL,0x923f82a4UL,0xab1c5ed5UL,0xd807aa98UL,0x12835b01UL,
-	0x243185beUL,0x550c7dc3UL,0x72be5d74UL,0x80deb1feUL,0x9bdc06a7UL,
-	0xc19bf174UL,0xe49b69c1UL,0xefbe4786UL,0x0fc19dc6UL,0x240ca1ccUL,
-	0x2de92c6fUL,0x4a7484aaUL,0x5cb0a9dcUL,0x76f988daUL,0x983e5152UL,
-	0xa831c66dUL,0xb00327c8UL,0xbf597fc7UL,0xc6e00bf3UL,0xd5a79147UL,
-	0x06ca6351UL,0x14292967UL,0x27b70a85UL,0x2e1b2138UL,0x4d2c6dfcUL,
-	0x53380d13UL,0x650a7354UL,0x766a0abbUL,0x81c2c92eUL,0x92722c85UL,
-	0xa2bfe8a1UL,0xa81a664bUL,0xc24b8b70UL,0xc76c51a3UL,0xd192e819UL,
-	0xd6990624UL,0xf40e3585UL,0x106aa070UL,0x19a4c116UL,0x1e376c08UL,
-	0x2748774cUL,0x34b0bcb5UL,0x391c0cb3UL,0x4ed8aa4aUL,0x5b9cca4fUL,
-	0x682e6ff3UL,0x748f82eeUL,0x78a5636fUL,0x84c87814UL,0x8cc70208UL,
-	0x90befffaUL,0xa4506cebUL,0xbef9a3f7UL,0xc67178f2UL
-};
-
 /*
  * Sha224TransformFunction
+ *
+ * SHA-224 uses the SHA-256 compression function (and its accelerated backends) unchanged.
  */
-static inline void Sha224TransformFunction(Sha224Context* Context, const uint8_t* Buffer) {
-	uint32_t S[8], W[SHA224_BLOCK_SIZE], t0, t1, t;
-	int i;
-	for(i=0; i<8; i++) { S[i] = Context->state[i]; }
-	for(i=0; i<16; i++) {
-		W[i] =	(hash_cast(uint32_t,((Buffer+(4*i))[0]&255))<<24) |
-			(hash_cast(uint32_t,((Buffer+(4*i))[1]&255))<<16) |
-			(hash_cast(uint32_t,((Buffer+(4*i))[2]&255))<<8)  |
-			(hash_cast(uint32_t,((Buffer+(4*i))[3]&255)));
-	}
-	for(i=16; i<SHA224_BLOCK_SIZE; i++) {
-		W[i] =	(S224(W[i - 2],17) ^ S224(W[i - 2],19) ^ ((W[i - 2]&0xFFFFFFFFUL) >> (10))) + W[i - 7] +
-			(S224(W[i - 15],7) ^ S224(W[i - 15],18) ^ ((W[i - 15] & 0xFFFFFFFFUL) >> (3))) + W[i - 16];
-	}
-	for(i=0; i<SHA224_BLOCK_SIZE; i++) {
-		Sha224Round(S[0], S[1], S[2], S[3], S[4], S[5], S[6], S[7], i);
-		t = S[7]; S[7] = S[6]; S[6] = S[5]; S[5] = S[4]; S[4] = S[3];
-		S[3] = S[2]; S[2] = S[1]; S[1] = S[0]; S[0] = t;
-	}
-	for(i=0; i<8; i++) Context->state[i] += S[i];
+static inline void Sha224TransformFunction(Sha224Context* Context, const uint8_t* Buffer, size_t Blocks) {
+	Sha256TransformBlocks(Context->state, Buffer, Blocks);
 }
 
 /*
@@ -160,10 +123,11 @@ LIBHASH_INLINE_API void Sha224Update(Sha224Context* Context, const void* Buffer,
 	if(Context->curlen > sizeof(Context->buf)) return;
 	while(BufferSize > 0) {
 		if(Context->curlen == 0 && BufferSize >= SHA224_BLOCK_SIZE) {
-			Sha224TransformFunction(Context, hash_c_cast(uint8_t*, Buffer));
-			Context->length += (SHA224_BLOCK_SIZE * 8);
-			Buffer = hash_c_cast(uint8_t*, Buffer) + SHA224_BLOCK_SIZE;
-			BufferSize -= SHA224_BLOCK_SIZE;
+			n = BufferSize & ~hash_cast(uint32_t, SHA224_BLOCK_SIZE - 1);
+			Sha224TransformFunction(Context, hash_c_cast(uint8_t*, Buffer), n / SHA224_BLOCK_SIZE);
+			Context->length += (hash_cast(uint64_t, n) * 8);
+			Buffer = hash_c_cast(uint8_t*, Buffer) + n;
+			BufferSize -= n;
 		} else {
 			n = ((BufferSize < (SHA224_BLOCK_SIZE - Context->curlen)) ? BufferSize : (SHA224_BLOCK_SIZE - Context->curlen));
 			memcpy(Context->buf + Context->curlen, Buffer, hash_cast(size_t, n));
@@ -171,7 +135,7 @@ LIBHASH_INLINE_API void Sha224Update(Sha224Context* Context, const void* Buffer,
 			Buffer = hash_c_cast(uint8_t*, Buffer) + n;
 			BufferSize -= n;
 			if(Context->curlen == SHA224_BLOCK_SIZE) {
-				Sha224TransformFunction(Context, Context->buf);
+				Sha224TransformFunction(Context, Context->buf, 1);
 				Context->length += (SHA224_BLOCK_SIZE * 8);
 				Context->curlen = 0;
 			}
@@ -188,7 +152,7 @@ LIBHASH_INLINE_API void Sha224Finalise(Sha224Context* Context, SHA224_HASH* Dige
 	Context->buf[Context->curlen++] = hash_cast(uint8_t, 0x80);
 	if(Context->curlen > 56) {
 		while(Context->curlen < SHA224_BLOCK_SIZE) Context->buf[Context->curlen++] = 0;
-		Sha224TransformFunction(Context, Context->buf);
+		Sha224TransformFunction(Context, Context->buf, 1);
 		Context->curlen = 0;
 	}
 	while(Context->curlen < 56) Context->buf[Context->curlen++] = 0;
@@ -202,7 +166,7 @@ LIBHASH_INLINE_API void Sha224Finalise(Sha224Context* Context, SHA224_HASH* Dige
 	(Context->buf + 56)[6] = hash_cast(uint8_t,(((Context->length) >> 8) & 255));
 	(Context->buf + 56)[7] = hash_cast(uint8_t,((Context->length) & 255));
 
-	Sha224TransformFunction(Context, Context->buf);
+	Sha224TransformFunction(Context, Context->buf, 1);
 
 	// SHA-224 outputs only the first 7 words of SHA-256 state
 	for(int i=0; i<7; i++) {
@@ -223,6 +187,30 @@ LIBHASH_INLINE_API void Sha224Calculate(const void* Buffer, uint32_t BufferSize,
 	Sha224Finalise(&context, Digest);
 }
 
+/*
+ * Sha224UpdateLarge
+ *
+ * Sha224Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha224UpdateLarge(Sha224Context* Context, const void* Buffer, size_t BufferSize) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, Buffer);
+	for(; BufferSize > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, BufferSize -= HASH_LARGE_STRIDE)
+		Sha224Update(Context, p, HASH_LARGE_STRIDE);
+	Sha224Update(Context, p, hash_cast(uint32_t, BufferSize));
+}
+
+/*
+ * Sha224CalculateLarge
+ *
+ * Sha224Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha224CalculateLarge(const void* Buffer, size_t BufferSize, SHA224_HASH* Digest) {
+	Sha224Context context;
+	Sha224Initialise(&context);
+	Sha224UpdateLarge(&context, Buffer, BufferSize);
+	Sha224Finalise(&context, Digest);
+}
+
 #ifdef __cplusplus
 }
 #endif
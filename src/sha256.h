@@ -21,8 +21,12 @@
 #define __SHA256_H__
 
 #include <stdint.h>
+#include <stddef.h>
 #include <memory.h>
 
+#include "cpufeatures.h"
+#include "multibuffer.h"
+
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
 #define inline __inline
 #endif
@@ -55,6 +59,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes (a multiple of every block size)
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -108,30 +117,129 @@ static const uint32_t SHAK256[SHA256_BLOCK_SIZE] = {
 };
 
 /*
- * Sha256TransformFunction
+ * Sha256TransformScalar
  *
- * Compress 512-bits
+ * Portable compression of Blocks consecutive 512-bit blocks into state. The chaining value stays in H[] across blocks
+ * and is only written back once.
  */
-static inline void Sha256TransformFunction(Sha256Context* Context, const uint8_t* Buffer) {
-	uint32_t S[8], W[SHA256_BLOCK_SIZE], t0, t1, t;
+static inline void Sha256TransformScalar(uint32_t state[8], const uint8_t* Buffer, size_t Blocks) {
+	uint32_t H[8], S[8], W[SHA256_BLOCK_SIZE], t0, t1, t;
 	int i;
-	for(i=0; i<8; i++) { S[i] = Context->state[i]; }
-	for(i=0; i<16; i++) {
-		W[i] =	(hash_cast(uint32_t,((Buffer+(4*i))[0]&255))<<24) |
-			(hash_cast(uint32_t,((Buffer+(4*i))[1]&255))<<16) |
-			(hash_cast(uint32_t,((Buffer+(4*i))[2]&255))<<8)  |
-			(hash_cast(uint32_t,((Buffer+(4*i))[3]&255)));
+	for(i=0; i<8; i++) { H[i] = state[i]; }
+	for(; Blocks > 0; Blocks--, Buffer += SHA256_BLOCK_SIZE) {
+		for(i=0; i<8; i++) { S[i] = H[i]; }
+		for(i=0; i<16; i++) {
+			W[i] =	(hash_cast(uint32_t,((Buffer+(4*i))[0]&255))<<24) |
+				(hash_cast(uint32_t,((Buffer+(4*i))[1]&255))<<16) |
+				(hash_cast(uint32_t,((Buffer+(4*i))[2]&255))<<8)  |
+				(hash_cast(uint32_t,((Buffer+(4*i))[3]&255)));
+		}
+		for(i=16; i<SHA256_BLOCK_SIZE; i++) {
+			W[i] =	(S256(W[i - 2],17) ^ S256(W[i - 2],19) ^ ((W[i - 2]&0xFFFFFFFFUL) >> (10))) + W[i - 7] +
+				(S256(W[i - 15],7) ^ S256(W[i - 15],18) ^ ((W[i - 15] & 0xFFFFFFFFUL) >> (3))) + W[i - 16];
+		}
+		for(i=0; i<SHA256_BLOCK_SIZE; i++) {
+			Sha256Round(S[0], S[1], S[2], S[3], S[4], S[5], S[6], S[7], i);
+			t = S[7]; S[7] = S[6]; S[6] = S[5]; S[5] = S[4]; S[4] = S[3];
+			S[3] = S[2]; S[2] = S[1]; S[1] = S[0]; S[0] = t;
+		}
+		for(i=0; i<8; i++) H[i] = H[i] + S[i];
 	}
-	for(i=16; i<SHA256_BLOCK_SIZE; i++) {
-		W[i] =	(S256(W[i - 2],17) ^ S256(W[i - 2],19) ^ ((W[i - 2]&0xFFFFFFFFUL) >> (10))) + W[i - 7] +
-			(S256(W[i - 15],7) ^ S256(W[i - 15],18) ^ ((W[i - 15] & 0xFFFFFFFFUL) >> (3))) + W[i - 16];
+	for(i=0; i<8; i++) state[i] = H[i];
+}
+
+#if HASH_USE_CPU_DISPATCH
+// X = W[4g..4g+3] from the four previous message groups (A = g-4, B = g-3, C = g-2, D = g-1); A is overwritten
+#define SHA256NI_SCHEDULE(A, B, C, D) \
+	A = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(A, B), _mm_alignr_epi8(D, C, 4)), D);
+// Four rounds with message group X and round constants SHAK256[4g..4g+3]
+#define SHA256NI_ROUNDS(X, g) \
+	msg = _mm_add_epi32(X, _mm_loadu_si128(uhash_c_cast(const __m128i*, SHAK256 + 4 * (g)))); \
+	state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+	msg = _mm_shuffle_epi32(msg, 0x0E); \
+	state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+/*
+ * Sha256TransformShaNi
+ *
+ * Compresses Blocks consecutive 512-bit blocks with the x86 SHA extensions (SHA256RNDS2/SHA256MSG1/SHA256MSG2). The
+ * state is kept in the ABEF/CDGH register layout the instructions expect for the whole run.
+ */
+LIBHASH_TARGET("sha,sse4.1")
+static void Sha256TransformShaNi(uint32_t state[8], const uint8_t* Buffer, size_t Blocks) {
+	const __m128i shuf = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+	__m128i state0, state1, abef, cdgh, msg, tmp, m0, m1, m2, m3;
+
+	tmp    = _mm_loadu_si128(uhash_c_cast(const __m128i*, state));
+	state1 = _mm_loadu_si128(uhash_c_cast(const __m128i*, state + 4));
+	tmp    = _mm_shuffle_epi32(tmp, 0xB1);		// CDAB
+	state1 = _mm_shuffle_epi32(state1, 0x1B);	// EFGH
+	state0 = _mm_alignr_epi8(tmp, state1, 8);	// ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);	// CDGH
+
+	while(Blocks--) {
+		abef = state0;
+		cdgh = state1;
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, Buffer)), shuf);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, Buffer + 16)), shuf);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, Buffer + 32)), shuf);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128(uhash_c_cast(const __m128i*, Buffer + 48)), shuf);
+		SHA256NI_ROUNDS(m0, 0)
+		SHA256NI_ROUNDS(m1, 1)
+		SHA256NI_ROUNDS(m2, 2)
+		SHA256NI_ROUNDS(m3, 3)
+		SHA256NI_SCHEDULE(m0, m1, m2, m3) SHA256NI_ROUNDS(m0, 4)
+		SHA256NI_SCHEDULE(m1, m2, m3, m0) SHA256NI_ROUNDS(m1, 5)
+		SHA256NI_SCHEDULE(m2, m3, m0, m1) SHA256NI_ROUNDS(m2, 6)
+		SHA256NI_SCHEDULE(m3, m0, m1, m2) SHA256NI_ROUNDS(m3, 7)
+		SHA256NI_SCHEDULE(m0, m1, m2, m3) SHA256NI_ROUNDS(m0, 8)
+		SHA256NI_SCHEDULE(m1, m2, m3, m0) SHA256NI_ROUNDS(m1, 9)
+		SHA256NI_SCHEDULE(m2, m3, m0, m1) SHA256NI_ROUNDS(m2, 10)
+		SHA256NI_SCHEDULE(m3, m0, m1, m2) SHA256NI_ROUNDS(m3, 11)
+		SHA256NI_SCHEDULE(m0, m1, m2, m3) SHA256NI_ROUNDS(m0, 12)
+		SHA256NI_SCHEDULE(m1, m2, m3, m0) SHA256NI_ROUNDS(m1, 13)
+		SHA256NI_SCHEDULE(m2, m3, m0, m1) SHA256NI_ROUNDS(m2, 14)
+		SHA256NI_SCHEDULE(m3, m0, m1, m2) SHA256NI_ROUNDS(m3, 15)
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+		Buffer += SHA256_BLOCK_SIZE;
 	}
-	for(i=0; i<SHA256_BLOCK_SIZE; i++) {
-		Sha256Round(S[0], S[1], S[2], S[3], S[4], S[5], S[6], S[7], i);
-		t = S[7]; S[7] = S[6]; S[6] = S[5]; S[5] = S[4]; S[4] = S[3];
-		S[3] = S[2]; S[2] = S[1]; S[1] = S[0]; S[0] = t;
+
+	tmp    = _mm_shuffle_epi32(state0, 0x1B);	// FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1);	// DCHG
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0);	// DCBA
+	state1 = _mm_alignr_epi8(state1, tmp, 8);	// HGFE
+	_mm_storeu_si128(uhash_c_cast(__m128i*, state), state0);
+	_mm_storeu_si128(uhash_c_cast(__m128i*, state + 4), state1);
+}
+
+#undef SHA256NI_SCHEDULE
+#undef SHA256NI_ROUNDS
+#endif
+
+/*
+ * Sha256TransformBlocks
+ *
+ * Compresses Blocks consecutive 512-bit blocks into state, using the SHA extensions when the CPU has them. Shared by
+ * SHA-224, which runs the same compression function.
+ */
+static inline void Sha256TransformBlocks(uint32_t state[8], const uint8_t* Buffer, size_t Blocks) {
+#if HASH_USE_CPU_DISPATCH
+	if(libhash_cpu_features() & HASH_CPU_SHA) {
+		Sha256TransformShaNi(state, Buffer, Blocks);
+		return;
 	}
-	for(i=0; i<8; i++) Context->state[i] = Context->state[i] + S[i];
+#endif
+	Sha256TransformScalar(state, Buffer, Blocks);
+}
+
+/*
+ * Sha256TransformFunction
+ *
+ * Compress Blocks x 512-bits
+ */
+static inline void Sha256TransformFunction(Sha256Context* Context, const uint8_t* Buffer, size_t Blocks) {
+	Sha256TransformBlocks(Context->state, Buffer, Blocks);
 }
 
 /*
@@ -163,10 +271,11 @@ LIBHASH_INLINE_API void Sha256Update(Sha256Context* Context, const void* Buffer,
     if(Context->curlen > sizeof(Context->buf)) return;
     while(BufferSize > 0) {
 	if(Context->curlen == 0 && BufferSize >= SHA256_BLOCK_SIZE) {
-		Sha256TransformFunction(Context, hash_c_cast(uint8_t*,Buffer));
-		Context->length += (SHA256_BLOCK_SIZE * 8);
-		Buffer = hash_c_cast(uint8_t*, Buffer) + SHA256_BLOCK_SIZE;
-		BufferSize -= SHA256_BLOCK_SIZE;
+		n = BufferSize & ~hash_cast(uint32_t, SHA256_BLOCK_SIZE - 1);
+		Sha256TransformFunction(Context, hash_c_cast(uint8_t*,Buffer), n / SHA256_BLOCK_SIZE);
+		Context->length += (hash_cast(uint64_t, n) * 8);
+		Buffer = hash_c_cast(uint8_t*, Buffer) + n;
+		BufferSize -= n;
 	} else {
 		n = ((BufferSize<(SHA256_BLOCK_SIZE-Context->curlen))?BufferSize:(SHA256_BLOCK_SIZE-Context->curlen));
 		memcpy(Context->buf + Context->curlen, Buffer, hash_cast(size_t, n));
@@ -174,7 +283,7 @@ LIBHASH_INLINE_API void Sha256Update(Sha256Context* Context, const void* Buffer,
 		Buffer = hash_c_cast(uint8_t*, Buffer) + n;
 		BufferSize -= n;
 		if(Context->curlen == SHA256_BLOCK_SIZE) {
-			Sha256TransformFunction(Context, Context->buf);
+			Sha256TransformFunction(Context, Context->buf, 1);
 			Context->length += (SHA256_BLOCK_SIZE * 8);
 			Context->curlen = 0;
 		}
@@ -194,7 +303,7 @@ LIBHASH_INLINE_API void Sha256Finalise(Sha256Context* Context, SHA256_HASH* Dige
 	Context->buf[Context->curlen++] = hash_cast(uint8_t, 0x80);
 	if(Context->curlen > 56) {
 		while(Context->curlen < SHA256_BLOCK_SIZE) Context->buf[Context->curlen++] = hash_cast(uint8_t,0);
-		Sha256TransformFunction(Context, Context->buf);
+		Sha256TransformFunction(Context, Context->buf, 1);
 		Context->curlen = 0;
 	}
 	while(Context->curlen < 56) Context->buf[Context->curlen++] = hash_cast(uint8_t, 0);
@@ -206,7 +315,7 @@ LIBHASH_INLINE_API void Sha256Finalise(Sha256Context* Context, SHA256_HASH* Dige
 	(Context->buf + 56)[5] = hash_cast(uint8_t,(((Context->length) >> 16) & 255));
 	(Context->buf + 56)[6] = hash_cast(uint8_t,(((Context->length) >> 8) & 255));
 	(Context->buf + 56)[7] = hash_cast(uint8_t,((Context->length) & 255));
-	Sha256TransformFunction(Context, Context->buf);
+	Sha256TransformFunction(Context, Context->buf, 1);
 	for(int i=0; i<8; i++) {
 	  (Digest->bytes+(4 * i))[0] = hash_cast(uint8_t,(((Context->state[i]) >> 24) & 255));
 	  (Digest->bytes+(4 * i))[1] = hash_cast(uint8_t,(((Context->state[i]) >> 16) & 255));
@@ -228,6 +337,222 @@ LIBHASH_INLINE_API void Sha256Calculate(const void* Buffer, uint32_t BufferSize,
 	Sha256Finalise(&context, Digest);
 }
 
+/*
+ * Sha256UpdateLarge
+ *
+ * Sha256Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha256UpdateLarge(Sha256Context* Context, const void* Buffer, size_t BufferSize) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, Buffer);
+	for(; BufferSize > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, BufferSize -= HASH_LARGE_STRIDE)
+		Sha256Update(Context, p, HASH_LARGE_STRIDE);
+	Sha256Update(Context, p, hash_cast(uint32_t, BufferSize));
+}
+
+/*
+ * Sha256CalculateLarge
+ *
+ * Sha256Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha256CalculateLarge(const void* Buffer, size_t BufferSize, SHA256_HASH* Digest) {
+	Sha256Context context;
+	Sha256Initialise(&context);
+	Sha256UpdateLarge(&context, Buffer, BufferSize);
+	Sha256Finalise(&context, Digest);
+}
+
+/*
+ * Multi-buffer SHA-256
+ *
+ * Independent messages are hashed in lockstep, eight per AVX2 register or sixteen per AVX-512 register. State and
+ * message words are kept transposed: State[j][lane] is working variable j of a lane and W[i][lane] is message word i of
+ * the block that lane is currently compressing.
+ */
+#if HASH_USE_CPU_DISPATCH
+#define SHA256X8_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+/*
+ * Sha256CompressX8Avx2
+ *
+ * Compresses one block in each of 8 lanes.
+ */
+LIBHASH_TARGET("avx2")
+static void Sha256CompressX8Avx2(uint32_t State[8][HASH_LANES_MAX], const uint32_t W[16][HASH_LANES_MAX]) {
+	__m256i w[16], a, b, c, d, e, f, g, h, t0, t1, x, y;
+	int i;
+	a = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[0]));
+	b = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[1]));
+	c = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[2]));
+	d = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[3]));
+	e = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[4]));
+	f = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[5]));
+	g = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[6]));
+	h = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[7]));
+	for(i = 0; i < 16; i++) w[i] = _mm256_loadu_si256(uhash_c_cast(const __m256i*, W[i]));
+	for(i = 0; i < 64; i++) {
+		if(i >= 16) {
+			x = w[(i - 15) & 15];
+			y = w[(i - 2) & 15];
+			x = _mm256_xor_si256(_mm256_xor_si256(SHA256X8_ROTR(x, 7), SHA256X8_ROTR(x, 18)), _mm256_srli_epi32(x, 3));
+			y = _mm256_xor_si256(_mm256_xor_si256(SHA256X8_ROTR(y, 17), SHA256X8_ROTR(y, 19)), _mm256_srli_epi32(y, 10));
+			w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], x), _mm256_add_epi32(w[(i - 7) & 15], y));
+		}
+		t0 = _mm256_xor_si256(_mm256_xor_si256(SHA256X8_ROTR(e, 6), SHA256X8_ROTR(e, 11)), SHA256X8_ROTR(e, 25));
+		t0 = _mm256_add_epi32(_mm256_add_epi32(h, t0), _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g)));
+		t0 = _mm256_add_epi32(_mm256_add_epi32(t0, w[i & 15]), _mm256_set1_epi32(hash_cast(int, SHAK256[i])));
+		t1 = _mm256_xor_si256(_mm256_xor_si256(SHA256X8_ROTR(a, 2), SHA256X8_ROTR(a, 13)), SHA256X8_ROTR(a, 22));
+		t1 = _mm256_add_epi32(t1, _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))));
+		h = g; g = f; f = e;
+		e = _mm256_add_epi32(d, t0);
+		d = c; c = b; b = a;
+		a = _mm256_add_epi32(t0, t1);
+	}
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[0]), _mm256_add_epi32(a, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[0]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[1]), _mm256_add_epi32(b, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[1]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[2]), _mm256_add_epi32(c, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[2]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[3]), _mm256_add_epi32(d, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[3]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[4]), _mm256_add_epi32(e, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[4]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[5]), _mm256_add_epi32(f, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[5]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[6]), _mm256_add_epi32(g, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[6]))));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[7]), _mm256_add_epi32(h, _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[7]))));
+}
+
+#undef SHA256X8_ROTR
+
+/*
+ * Sha256CompressX16Avx512
+ *
+ * Compresses one block in each of 16 lanes. Ch and Maj are single VPTERNLOGD operations.
+ */
+LIBHASH_TARGET("avx512f")
+static void Sha256CompressX16Avx512(uint32_t State[8][HASH_LANES_MAX], const uint32_t W[16][HASH_LANES_MAX]) {
+	__m512i s[8], w[16], a, b, c, d, e, f, g, h, t0, t1, x, y;
+	int i;
+	for(i = 0; i < 8; i++) s[i] = _mm512_loadu_si512(State[i]);
+	for(i = 0; i < 16; i++) w[i] = _mm512_loadu_si512(W[i]);
+	a = s[0]; b = s[1]; c = s[2]; d = s[3];
+	e = s[4]; f = s[5]; g = s[6]; h = s[7];
+	for(i = 0; i < 64; i++) {
+		if(i >= 16) {
+			x = w[(i - 15) & 15];
+			y = w[(i - 2) & 15];
+			x = _mm512_ternarylogic_epi32(_mm512_ror_epi32(x, 7), _mm512_ror_epi32(x, 18), _mm512_srli_epi32(x, 3), 0x96);
+			y = _mm512_ternarylogic_epi32(_mm512_ror_epi32(y, 17), _mm512_ror_epi32(y, 19), _mm512_srli_epi32(y, 10), 0x96);
+			w[i & 15] = _mm512_add_epi32(_mm512_add_epi32(w[i & 15], x), _mm512_add_epi32(w[(i - 7) & 15], y));
+		}
+		t0 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25), 0x96);
+		t0 = _mm512_add_epi32(_mm512_add_epi32(h, t0), _mm512_ternarylogic_epi32(e, f, g, 0xCA));
+		t0 = _mm512_add_epi32(_mm512_add_epi32(t0, w[i & 15]), _mm512_set1_epi32(hash_cast(int, SHAK256[i])));
+		t1 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22), 0x96);
+		t1 = _mm512_add_epi32(t1, _mm512_ternarylogic_epi32(a, b, c, 0xE8));
+		h = g; g = f; f = e;
+		e = _mm512_add_epi32(d, t0);
+		d = c; c = b; b = a;
+		a = _mm512_add_epi32(t0, t1);
+	}
+	_mm512_storeu_si512(State[0], _mm512_add_epi32(a, s[0]));
+	_mm512_storeu_si512(State[1], _mm512_add_epi32(b, s[1]));
+	_mm512_storeu_si512(State[2], _mm512_add_epi32(c, s[2]));
+	_mm512_storeu_si512(State[3], _mm512_add_epi32(d, s[3]));
+	_mm512_storeu_si512(State[4], _mm512_add_epi32(e, s[4]));
+	_mm512_storeu_si512(State[5], _mm512_add_epi32(f, s[5]));
+	_mm512_storeu_si512(State[6], _mm512_add_epi32(g, s[6]));
+	_mm512_storeu_si512(State[7], _mm512_add_epi32(h, s[7]));
+}
+#endif
+
+/*
+ * Sha256BatchLanes
+ *
+ * Number of lanes the batch kernels run in parallel on this CPU, or 1 when hashing one message at a time is faster
+ * (no vector unit, or SHA extensions without AVX-512).
+ */
+static inline size_t Sha256BatchLanes(void) {
+#if HASH_USE_CPU_DISPATCH
+	uint32_t features = libhash_cpu_features();
+	if(features & HASH_CPU_AVX512F) return 16;
+	if(features & HASH_CPU_SHA) return 1;
+	if(features & HASH_CPU_AVX2) return 8;
+#endif
+	return 1;
+}
+
+/*
+ * Sha256LaneStart
+ *
+ * Loads a message into a lane and resets the lane's column of the transposed state.
+ */
+static inline void Sha256LaneStart(HashLane* Lane, uint32_t State[8][HASH_LANES_MAX], size_t Index,
+				   const void* Buffer, size_t BufferSize) {
+	static const uint32_t iv[8] = {
+		0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL, 0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+	};
+	int i;
+	HashLaneLoad(Lane, Buffer, BufferSize, SHA256_BLOCK_SIZE, 8, HASH_LANE_BIG_ENDIAN);
+	for(i = 0; i < 8; i++) State[i][Index] = iv[i];
+}
+
+/*
+ * Sha256CalculateBatch
+ *
+ * Calculates the SHA256 hash of Count independent buffers (Buffers[i] of Sizes[i] bytes into Digests[i]). Messages
+ * are spread over the SIMD lanes; a lane that finishes its message is refilled with the next one, so messages of
+ * different lengths keep every lane busy. Produces exactly the same digests as calling Sha256Calculate on each buffer.
+ */
+LIBHASH_INLINE_API void Sha256CalculateBatch(const void* const* Buffers, const size_t* Sizes, size_t Count,
+					     SHA256_HASH* Digests) {
+	HashLane lanes[HASH_LANES_MAX];
+	uint32_t state[8][HASH_LANES_MAX];
+#if HASH_USE_CPU_DISPATCH
+	uint32_t message[16][HASH_LANES_MAX];
+	const uint8_t* block;
+#endif
+	size_t job[HASH_LANES_MAX], width = Sha256BatchLanes(), next = 0, active = 0, l;
+	int i;
+
+	if(width < 2 || Count < 2) {
+		for(; next < Count; next++) Sha256CalculateLarge(Buffers[next], Sizes[next], &Digests[next]);
+		return;
+	}
+	for(l = 0; l < width; l++) {
+		job[l] = Count;
+		if(next < Count) {
+			Sha256LaneStart(&lanes[l], state, l, Buffers[next], Sizes[next]);
+			job[l] = next++;
+			active++;
+		}
+	}
+	while(active > 0) {
+#if HASH_USE_CPU_DISPATCH
+		for(l = 0; l < width; l++) {
+			block = (job[l] < Count) ? HashLaneNext(&lanes[l]) : HashLaneZeroBlock;
+			for(i = 0; i < 16; i++) {
+				message[i][l] = (hash_cast(uint32_t, block[4 * i]) << 24) | (hash_cast(uint32_t, block[4 * i + 1]) << 16) |
+						(hash_cast(uint32_t, block[4 * i + 2]) << 8) | hash_cast(uint32_t, block[4 * i + 3]);
+			}
+		}
+		if(width == 16) Sha256CompressX16Avx512(state, message);
+		else Sha256CompressX8Avx2(state, message);
+#endif
+		for(l = 0; l < width; l++) {
+			if(job[l] >= Count || !HashLaneDone(&lanes[l])) continue;
+			for(i = 0; i < 8; i++) {
+				(Digests[job[l]].bytes + (4 * i))[0] = hash_cast(uint8_t, ((state[i][l] >> 24) & 255));
+				(Digests[job[l]].bytes + (4 * i))[1] = hash_cast(uint8_t, ((state[i][l] >> 16) & 255));
+				(Digests[job[l]].bytes + (4 * i))[2] = hash_cast(uint8_t, ((state[i][l] >> 8) & 255));
+				(Digests[job[l]].bytes + (4 * i))[3] = hash_cast(uint8_t, (state[i][l] & 255));
+			}
+			if(next < Count) {
+				Sha256LaneStart(&lanes[l], state, l, Buffers[next], Sizes[next]);
+				job[l] = next++;
+			} else {
+				job[l] = Count;
+				active--;
+			}
+		}
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,10 @@
 #include <stdint.h>
 #include <memory.h>
 #include <string.h>
+#include <stddef.h>
+
+#include "cpufeatures.h"
+#include "multibuffer.h"
 
 #if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
 #define inline __inline
@@ -56,6 +60,11 @@
 #define LIBHASH_INLINE_API static inline
 #endif
 
+// size_t lengths are fed to the 32-bit entry points in pieces of this many bytes (a multiple of every block size)
+#ifndef HASH_LARGE_STRIDE
+#define HASH_LARGE_STRIDE	0x40000000U
+#endif
+
 #define hash_c_cast(t,p)	((t)(intptr_t)(p))
 #define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
 
@@ -113,25 +122,20 @@ static const uint64_t SHAK512[80] = {
 	0x4cc5d4becb3e42b6ULL,0x597f299cfc657e2aULL,0x5fcb6fab3ad6faecULL,0x6c44198c4a475817ULL
 };
 
+static const uint64_t SHA512_IV[8] = {
+	0x6a09e667f3bcc908ULL,0xbb67ae8584caa73bULL,0x3c6ef372fe94f82bULL,0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL,0x9b05688c2b3e6c1fULL,0x1f83d9abfb41bd6bULL,0x5be0cd19137e2179ULL
+};
+
 /*
- *  Sha512TransformFunction
+ *  Sha512Rounds
  *
- *  Compress 1024-bits
+ *  The 80 rounds of one block over an expanded message schedule W, added into the chaining value H.
  */
-static inline void Sha512TransformFunction(Sha512Context* Context, const uint8_t* Buffer) {
-    uint64_t S[8], W[80], t0, t1;
+static LIBHASH_FORCE_INLINE void Sha512Rounds(uint64_t H[8], const uint64_t W[80]) {
+    uint64_t S[8], t0, t1;
     int i;
-    for(i=0; i<8; i++) { S[i] = Context->state[i]; }
-    for(i=0; i<16; i++) {
-	W[i] =	(hash_cast(uint64_t,((Buffer+(8*i))[0]&255))<<56)|(hash_cast(uint64_t,((Buffer+(8*i))[1] & 255))<<48)|
-		(hash_cast(uint64_t,((Buffer+(8*i))[2]&255))<<40)|(hash_cast(uint64_t,((Buffer+(8*i))[3] & 255))<<32)|
-		(hash_cast(uint64_t,((Buffer+(8*i))[4]&255))<<24)|(hash_cast(uint64_t,((Buffer+(8*i))[5] & 255))<<16)|
-		(hash_cast(uint64_t,((Buffer+(8*i))[6]&255))<<8) |(hash_cast(uint64_t,((Buffer+(8*i))[7] & 255)));
-    }
-    for(i=16; i<80; i++) {
-	W[i] =	(S512(W[i-2],19)^S512(W[i-2],61)^(((W[i-2])&0xFFFFFFFFFFFFFFFFULL)>>hash_cast(uint64_t,6)))+W[i-7] +
-		(S512(W[i-15], 1)^S512(W[i-15], 8)^(((W[i-15])&0xFFFFFFFFFFFFFFFFULL)>>hash_cast(uint64_t,7)))+W[i-16];
-    }
+    for(i=0; i<8; i++) { S[i] = H[i]; }
     for(i=0; i<80; i+=8) {
 	Sha512Round(S[0],S[1],S[2],S[3],S[4],S[5],S[6],S[7],i+0);
 	Sha512Round(S[7],S[0],S[1],S[2],S[3],S[4],S[5],S[6],i+1);
@@ -142,7 +146,122 @@ static inline void Sha512TransformFunction(Sha512Context* Context, const uint8_t
 	Sha512Round(S[2],S[3],S[4],S[5],S[6],S[7],S[0],S[1],i+6);
 	Sha512Round(S[1],S[2],S[3],S[4],S[5],S[6],S[7],S[0],i+7);
     }
-    for(i=0; i<8; i++) Context->state[i] = Context->state[i] + S[i];
+    for(i=0; i<8; i++) H[i] = H[i] + S[i];
+}
+
+/*
+ *  Sha512TransformScalar
+ *
+ *  Portable compression of Blocks x 1024-bits. The chaining value stays in H[] across blocks and is only written back
+ *  once.
+ */
+static inline void Sha512TransformScalar(uint64_t state[8], const uint8_t* Buffer, size_t Blocks) {
+    uint64_t H[8], W[80];
+    int i;
+    for(i=0; i<8; i++) { H[i] = state[i]; }
+    for(; Blocks > 0; Blocks--, Buffer += SHA512_BLOCK_SIZE) {
+	for(i=0; i<16; i++) {
+	    W[i] =	(hash_cast(uint64_t,((Buffer+(8*i))[0]&255))<<56)|(hash_cast(uint64_t,((Buffer+(8*i))[1] & 255))<<48)|
+			(hash_cast(uint64_t,((Buffer+(8*i))[2]&255))<<40)|(hash_cast(uint64_t,((Buffer+(8*i))[3] & 255))<<32)|
+			(hash_cast(uint64_t,((Buffer+(8*i))[4]&255))<<24)|(hash_cast(uint64_t,((Buffer+(8*i))[5] & 255))<<16)|
+			(hash_cast(uint64_t,((Buffer+(8*i))[6]&255))<<8) |(hash_cast(uint64_t,((Buffer+(8*i))[7] & 255)));
+	}
+	for(i=16; i<80; i++) {
+	    W[i] =	(S512(W[i-2],19)^S512(W[i-2],61)^(((W[i-2])&0xFFFFFFFFFFFFFFFFULL)>>hash_cast(uint64_t,6)))+W[i-7] +
+			(S512(W[i-15], 1)^S512(W[i-15], 8)^(((W[i-15])&0xFFFFFFFFFFFFFFFFULL)>>hash_cast(uint64_t,7)))+W[i-16];
+	}
+	Sha512Rounds(H, W);
+    }
+    for(i=0; i<8; i++) state[i] = H[i];
+}
+
+#if HASH_USE_CPU_DISPATCH
+#define SHA512X4_ROTR(x, n)  _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define SHA512X4_SIGMA0(x)   _mm256_xor_si256(_mm256_xor_si256(SHA512X4_ROTR(x, 1), SHA512X4_ROTR(x, 8)), _mm256_srli_epi64(x, 7))
+#define SHA512X4_SIGMA1(x)   _mm256_xor_si256(_mm256_xor_si256(SHA512X4_ROTR(x, 19), SHA512X4_ROTR(x, 61)), _mm256_srli_epi64(x, 6))
+#define SHA512X4_BSIGMA0(x)  _mm256_xor_si256(_mm256_xor_si256(SHA512X4_ROTR(x, 28), SHA512X4_ROTR(x, 34)), SHA512X4_ROTR(x, 39))
+#define SHA512X4_BSIGMA1(x)  _mm256_xor_si256(_mm256_xor_si256(SHA512X4_ROTR(x, 14), SHA512X4_ROTR(x, 18)), SHA512X4_ROTR(x, 41))
+
+/*
+ *  Sha512TransformAvx2
+ *
+ *  Compression with the message schedule computed four words per 256-bit register. W[i+2] and W[i+3] depend on W[i]
+ *  and W[i+1] of the same group, so sigma1 is applied in two halves: first over W[i-2..i-1], then over the freshly
+ *  computed low half moved into the upper lanes. The last 16 words stay in registers, so the schedule never reloads
+ *  what it has just stored. The rounds are inlined and built with BMI2, so the rotates become RORX.
+ */
+LIBHASH_TARGET("avx2,bmi2")
+static void Sha512TransformAvx2(uint64_t state[8], const uint8_t* Buffer, size_t Blocks) {
+    const __m256i bswap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+					   7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t H[8], W[80];
+    __m256i x, y, x0, x1, x2, x3;
+    int i;
+    for(i=0; i<8; i++) { H[i] = state[i]; }
+    for(; Blocks > 0; Blocks--, Buffer += SHA512_BLOCK_SIZE) {
+	x0 = _mm256_shuffle_epi8(_mm256_loadu_si256(uhash_c_cast(const __m256i*, Buffer)), bswap);
+	x1 = _mm256_shuffle_epi8(_mm256_loadu_si256(uhash_c_cast(const __m256i*, Buffer + 32)), bswap);
+	x2 = _mm256_shuffle_epi8(_mm256_loadu_si256(uhash_c_cast(const __m256i*, Buffer + 64)), bswap);
+	x3 = _mm256_shuffle_epi8(_mm256_loadu_si256(uhash_c_cast(const __m256i*, Buffer + 96)), bswap);
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, W), x0);
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, W + 4), x1);
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, W + 8), x2);
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, W + 12), x3);
+	// x0..x3 hold W[i-16..i-1]; W[i-15..i-12] and W[i-7..i-4] are formed in registers
+	for(i=16; i<80; i+=4) {
+	    y = _mm256_alignr_epi8(_mm256_permute2x128_si256(x0, x1, 0x21), x0, 8);
+	    x = _mm256_add_epi64(x0, SHA512X4_SIGMA0(y));
+	    x = _mm256_add_epi64(x, _mm256_alignr_epi8(_mm256_permute2x128_si256(x2, x3, 0x21), x2, 8));
+	    y = _mm256_permute2x128_si256(x3, x3, 0x81);
+	    x = _mm256_add_epi64(x, SHA512X4_SIGMA1(y));
+	    y = _mm256_blend_epi32(zero, _mm256_permute4x64_epi64(x, 0x44), 0xF0);
+	    x = _mm256_add_epi64(x, SHA512X4_SIGMA1(y));
+	    _mm256_storeu_si256(uhash_c_cast(__m256i*, W + i), x);
+	    x0 = x1; x1 = x2; x2 = x3; x3 = x;
+	}
+	Sha512Rounds(H, W);
+    }
+    for(i=0; i<8; i++) state[i] = H[i];
+}
+#endif
+
+/*
+ *  Sha512TransformBlocks
+ *
+ *  Compress Blocks x 1024-bits into state, with the AVX2 message schedule when the CPU has it. This is the single
+ *  SHA-512 compression function behind SHA-512, SHA-384, SHA-512/256 and SHA-512/224.
+ */
+static inline void Sha512TransformBlocks(uint64_t state[8], const uint8_t* Buffer, size_t Blocks) {
+#if HASH_USE_CPU_DISPATCH
+    if((libhash_cpu_features() & (HASH_CPU_AVX2 | HASH_CPU_BMI2)) == (HASH_CPU_AVX2 | HASH_CPU_BMI2)) {
+	Sha512TransformAvx2(state, Buffer, Blocks);
+	return;
+    }
+#endif
+    Sha512TransformScalar(state, Buffer, Blocks);
+}
+
+/*
+ *  Sha512TransformFunction
+ *
+ *  Compress Blocks x 1024-bits
+ */
+static inline void Sha512TransformFunction(Sha512Context* Context, const uint8_t* Buffer, size_t Blocks) {
+    Sha512TransformBlocks(Context->state, Buffer, Blocks);
+}
+
+/*
+ *  Sha512InitialiseWithIV
+ *
+ *  Resets a SHA-512 family context to the given initial hash value. SHA-384, SHA-512/256 and SHA-512/224 differ from
+ *  SHA-512 only in this value and in how much of the final state they output.
+ */
+static inline void Sha512InitialiseWithIV(Sha512Context* Context, const uint64_t IV[8]) {
+	int i;
+	Context->curlen = 0;
+	Context->length = 0;
+	for(i=0; i<8; i++) Context->state[i] = IV[i];
 }
 
 /*
@@ -151,16 +270,7 @@ static inline void Sha512TransformFunction(Sha512Context* Context, const uint8_t
  *  Initialises a SHA512 Context. Use this to initialise/reset a context.
  */
 LIBHASH_INLINE_API void Sha512Initialise(Sha512Context* Context) {
-	Context->curlen = 0;
-	Context->length = 0;
-	Context->state[0] = 0x6a09e667f3bcc908ULL;
-	Context->state[1] = 0xbb67ae8584caa73bULL;
-	Context->state[2] = 0x3c6ef372fe94f82bULL;
-	Context->state[3] = 0xa54ff53a5f1d36f1ULL;
-	Context->state[4] = 0x510e527fade682d1ULL;
-	Context->state[5] = 0x9b05688c2b3e6c1fULL;
-	Context->state[6] = 0x1f83d9abfb41bd6bULL;
-	Context->state[7] = 0x5be0cd19137e2179ULL;
+	Sha512InitialiseWithIV(Context, SHA512_IV);
 }
 
 /*
@@ -174,10 +284,11 @@ LIBHASH_INLINE_API void Sha512Update(Sha512Context* Context, const void* Buffer,
     if(Context->curlen > sizeof(Context->buf)) return;
     while(BufferSize > 0) {
 	if(Context->curlen==0&&BufferSize>=SHA512_BLOCK_SIZE) {
-	    Sha512TransformFunction(Context,hash_c_cast(uint8_t*,Buffer));
-	    Context->length+=SHA512_BLOCK_SIZE * 8;
-	    Buffer=hash_c_cast(uint8_t*,Buffer)+SHA512_BLOCK_SIZE;
-	    BufferSize-=SHA512_BLOCK_SIZE;
+	    n = BufferSize & ~hash_cast(uint32_t, SHA512_BLOCK_SIZE - 1);
+	    Sha512TransformFunction(Context,hash_c_cast(uint8_t*,Buffer), n / SHA512_BLOCK_SIZE);
+	    Context->length+=hash_cast(uint64_t, n) * 8;
+	    Buffer=hash_c_cast(uint8_t*,Buffer)+n;
+	    BufferSize-=n;
 	} else {
 	    n = (((BufferSize)<(SHA512_BLOCK_SIZE - Context->curlen))?(BufferSize):(SHA512_BLOCK_SIZE-Context->curlen));
 	    memcpy(Context->buf + Context->curlen, Buffer, hash_cast(size_t,n));
@@ -185,7 +296,7 @@ LIBHASH_INLINE_API void Sha512Update(Sha512Context* Context, const void* Buffer,
 	    Buffer = hash_c_cast(uint8_t*,Buffer)+n;
 	    BufferSize -= n;
 	    if(Context->curlen == SHA512_BLOCK_SIZE) {
-		Sha512TransformFunction(Context, Context->buf);
+		Sha512TransformFunction(Context, Context->buf, 1);
 		Context->length += 8*SHA512_BLOCK_SIZE;
 		Context->curlen = 0;
 	    }
@@ -194,18 +305,19 @@ LIBHASH_INLINE_API void Sha512Update(Sha512Context* Context, const void* Buffer,
 }
 
 /*
- *  Sha512Finalise
+ *  Sha512FinaliseDigest
  *
- *  Performs the final calculation of the hash and returns the digest (64 byte buffer containing 512bit hash). After
- *  calling this, Sha512Initialised must be used to reuse the context.
+ *  Pads the message, runs the final compression and writes the first DigestSize bytes of the big-endian state to
+ *  Digest. The upper 64 bits of the 128-bit message length are always zero since the context counts bits in 64 bits.
  */
-LIBHASH_INLINE_API void Sha512Finalise(Sha512Context* Context, SHA512_HASH* Digest) {
+static inline void Sha512FinaliseDigest(Sha512Context* Context, uint8_t* Digest, uint32_t DigestSize) {
+    uint32_t i;
     if (Context->curlen >= sizeof(Context->buf)) return;
     Context->length += Context->curlen * 8ULL;
     Context->buf[Context->curlen++] = hash_cast(uint8_t,0x80);
     if (Context->curlen > 112) {
 	while (Context->curlen < SHA512_BLOCK_SIZE) Context->buf[Context->curlen++] = hash_cast(uint8_t,0);
-	Sha512TransformFunction(Context, Context->buf);
+	Sha512TransformFunction(Context, Context->buf, 1);
 	Context->curlen = 0;
     }
     while (Context->curlen < 120) Context->buf[Context->curlen++] = hash_cast(uint8_t,0);
@@ -217,17 +329,19 @@ LIBHASH_INLINE_API void Sha512Finalise(Sha512Context* Context, SHA512_HASH* Dige
     (Context->buf+120)[5] = hash_cast(uint8_t,(((Context->length) >> 16) & 255));
     (Context->buf+120)[6] = hash_cast(uint8_t,(((Context->length) >> 8) & 255));
     (Context->buf +120)[7] = hash_cast(uint8_t,((Context->length) & 255));
-    Sha512TransformFunction(Context, Context->buf);
-    for (int i=0; i<8; i++) {
-	(Digest->bytes+(8 * i))[0] = hash_cast(uint8_t,(((Context->state[i]) >> 56) & 255));
-	(Digest->bytes+(8 * i))[1] = hash_cast(uint8_t,(((Context->state[i]) >> 48) & 255));
-	(Digest->bytes+(8 * i))[2] = hash_cast(uint8_t,(((Context->state[i]) >> 40) & 255));
-	(Digest->bytes+(8 * i))[3] = hash_cast(uint8_t,(((Context->state[i]) >> 32) & 255));
-	(Digest->bytes+(8 * i))[4] = hash_cast(uint8_t,(((Context->state[i]) >> 24) & 255));
-	(Digest->bytes+(8 * i))[5] = hash_cast(uint8_t,(((Context->state[i]) >> 16) & 255));
-	(Digest->bytes+(8 * i))[6] = hash_cast(uint8_t,(((Context->state[i]) >> 8) & 255));
-	(Digest->bytes+(8 * i))[7] = hash_cast(uint8_t,((Context->state[i]) & 255));
-    }
+    Sha512TransformFunction(Context, Context->buf, 1);
+    for (i=0; i<DigestSize; i++)
+	Digest[i] = hash_cast(uint8_t,((Context->state[i >> 3] >> (56 - 8 * (i & 7))) & 255));
+}
+
+/*
+ *  Sha512Finalise
+ *
+ *  Performs the final calculation of the hash and returns the digest (64 byte buffer containing 512bit hash). After
+ *  calling this, Sha512Initialised must be used to reuse the context.
+ */
+LIBHASH_INLINE_API void Sha512Finalise(Sha512Context* Context, SHA512_HASH* Digest) {
+    Sha512FinaliseDigest(Context, Digest->bytes, SHA512_HASH_SIZE);
 }
 
 
@@ -244,6 +358,189 @@ LIBHASH_INLINE_API void Sha512Calculate(const void* Buffer, uint32_t BufferSize,
 	Sha512Finalise(&context, Digest);
 }
 
+/*
+ * Sha512UpdateLarge
+ *
+ * Sha512Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha512UpdateLarge(Sha512Context* Context, const void* Buffer, size_t BufferSize) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, Buffer);
+	for(; BufferSize > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, BufferSize -= HASH_LARGE_STRIDE)
+		Sha512Update(Context, p, HASH_LARGE_STRIDE);
+	Sha512Update(Context, p, hash_cast(uint32_t, BufferSize));
+}
+
+/*
+ * Sha512CalculateLarge
+ *
+ * Sha512Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha512CalculateLarge(const void* Buffer, size_t BufferSize, SHA512_HASH* Digest) {
+	Sha512Context context;
+	Sha512Initialise(&context);
+	Sha512UpdateLarge(&context, Buffer, BufferSize);
+	Sha512Finalise(&context, Digest);
+}
+
+/*
+ * Multi-buffer SHA-512
+ *
+ * Four independent messages are compressed in lockstep, one per 64-bit lane of an AVX2 register. State and message
+ * words are kept transposed: State[j][lane] is working variable j of a lane and W[i][lane] is message word i.
+ */
+#define SHA512_LANES 4
+
+#if HASH_USE_CPU_DISPATCH
+/*
+ * Sha512CompressX4Avx2
+ *
+ * Compresses one block in each of the 4 lanes.
+ */
+LIBHASH_TARGET("avx2")
+static void Sha512CompressX4Avx2(uint64_t State[8][SHA512_LANES], const uint64_t W[16][SHA512_LANES]) {
+	__m256i s[8], w[16], a, b, c, d, e, f, g, h, t0, t1;
+	int i;
+	for(i = 0; i < 8; i++) s[i] = _mm256_loadu_si256(uhash_c_cast(const __m256i*, State[i]));
+	for(i = 0; i < 16; i++) w[i] = _mm256_loadu_si256(uhash_c_cast(const __m256i*, W[i]));
+	a = s[0]; b = s[1]; c = s[2]; d = s[3];
+	e = s[4]; f = s[5]; g = s[6]; h = s[7];
+	for(i = 0; i < 80; i++) {
+		if(i >= 16) {
+			t0 = _mm256_add_epi64(SHA512X4_SIGMA0(w[(i - 15) & 15]), SHA512X4_SIGMA1(w[(i - 2) & 15]));
+			w[i & 15] = _mm256_add_epi64(_mm256_add_epi64(w[i & 15], w[(i - 7) & 15]), t0);
+		}
+		t0 = _mm256_add_epi64(h, SHA512X4_BSIGMA1(e));
+		t0 = _mm256_add_epi64(t0, _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g)));
+		t0 = _mm256_add_epi64(_mm256_add_epi64(t0, w[i & 15]), _mm256_set1_epi64x(hash_cast(long long, SHAK512[i])));
+		t1 = _mm256_add_epi64(SHA512X4_BSIGMA0(a),
+				      _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))));
+		h = g; g = f; f = e;
+		e = _mm256_add_epi64(d, t0);
+		d = c; c = b; b = a;
+		a = _mm256_add_epi64(t0, t1);
+	}
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[0]), _mm256_add_epi64(a, s[0]));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[1]), _mm256_add_epi64(b, s[1]));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[2]), _mm256_add_epi64(c, s[2]));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[3]), _mm256_add_epi64(d, s[3]));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[4]), _mm256_add_epi64(e, s[4]));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[5]), _mm256_add_epi64(f, s[5]));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[6]), _mm256_add_epi64(g, s[6]));
+	_mm256_storeu_si256(uhash_c_cast(__m256i*, State[7]), _mm256_add_epi64(h, s[7]));
+}
+
+#undef SHA512X4_ROTR
+#undef SHA512X4_SIGMA0
+#undef SHA512X4_SIGMA1
+#undef SHA512X4_BSIGMA0
+#undef SHA512X4_BSIGMA1
+#endif
+
+/*
+ * Sha512CalculateWithIV
+ *
+ * One-shot SHA-512 family hash of a size_t length buffer, writing the first DigestSize bytes of the state.
+ */
+static inline void Sha512CalculateWithIV(const void* Buffer, size_t BufferSize, const uint64_t IV[8],
+					 uint8_t* Digest, uint32_t DigestSize) {
+	Sha512Context context;
+	Sha512InitialiseWithIV(&context, IV);
+	Sha512UpdateLarge(&context, Buffer, BufferSize);
+	Sha512FinaliseDigest(&context, Digest, DigestSize);
+}
+
+/*
+ * Sha512LaneStart
+ *
+ * Loads a message into a lane and resets the lane's column of the transposed state to IV.
+ */
+static inline void Sha512LaneStart(HashLane* Lane, uint64_t State[8][SHA512_LANES], size_t Index,
+				   const void* Buffer, size_t BufferSize, const uint64_t IV[8]) {
+	int i;
+	HashLaneLoad(Lane, Buffer, BufferSize, SHA512_BLOCK_SIZE, 16, HASH_LANE_BIG_ENDIAN);
+	for(i = 0; i < 8; i++) State[i][Index] = IV[i];
+}
+
+#if HASH_USE_CPU_DISPATCH
+/*
+ * Sha512CalculateBatchAvx2
+ *
+ * AVX2 lane driver of Sha512CalculateBatchWithIV: four messages are compressed side by side and lanes that finish
+ * are refilled with the next message.
+ */
+static inline void Sha512CalculateBatchAvx2(const void* const* Buffers, const size_t* Sizes, size_t Count,
+					    const uint64_t IV[8], uint8_t* Digests, uint32_t DigestSize) {
+	HashLane lanes[SHA512_LANES];
+	uint64_t state[8][SHA512_LANES], message[16][SHA512_LANES];
+	size_t job[SHA512_LANES], next = 0, active = 0, l;
+	const uint8_t* block;
+	uint32_t i;
+
+	for(l = 0; l < SHA512_LANES; l++) {
+		job[l] = Count;
+		if(next < Count) {
+			Sha512LaneStart(&lanes[l], state, l, Buffers[next], Sizes[next], IV);
+			job[l] = next++;
+			active++;
+		}
+	}
+	while(active > 0) {
+		for(l = 0; l < SHA512_LANES; l++) {
+			block = (job[l] < Count) ? HashLaneNext(&lanes[l]) : HashLaneZeroBlock;
+			for(i = 0; i < 16; i++) {
+				message[i][l] = (hash_cast(uint64_t, block[8 * i]) << 56) | (hash_cast(uint64_t, block[8 * i + 1]) << 48) |
+						(hash_cast(uint64_t, block[8 * i + 2]) << 40) | (hash_cast(uint64_t, block[8 * i + 3]) << 32) |
+						(hash_cast(uint64_t, block[8 * i + 4]) << 24) | (hash_cast(uint64_t, block[8 * i + 5]) << 16) |
+						(hash_cast(uint64_t, block[8 * i + 6]) << 8) | hash_cast(uint64_t, block[8 * i + 7]);
+			}
+		}
+		Sha512CompressX4Avx2(state, message);
+		for(l = 0; l < SHA512_LANES; l++) {
+			if(job[l] >= Count || !HashLaneDone(&lanes[l])) continue;
+			for(i = 0; i < DigestSize; i++)
+				Digests[job[l] * DigestSize + i] = hash_cast(uint8_t, (state[i >> 3][l] >> (56 - 8 * (i & 7))) & 255);
+			if(next < Count) {
+				Sha512LaneStart(&lanes[l], state, l, Buffers[next], Sizes[next], IV);
+				job[l] = next++;
+			} else {
+				job[l] = Count;
+				active--;
+			}
+		}
+	}
+}
+#endif
+
+/*
+ * Sha512CalculateBatchWithIV
+ *
+ * Batch driver shared by the SHA-512 family. Digest i is written to Digests + i * DigestSize. With AVX2 the messages
+ * go through Sha512CalculateBatchAvx2, otherwise they are hashed one after another.
+ */
+static inline void Sha512CalculateBatchWithIV(const void* const* Buffers, const size_t* Sizes, size_t Count,
+					      const uint64_t IV[8], uint8_t* Digests, uint32_t DigestSize) {
+	size_t next;
+#if HASH_USE_CPU_DISPATCH
+	if(Count >= 2 && (libhash_cpu_features() & HASH_CPU_AVX2)) {
+		Sha512CalculateBatchAvx2(Buffers, Sizes, Count, IV, Digests, DigestSize);
+		return;
+	}
+#endif
+	for(next = 0; next < Count; next++)
+		Sha512CalculateWithIV(Buffers[next], Sizes[next], IV, Digests + next * DigestSize, DigestSize);
+}
+
+/*
+ * Sha512CalculateBatch
+ *
+ * Calculates the SHA512 hash of Count independent buffers (Buffers[i] of Sizes[i] bytes into Digests[i]), four at a
+ * time in AVX2 lanes when the CPU supports it. Produces the same digests as calling Sha512Calculate on each buffer.
+ */
+LIBHASH_INLINE_API void Sha512CalculateBatch(const void* const* Buffers, const size_t* Sizes, size_t Count,
+					     SHA512_HASH* Digests) {
+	Sha512CalculateBatchWithIV(Buffers, Sizes, Count, SHA512_IV, uhash_c_cast(uint8_t*, Digests), SHA512_HASH_SIZE);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,161 @@
+/**
+ * WjCryptLib_Sha512_224
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SHA512_224_H__
+#define __SHA512_224_H__
+
+#include <stdint.h>
+#include <memory.h>
+#include <string.h>
+
+#include "sha512.h"
+
+#if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
+#define inline __inline
+#endif
+
+#ifndef LIBHASH_VISIBILITY
+#if (defined(__GNUC__) &&  (__GNUC__ >= 4) && (__GNUC_MINOR__ > 2)) || __has_attribute(visibility)
+#define LIBHASH_VISIBILITY(V) __attribute__ ((visibility (#V)))
+#else
+#define LIBHASH_VISIBILITY(V)
+#endif
+#endif
+
+#ifndef LIBHASH_EXPORT
+#if defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+#define LIBHASH_EXPORT __declspec(dllexport) LIBHASH_VISIBILITY(default)
+#else
+#define LIBHASH_EXPORT LIBHASH_VISIBILITY(default)
+#endif
+#endif
+
+#ifndef LIBHASH_IMPORT
+#if defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+#define LIBHASH_IMPORT __declspec(dllimport) LIBHASH_VISIBILITY(default)
+#else
+#define LIBHASH_IMPORT LIBHASH_VISIBILITY(default)
+#endif
+#endif
+
+#ifndef LIBHASH_INLINE_API
+#define LIBHASH_INLINE_API static inline
+#endif
+
+#define hash_c_cast(t,p)	((t)(intptr_t)(p))
+#define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
+
+#ifdef __cplusplus
+#define hash_cast(t,p) static_cast<t>(p)
+#define uhash_cast(t,p) reinterpret_cast<t>(p)
+#else
+#define hash_cast hash_c_cast
+#define uhash_cast uhash_c_cast
+#endif
+
+#define SHA512_224_BLOCK_SIZE SHA512_BLOCK_SIZE
+#define SHA512_224_HASH_SIZE  28
+
+// SHA-512/224 (FIPS 180-4) is SHA-512 with its own initial value, truncated to 224 bits
+typedef Sha512Context Sha512_224Context;
+
+typedef struct {
+	uint8_t bytes[SHA512_224_HASH_SIZE];
+} SHA512_224_HASH;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint64_t SHA512_224_IV[8] = {
+	0x8c3d37c819544da2ULL,0x73e1996689dcd4d6ULL,0x1dfab7ae32ff9c82ULL,0x679dd514582f9fcfULL,
+	0x0f6d2b697bd44da8ULL,0x77e36f7304c48942ULL,0x3f9d85a86a1d36c8ULL,0x1112e6ad91d692a1ULL
+};
+
+/*
+ * Sha512_224Initialise
+ *
+ * Initialises a SHA-512/224 Context. Use this to initialise/reset a context.
+ */
+LIBHASH_INLINE_API void Sha512_224Initialise(Sha512_224Context* Context) {
+	Sha512InitialiseWithIV(Context, SHA512_224_IV);
+}
+
+/*
+ * Sha512_224Update
+ *
+ * Adds data to the SHA-512/224 context. This will process the data and update the internal state of the context.
+ * Keep on calling this function until all the data has been added. Then call Sha512_224Finalise to calculate the hash.
+ */
+LIBHASH_INLINE_API void Sha512_224Update(Sha512_224Context* Context, const void* Buffer, uint32_t BufferSize) {
+	Sha512Update(Context, Buffer, BufferSize);
+}
+
+/*
+ * Sha512_224Finalise
+ *
+ * Performs the final calculation of the hash and returns the digest (28 byte buffer containing 224bit hash).
+ * After calling this, Sha512_224Initialise must be used to reuse the context.
+ */
+LIBHASH_INLINE_API void Sha512_224Finalise(Sha512_224Context* Context, SHA512_224_HASH* Digest) {
+	Sha512FinaliseDigest(Context, Digest->bytes, SHA512_224_HASH_SIZE);
+}
+
+/*
+ * Sha512_224Calculate
+ *
+ * Combines Sha512_224Initialise, Sha512_224Update, and Sha512_224Finalise into one function. Calculates the SHA-512/224 hash of the
+ * buffer.
+ */
+LIBHASH_INLINE_API void Sha512_224Calculate(const void* Buffer, uint32_t BufferSize, SHA512_224_HASH* Digest) {
+	Sha512_224Context context;
+	Sha512_224Initialise(&context);
+	Sha512_224Update(&context, Buffer, BufferSize);
+	Sha512_224Finalise(&context, Digest);
+}
+
+/*
+ * Sha512_224UpdateLarge
+ *
+ * Sha512_224Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha512_224UpdateLarge(Sha512_224Context* Context, const void* Buffer, size_t BufferSize) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, Buffer);
+	for(; BufferSize > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, BufferSize -= HASH_LARGE_STRIDE)
+		Sha512_224Update(Context, p, HASH_LARGE_STRIDE);
+	Sha512_224Update(Context, p, hash_cast(uint32_t, BufferSize));
+}
+
+/*
+ * Sha512_224CalculateLarge
+ *
+ * Sha512_224Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha512_224CalculateLarge(const void* Buffer, size_t BufferSize, SHA512_224_HASH* Digest) {
+	Sha512_224Context context;
+	Sha512_224Initialise(&context);
+	Sha512_224UpdateLarge(&context, Buffer, BufferSize);
+	Sha512_224Finalise(&context, Digest);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SHA512_224_H__ */
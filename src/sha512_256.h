@@ -0,0 +1,161 @@
+/**
+ * WjCryptLib_Sha512_256
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SHA512_256_H__
+#define __SHA512_256_H__
+
+#include <stdint.h>
+#include <memory.h>
+#include <string.h>
+
+#include "sha512.h"
+
+#if defined(_MSC_VER) && _MSC_VER < 1900 && !defined(inline)
+#define inline __inline
+#endif
+
+#ifndef LIBHASH_VISIBILITY
+#if (defined(__GNUC__) &&  (__GNUC__ >= 4) && (__GNUC_MINOR__ > 2)) || __has_attribute(visibility)
+#define LIBHASH_VISIBILITY(V) __attribute__ ((visibility (#V)))
+#else
+#define LIBHASH_VISIBILITY(V)
+#endif
+#endif
+
+#ifndef LIBHASH_EXPORT
+#if defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+#define LIBHASH_EXPORT __declspec(dllexport) LIBHASH_VISIBILITY(default)
+#else
+#define LIBHASH_EXPORT LIBHASH_VISIBILITY(default)
+#endif
+#endif
+
+#ifndef LIBHASH_IMPORT
+#if defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64)
+#define LIBHASH_IMPORT __declspec(dllimport) LIBHASH_VISIBILITY(default)
+#else
+#define LIBHASH_IMPORT LIBHASH_VISIBILITY(default)
+#endif
+#endif
+
+#ifndef LIBHASH_INLINE_API
+#define LIBHASH_INLINE_API static inline
+#endif
+
+#define hash_c_cast(t,p)	((t)(intptr_t)(p))
+#define uhash_c_cast(t,p)	((t)(uintptr_t)(p))
+
+#ifdef __cplusplus
+#define hash_cast(t,p) static_cast<t>(p)
+#define uhash_cast(t,p) reinterpret_cast<t>(p)
+#else
+#define hash_cast hash_c_cast
+#define uhash_cast uhash_c_cast
+#endif
+
+#define SHA512_256_BLOCK_SIZE SHA512_BLOCK_SIZE
+#define SHA512_256_HASH_SIZE  32
+
+// SHA-512/256 (FIPS 180-4) is SHA-512 with its own initial value, truncated to 256 bits
+typedef Sha512Context Sha512_256Context;
+
+typedef struct {
+	uint8_t bytes[SHA512_256_HASH_SIZE];
+} SHA512_256_HASH;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint64_t SHA512_256_IV[8] = {
+	0x22312194fc2bf72cULL,0x9f555fa3c84c64c2ULL,0x2393b86b6f53b151ULL,0x963877195940eabdULL,
+	0x96283ee2a88effe3ULL,0xbe5e1e2553863992ULL,0x2b0199fc2c85b8aaULL,0x0eb72ddc81c52ca2ULL
+};
+
+/*
+ * Sha512_256Initialise
+ *
+ * Initialises a SHA-512/256 Context. Use this to initialise/reset a context.
+ */
+LIBHASH_INLINE_API void Sha512_256Initialise(Sha512_256Context* Context) {
+	Sha512InitialiseWithIV(Context, SHA512_256_IV);
+}
+
+/*
+ * Sha512_256Update
+ *
+ * Adds data to the SHA-512/256 context. This will process the data and update the internal state of the context.
+ * Keep on calling this function until all the data has been added. Then call Sha512_256Finalise to calculate the hash.
+ */
+LIBHASH_INLINE_API void Sha512_256Update(Sha512_256Context* Context, const void* Buffer, uint32_t BufferSize) {
+	Sha512Update(Context, Buffer, BufferSize);
+}
+
+/*
+ * Sha512_256Finalise
+ *
+ * Performs the final calculation of the hash and returns the digest (32 byte buffer containing 256bit hash).
+ * After calling this, Sha512_256Initialise must be used to reuse the context.
+ */
+LIBHASH_INLINE_API void Sha512_256Finalise(Sha512_256Context* Context, SHA512_256_HASH* Digest) {
+	Sha512FinaliseDigest(Context, Digest->bytes, SHA512_256_HASH_SIZE);
+}
+
+/*
+ * Sha512_256Calculate
+ *
+ * Combines Sha512_256Initialise, Sha512_256Update, and Sha512_256Finalise into one function. Calculates the SHA-512/256 hash of the
+ * buffer.
+ */
+LIBHASH_INLINE_API void Sha512_256Calculate(const void* Buffer, uint32_t BufferSize, SHA512_256_HASH* Digest) {
+	Sha512_256Context context;
+	Sha512_256Initialise(&context);
+	Sha512_256Update(&context, Buffer, BufferSize);
+	Sha512_256Finalise(&context, Digest);
+}
+
+/*
+ * Sha512_256UpdateLarge
+ *
+ * Sha512_256Update for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha512_256UpdateLarge(Sha512_256Context* Context, const void* Buffer, size_t BufferSize) {
+	const uint8_t* p = hash_c_cast(const uint8_t*, Buffer);
+	for(; BufferSize > HASH_LARGE_STRIDE; p += HASH_LARGE_STRIDE, BufferSize -= HASH_LARGE_STRIDE)
+		Sha512_256Update(Context, p, HASH_LARGE_STRIDE);
+	Sha512_256Update(Context, p, hash_cast(uint32_t, BufferSize));
+}
+
+/*
+ * Sha512_256CalculateLarge
+ *
+ * Sha512_256Calculate for a size_t length.
+ */
+LIBHASH_INLINE_API void Sha512_256CalculateLarge(const void* Buffer, size_t BufferSize, SHA512_256_HASH* Digest) {
+	Sha512_256Context context;
+	Sha512_256Initialise(&context);
+	Sha512_256UpdateLarge(&context, Buffer, BufferSize);
+	Sha512_256Finalise(&context, Digest);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SHA512_256_H__ */
@@ -0,0 +1,272 @@
+/**
+ * WjCryptLib_ThreadPool
+ *
+ * Copyright (C) 2025 MrR736 <MrR736@users.github.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// Worker thread pool
+//
+// User can define HASH_USE_THREADS to 0 before including any header to run
+// every job on the calling thread. When enabled, a process-wide pool of worker
+// threads is started on first use and kept for the lifetime of the process, so
+// large buffers can be split across cores without paying thread creation on
+// every call. The environment variable LIBHASH_THREADS (decimal) overrides the
+// number of threads, LIBHASH_THREADS=1 disables the workers.
+//
+// LIBHASH_ONCE(&once, Init) runs Init exactly once per libhash_once_t, other
+// first callers waiting until it has returned; it also guards lazily built
+// lookup tables.
+// -----------------------------------------------------------------------------
+
+#ifndef HASH_USE_THREADS
+# if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+#  define HASH_USE_THREADS 1
+# else
+#  define HASH_USE_THREADS 0
+# endif
+#endif
+
+#define HASH_POOL_THREADS_MAX	64
+
+#if HASH_USE_THREADS
+# if defined(_WIN32)
+#  include <windows.h>
+typedef SRWLOCK			libhash_mutex_t;
+typedef CONDITION_VARIABLE	libhash_cond_t;
+#  define LIBHASH_MUTEX_INIT(m)		InitializeSRWLock(m)
+#  define LIBHASH_MUTEX_LOCK(m)		AcquireSRWLockExclusive(m)
+#  define LIBHASH_MUTEX_TRYLOCK(m)	TryAcquireSRWLockExclusive(m)
+#  define LIBHASH_MUTEX_UNLOCK(m)	ReleaseSRWLockExclusive(m)
+#  define LIBHASH_MUTEX_DESTROY(m)	((void)(m))
+#  define LIBHASH_COND_INIT(c)		InitializeConditionVariable(c)
+#  define LIBHASH_COND_WAIT(c, m)	SleepConditionVariableSRW(c, m, INFINITE, 0)
+#  define LIBHASH_COND_BROADCAST(c)	WakeAllConditionVariable(c)
+#  define LIBHASH_COND_DESTROY(c)	((void)(c))
+typedef INIT_ONCE		libhash_once_t;
+#  define LIBHASH_ONCE_INIT		INIT_ONCE_STATIC_INIT
+#  define LIBHASH_ONCE(o, f)		InitOnceExecuteOnce(o, libhash_once_call, (PVOID)(f), NULL)
+static BOOL CALLBACK libhash_once_call(PINIT_ONCE Once, PVOID Param, PVOID* Context) {
+	(void)Once; (void)Context;
+	((void (*)(void))Param)();
+	return TRUE;
+}
+# else
+#  include <pthread.h>
+#  include <unistd.h>
+typedef pthread_mutex_t		libhash_mutex_t;
+typedef pthread_cond_t		libhash_cond_t;
+#  define LIBHASH_MUTEX_INIT(m)		pthread_mutex_init(m, NULL)
+#  define LIBHASH_MUTEX_LOCK(m)		pthread_mutex_lock(m)
+#  define LIBHASH_MUTEX_TRYLOCK(m)	(pthread_mutex_trylock(m) == 0)
+#  define LIBHASH_MUTEX_UNLOCK(m)	pthread_mutex_unlock(m)
+#  define LIBHASH_MUTEX_DESTROY(m)	pthread_mutex_destroy(m)
+#  define LIBHASH_COND_INIT(c)		pthread_cond_init(c, NULL)
+#  define LIBHASH_COND_WAIT(c, m)	pthread_cond_wait(c, m)
+#  define LIBHASH_COND_BROADCAST(c)	pthread_cond_broadcast(c)
+#  define LIBHASH_COND_DESTROY(c)	pthread_cond_destroy(c)
+typedef pthread_once_t		libhash_once_t;
+#  define LIBHASH_ONCE_INIT		PTHREAD_ONCE_INIT
+#  define LIBHASH_ONCE(o, f)		pthread_once(o, f)
+# endif
+#else
+typedef int			libhash_once_t;
+# define LIBHASH_ONCE_INIT		0
+# define LIBHASH_ONCE(o, f)		do { if (!*(o)) { *(o) = 1; f(); } } while (0)
+#endif
+
+// Relaxed load and store of a size_t tunable that calls on other threads read while it may be changed
+#if HASH_USE_THREADS && defined(__GNUC__)
+# define LIBHASH_ATOMIC_LOAD(p)		__atomic_load_n(p, __ATOMIC_RELAXED)
+# define LIBHASH_ATOMIC_STORE(p, v)	__atomic_store_n(p, v, __ATOMIC_RELAXED)
+#elif HASH_USE_THREADS && defined(_MSC_VER)
+# define LIBHASH_ATOMIC_LOAD(p)		(*(const volatile size_t*)(p))
+# define LIBHASH_ATOMIC_STORE(p, v)	(*(volatile size_t*)(p) = (v))
+#else
+# define LIBHASH_ATOMIC_LOAD(p)		(*(p))
+# define LIBHASH_ATOMIC_STORE(p, v)	(*(p) = (v))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * libhash_pool_task
+ *
+ * One job is Count calls of a task, Index running from 0 to Count-1. Calls may run concurrently and in any order.
+ */
+typedef void (*libhash_pool_task)(void* Arg, uint32_t Index);
+
+#if HASH_USE_THREADS
+typedef struct {
+	libhash_mutex_t		Lock;		// guards every field below
+	libhash_mutex_t		Busy;		// held by the thread that owns the current job
+	libhash_cond_t		Wake;		// a new job was posted
+	libhash_cond_t		Done;		// the last task of the job finished
+	libhash_pool_task	Task;
+	void*			Arg;
+	uint32_t		Count;
+	uint32_t		Next;		// next task index to hand out
+	uint32_t		Pending;	// tasks of the job not finished yet
+	uint32_t		Threads;	// workers plus the calling thread
+	uint64_t		Generation;	// bumped for every job
+} libhash_pool;
+
+static libhash_pool libhash_pool_instance;
+
+/*
+ * libhash_pool_drain
+ *
+ * Runs tasks of the current job until none are left to hand out. Called with Lock held, returns with Lock held.
+ */
+static inline void libhash_pool_drain(libhash_pool* Pool) {
+	while (Pool->Next < Pool->Count) {
+		libhash_pool_task task = Pool->Task;
+		void* arg = Pool->Arg;
+		uint32_t index = Pool->Next++;
+		LIBHASH_MUTEX_UNLOCK(&Pool->Lock);
+		task(arg, index);
+		LIBHASH_MUTEX_LOCK(&Pool->Lock);
+		if (--Pool->Pending == 0) LIBHASH_COND_BROADCAST(&Pool->Done);
+	}
+}
+
+# if defined(_WIN32)
+static DWORD WINAPI libhash_pool_worker(LPVOID Param)
+# else
+static void* libhash_pool_worker(void* Param)
+# endif
+{
+	libhash_pool* pool = (libhash_pool*)Param;
+	uint64_t seen;
+	LIBHASH_MUTEX_LOCK(&pool->Lock);
+	seen = pool->Generation;
+	for (;;) {
+		while (pool->Generation == seen) LIBHASH_COND_WAIT(&pool->Wake, &pool->Lock);
+		seen = pool->Generation;
+		libhash_pool_drain(pool);
+	}
+	LIBHASH_MUTEX_UNLOCK(&pool->Lock);
+	return 0;
+}
+
+static inline uint32_t libhash_pool_default_threads(void) {
+	const char* env = getenv("LIBHASH_THREADS");
+	long n;
+	if (env != NULL && (n = strtol(env, NULL, 10)) > 0) return (n > HASH_POOL_THREADS_MAX) ? HASH_POOL_THREADS_MAX : (uint32_t)n;
+# if defined(_WIN32)
+	{
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		n = (long)info.dwNumberOfProcessors;
+	}
+# else
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+# endif
+	if (n < 1) n = 1;
+	return (n > HASH_POOL_THREADS_MAX) ? HASH_POOL_THREADS_MAX : (uint32_t)n;
+}
+
+static inline void libhash_pool_start(void) {
+	libhash_pool* pool = &libhash_pool_instance;
+	uint32_t wanted = libhash_pool_default_threads(), i;
+	LIBHASH_MUTEX_INIT(&pool->Lock);
+	LIBHASH_MUTEX_INIT(&pool->Busy);
+	LIBHASH_COND_INIT(&pool->Wake);
+	LIBHASH_COND_INIT(&pool->Done);
+	pool->Threads = 1;
+	for (i = 1; i < wanted; i++) {
+# if defined(_WIN32)
+		HANDLE thread = CreateThread(NULL, 0, libhash_pool_worker, pool, 0, NULL);
+		if (thread == NULL) break;
+		CloseHandle(thread);
+# else
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, libhash_pool_worker, pool) != 0) break;
+		pthread_detach(thread);
+# endif
+		pool->Threads++;
+	}
+}
+
+/*
+ * libhash_pool_get
+ *
+ * Returns the process-wide pool, starting its workers on the first call.
+ */
+static inline libhash_pool* libhash_pool_get(void) {
+	static libhash_once_t once = LIBHASH_ONCE_INIT;
+	LIBHASH_ONCE(&once, libhash_pool_start);
+	return &libhash_pool_instance;
+}
+#endif
+
+/*
+ * libhash_pool_threads
+ *
+ * Number of threads a job can run on, the calling thread included.
+ */
+static inline uint32_t libhash_pool_threads(void) {
+#if HASH_USE_THREADS
+	return libhash_pool_get()->Threads;
+#else
+	return 1;
+#endif
+}
+
+/*
+ * libhash_pool_run
+ *
+ * Runs Task(Arg, 0) .. Task(Arg, Count-1) on the pool and returns once all of them have finished. The calling thread
+ * takes tasks as well. If the pool is already running a job for another caller (or a task itself calls
+ * libhash_pool_run) the tasks simply run on the calling thread.
+ */
+static inline void libhash_pool_run(libhash_pool_task Task, void* Arg, uint32_t Count) {
+	uint32_t i;
+#if HASH_USE_THREADS
+	libhash_pool* pool;
+	if (Count > 1 && (pool = libhash_pool_get())->Threads > 1 && LIBHASH_MUTEX_TRYLOCK(&pool->Busy)) {
+		LIBHASH_MUTEX_LOCK(&pool->Lock);
+		pool->Task = Task;
+		pool->Arg = Arg;
+		pool->Count = Count;
+		pool->Next = 0;
+		pool->Pending = Count;
+		pool->Generation++;
+		LIBHASH_COND_BROADCAST(&pool->Wake);
+		libhash_pool_drain(pool);
+		while (pool->Pending) LIBHASH_COND_WAIT(&pool->Done, &pool->Lock);
+		LIBHASH_MUTEX_UNLOCK(&pool->Lock);
+		LIBHASH_MUTEX_UNLOCK(&pool->Busy);
+		return;
+	}
+#endif
+	for (i = 0; i < Count; i++) Task(Arg, i);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __THREADPOOL_H__ */
@@ -46,6 +46,150 @@ int main(void) {
         return 2;
     }
 
+    // 5. FIPS-197 Appendix B/C known answers for every key size (both directions)
+    {
+        static const struct {
+            uint32_t keySize;
+            uint8_t key[AES_KEY_SIZE_256];
+            uint8_t plain[AES_BLOCK_SIZE];
+            uint8_t cipher[AES_BLOCK_SIZE];
+        } vectors[] = {
+            { AES_KEY_SIZE_128,
+              { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c },
+              { 0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d, 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34 },
+              { 0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb, 0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32 } },
+            { AES_KEY_SIZE_128,
+              { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f },
+              { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff },
+              { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a } },
+            { AES_KEY_SIZE_192,
+              { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+                0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17 },
+              { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff },
+              { 0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0, 0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91 } },
+            { AES_KEY_SIZE_256,
+              { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+                0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f },
+              { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff },
+              { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 } },
+        };
+        uint8_t block[AES_BLOCK_SIZE];
+        size_t v;
+
+        for (v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++) {
+            if (AesInitialise(&ctx, vectors[v].key, vectors[v].keySize) != 0) {
+                fprintf(stderr, "AES-%u initialization failed\n", (unsigned)vectors[v].keySize * 8);
+                return 3;
+            }
+            AesEncrypt(&ctx, vectors[v].plain, block);
+            if (memcmp(block, vectors[v].cipher, AES_BLOCK_SIZE) != 0) {
+                fprintf(stderr, "AES-%u known answer %zu: encrypt mismatch\n", (unsigned)vectors[v].keySize * 8, v);
+                return 3;
+            }
+            AesDecryptInPlace(&ctx, block);
+            if (memcmp(block, vectors[v].plain, AES_BLOCK_SIZE) != 0) {
+                fprintf(stderr, "AES-%u known answer %zu: decrypt mismatch\n", (unsigned)vectors[v].keySize * 8, v);
+                return 3;
+            }
+
+            // Encrypt-only schedule: same encryption, and expanding the decryption keys matches AesInitialise
+            {
+                AesContext encOnly;
+                AesInitialiseEncryptOnly(&encOnly, vectors[v].key, vectors[v].keySize);
+                if (!(encOnly.Flags & AES_CONTEXT_NO_DECRYPT)) {
+                    fprintf(stderr, "AES-%u encrypt-only context not flagged\n", (unsigned)vectors[v].keySize * 8);
+                    return 4;
+                }
+                AesEncrypt(&encOnly, vectors[v].plain, block);
+                if (memcmp(block, vectors[v].cipher, AES_BLOCK_SIZE) != 0) {
+                    fprintf(stderr, "AES-%u encrypt-only: encrypt mismatch\n", (unsigned)vectors[v].keySize * 8);
+                    return 4;
+                }
+                AesExpandDecryptKey(&encOnly);
+                AesDecryptInPlace(&encOnly, block);
+                if (memcmp(block, vectors[v].plain, AES_BLOCK_SIZE) != 0) {
+                    fprintf(stderr, "AES-%u encrypt-only: decrypt mismatch\n", (unsigned)vectors[v].keySize * 8);
+                    return 4;
+                }
+                if (encOnly.Flags != ctx.Flags || encOnly.Nr != ctx.Nr ||
+                    memcmp(encOnly.eK, ctx.eK, 16 * (ctx.Nr + 1)) != 0 ||
+                    memcmp(encOnly.dK, ctx.dK, 16 * (ctx.Nr + 1)) != 0) {
+                    fprintf(stderr, "AES-%u expanded decrypt key differs from AesInitialise\n", (unsigned)vectors[v].keySize * 8);
+                    return 4;
+                }
+            }
+        }
+
+        if (AesInitialise(&ctx, key, 20) != -1) {
+            fprintf(stderr, "AES accepted an invalid key size\n");
+            return 3;
+        }
+    }
+
+    // 6. Bulk ECB: every count across the AES_PIPELINE groups, against block by block, then back in place
+    {
+        uint8_t data[21 * AES_BLOCK_SIZE], single[sizeof(data)], bulk[sizeof(data)];
+        AesContext encOnly;
+        size_t blocks, j;
+
+        for (j = 0; j < sizeof(data); j++) data[j] = (uint8_t)(j * 29 + 5);
+        AesInitialise(&ctx, key, AES_KEY_SIZE_128);
+        AesInitialiseEncryptOnly(&encOnly, key, AES_KEY_SIZE_128);
+        AesExpandDecryptKey(&encOnly);
+        for (blocks = 0; blocks <= sizeof(data) / AES_BLOCK_SIZE; blocks++) {
+            for (j = 0; j < blocks; j++) AesEncrypt(&ctx, data + j * AES_BLOCK_SIZE, single + j * AES_BLOCK_SIZE);
+            AesEncryptBlocks(&ctx, data, bulk, blocks);
+            if (memcmp(bulk, single, blocks * AES_BLOCK_SIZE) != 0) {
+                fprintf(stderr, "AesEncryptBlocks of %zu blocks: mismatch\n", blocks);
+                return 5;
+            }
+            AesDecryptBlocks(&ctx, bulk, bulk, blocks);
+            if (memcmp(bulk, data, blocks * AES_BLOCK_SIZE) != 0) {
+                fprintf(stderr, "AesDecryptBlocks of %zu blocks: mismatch\n", blocks);
+                return 5;
+            }
+            memcpy(bulk, single, blocks * AES_BLOCK_SIZE);
+            AesDecryptBlocks(&encOnly, bulk, bulk, blocks);
+            if (memcmp(bulk, data, blocks * AES_BLOCK_SIZE) != 0) {
+                fprintf(stderr, "AesDecryptBlocks of %zu blocks with an expanded encrypt-only key: mismatch\n", blocks);
+                return 5;
+            }
+        }
+    }
+
+    // 7. XorBuffers at every length around the vector widths, every alignment, in place; XorAesBlock
+    {
+        static uint8_t a[300 + 32], b[300 + 32], d[300 + 32], expect[300 + 32];
+        uint32_t len, off, j;
+
+        for (j = 0; j < sizeof(a); j++) { a[j] = (uint8_t)(j * 31 + 7); b[j] = (uint8_t)(j * 17 + 3); }
+        for (off = 0; off < 32; off += 3) {
+            for (len = 0; len <= 300; len++) {
+                for (j = 0; j < len; j++) expect[j] = a[off + j] ^ b[j];
+                memset(d, 0xee, sizeof(d));
+                XorBuffers(a + off, b, d + off, len);
+                if (memcmp(d + off, expect, len) != 0 || (off + len < sizeof(d) && d[off + len] != 0xee)) {
+                    fprintf(stderr, "XorBuffers of %u bytes at offset %u: mismatch\n", len, off);
+                    return 6;
+                }
+                memcpy(d, a + off, len);
+                XorBuffers(d, b, d, len);
+                if (memcmp(d, expect, len) != 0) {
+                    fprintf(stderr, "XorBuffers of %u bytes in place: mismatch\n", len);
+                    return 6;
+                }
+            }
+        }
+        memcpy(d, a + 1, AES_BLOCK_SIZE);
+        XorAesBlock(d, b + 3);
+        for (j = 0; j < AES_BLOCK_SIZE; j++) {
+            if (d[j] != (a[1 + j] ^ b[3 + j])) {
+                fprintf(stderr, "XorAesBlock: mismatch\n");
+                return 6;
+            }
+        }
+    }
+
     printf("AES test passed\n");
     return 0;
 }
@@ -71,5 +71,169 @@ int main() {
         printf("AES CBC encryption and decryption test failed!\n");
     }
 
+    // NIST SP 800-38A F.2.1 / F.2.2 (CBC-AES128)
+    {
+        static const uint8_t nistKey[16] = {
+            0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+        };
+        static const uint8_t nistPlain[64] = {
+            0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+            0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+            0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+            0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+        };
+        static const uint8_t nistCipher[64] = {
+            0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+            0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+            0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+            0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7
+        };
+        uint8_t buffer[64];
+
+        AesCbcEncryptWithKey(nistKey, sizeof(nistKey), IV, nistPlain, buffer, sizeof(buffer));
+        if (memcmp(buffer, nistCipher, sizeof(buffer)) != 0) {
+            printf("AES CBC SP 800-38A encryption failed!\n");
+            return 1;
+        }
+        AesCbcDecryptWithKey(nistKey, sizeof(nistKey), IV, buffer, buffer, sizeof(buffer));
+        if (memcmp(buffer, nistPlain, sizeof(buffer)) != 0) {
+            printf("AES CBC SP 800-38A in-place decryption failed!\n");
+            return 1;
+        }
+    }
+
+    // Multi-block decryption: in place and out of place, fed in chunks that split the 8-block groups unevenly
+    {
+        enum { BLOCKS = 203 };
+        static uint8_t plain[BLOCKS * AES_BLOCK_SIZE], cipher[BLOCKS * AES_BLOCK_SIZE];
+        static uint8_t inPlace[BLOCKS * AES_BLOCK_SIZE], outOfPlace[BLOCKS * AES_BLOCK_SIZE];
+        static const uint32_t chunks[] = { 1, 3, 8, 9, 17, 2, 64, 5 };
+        AesCbcContext a, b;
+        uint32_t offset, n, c;
+
+        for (offset = 0; offset < sizeof(plain); offset++) plain[offset] = (uint8_t)(offset * 29 + 1);
+        AesCbcEncryptWithKey(Key, AES_BLOCK_SIZE, IV, plain, cipher, sizeof(plain));
+        memcpy(inPlace, cipher, sizeof(cipher));
+        AesCbcInitialiseWithKey(&a, Key, AES_BLOCK_SIZE, IV);
+        AesCbcInitialiseWithKey(&b, Key, AES_BLOCK_SIZE, IV);
+        for (offset = 0, c = 0; offset < BLOCKS; offset += n, c++) {
+            n = chunks[c % (sizeof(chunks) / sizeof(chunks[0]))];
+            if (n > BLOCKS - offset) n = BLOCKS - offset;
+            AesCbcDecrypt(&a, inPlace + offset * AES_BLOCK_SIZE, inPlace + offset * AES_BLOCK_SIZE, n * AES_BLOCK_SIZE);
+            AesCbcDecrypt(&b, cipher + offset * AES_BLOCK_SIZE, outOfPlace + offset * AES_BLOCK_SIZE, n * AES_BLOCK_SIZE);
+        }
+        if (memcmp(inPlace, plain, sizeof(plain)) != 0 || memcmp(outOfPlace, plain, sizeof(plain)) != 0) {
+            printf("AES CBC multi-block decryption failed!\n");
+            return 1;
+        }
+    }
+
+    // Multi-stream encryption against one stream at a time: mixed key sizes and IVs, uneven lengths
+    {
+        enum { STREAMS = 19, MAXBLOCKS = 150 };
+        static uint8_t data[STREAMS][MAXBLOCKS * AES_BLOCK_SIZE];
+        static uint8_t multi[STREAMS][MAXBLOCKS * AES_BLOCK_SIZE], single[STREAMS][MAXBLOCKS * AES_BLOCK_SIZE];
+        static const uint32_t keySizes[3] = { AES_KEY_SIZE_128, AES_KEY_SIZE_192, AES_KEY_SIZE_256 };
+        AesCbcContext multiCtx[STREAMS], singleCtx[STREAMS];
+        AesCbcContext* contexts[STREAMS];
+        const void* in[STREAMS];
+        void* out[STREAMS];
+        uint32_t sizes[STREAMS];
+        uint8_t key[AES_KEY_SIZE_256], iv[AES_BLOCK_SIZE];
+        size_t i, j;
+
+        for (i = 0; i < STREAMS; i++) {
+            for (j = 0; j < sizeof(key); j++) key[j] = (uint8_t)(i * 7 + j);
+            for (j = 0; j < sizeof(iv); j++) iv[j] = (uint8_t)(i * 13 + j * 3);
+            for (j = 0; j < sizeof(data[i]); j++) data[i][j] = (uint8_t)(i + j * 5);
+            AesCbcInitialiseWithKey(&multiCtx[i], key, keySizes[i % 3], iv);
+            AesCbcInitialiseWithKey(&singleCtx[i], key, keySizes[i % 3], iv);
+            contexts[i] = &multiCtx[i];
+            in[i] = data[i];
+            out[i] = multi[i];
+            sizes[i] = (uint32_t)(((i * 37 + i * i * 11) % MAXBLOCKS) * AES_BLOCK_SIZE);
+        }
+        sizes[4] = 0;
+        sizes[5] = AES_BLOCK_SIZE;
+        for (i = 0; i < STREAMS; i++) AesCbcEncrypt(&singleCtx[i], data[i], single[i], sizes[i]);
+        if (AesCbcEncryptMulti(contexts, in, out, sizes, STREAMS) != 0) {
+            printf("AesCbcEncryptMulti failed!\n");
+            return 1;
+        }
+        for (i = 0; i < STREAMS; i++) {
+            if (memcmp(multi[i], single[i], sizes[i]) != 0 ||
+                memcmp(multiCtx[i].PreviousCipherBlock, singleCtx[i].PreviousCipherBlock, AES_BLOCK_SIZE) != 0) {
+                printf("AesCbcEncryptMulti stream %zu differs from AesCbcEncrypt!\n", i);
+                return 1;
+            }
+        }
+        sizes[2] += 1;
+        if (AesCbcEncryptMulti(contexts, in, out, sizes, STREAMS) != -1) {
+            printf("AesCbcEncryptMulti accepted a partial block!\n");
+            return 1;
+        }
+    }
+
+    // Shared contexts over one key schedule match the owned context
+    {
+        static const uint8_t key[AES_KEY_SIZE_128] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+        static const uint8_t iv[AES_BLOCK_SIZE] = { 0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87,
+                                                   0x78, 0x69, 0x5a, 0x4b, 0x3c, 0x2d, 0x1e, 0x0f };
+        uint8_t data[160], owned[160], shared[160];
+        AesContext aes;
+        AesCbcContext ctx;
+        AesCbcSharedContext enc, dec;
+        size_t i;
+        for (i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 29 + 3);
+        AesInitialise(&aes, key, sizeof(key));
+        AesCbcInitialiseWithKey(&ctx, key, sizeof(key), iv);
+        AesCbcInitialiseShared(&enc, &aes, iv);
+        AesCbcInitialiseShared(&dec, &aes, iv);
+        AesCbcEncrypt(&ctx, data, owned, sizeof(owned));
+        if (AesCbcSharedEncrypt(&enc, data, shared, 48) != 0 ||
+            AesCbcSharedEncrypt(&enc, data + 48, shared + 48, sizeof(shared) - 48) != 0 ||
+            memcmp(owned, shared, sizeof(owned)) != 0) {
+            printf("AesCbcSharedEncrypt differs from AesCbcEncrypt!\n");
+            return 1;
+        }
+        if (AesCbcSharedDecrypt(&dec, shared, shared, 64) != 0 ||
+            AesCbcSharedDecrypt(&dec, shared + 64, shared + 64, sizeof(shared) - 64) != 0 ||
+            memcmp(data, shared, sizeof(data)) != 0) {
+            printf("AesCbcSharedDecrypt round trip failed!\n");
+            return 1;
+        }
+        if (AesCbcSharedEncrypt(&enc, data, shared, 15) != -1) {
+            printf("AesCbcSharedEncrypt accepted a partial block!\n");
+            return 1;
+        }
+    }
+
+    // Encrypt-only key schedule: an owned context derives its decryption keys once, a shared one is refused
+    {
+        static const uint8_t key[AES_KEY_SIZE_128] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+        static const uint8_t iv[AES_BLOCK_SIZE] = { 0 };
+        uint8_t data[64], cipher[64], plain[64];
+        AesContext encOnly;
+        AesCbcContext enc, dec;
+        AesCbcSharedContext shared;
+        size_t i;
+        for (i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 7 + 1);
+        AesInitialiseEncryptOnly(&encOnly, key, sizeof(key));
+        AesCbcInitialise(&enc, &encOnly, iv);
+        AesCbcInitialise(&dec, &encOnly, iv);
+        AesCbcInitialiseShared(&shared, &encOnly, iv);
+        AesCbcEncrypt(&enc, data, cipher, sizeof(cipher));
+        if (AesCbcSharedDecrypt(&shared, cipher, plain, sizeof(cipher)) != -1) {
+            printf("AesCbcSharedDecrypt accepted an encrypt-only key!\n");
+            return 1;
+        }
+        if (!(dec.Aes.Flags & AES_CONTEXT_NO_DECRYPT) ||
+            AesCbcDecrypt(&dec, cipher, plain, 32) != 0 || (dec.Aes.Flags & AES_CONTEXT_NO_DECRYPT) ||
+            AesCbcDecrypt(&dec, cipher + 32, plain + 32, 32) != 0 || memcmp(plain, data, sizeof(data)) != 0) {
+            printf("AesCbcDecrypt with an encrypt-only key failed!\n");
+            return 1;
+        }
+    }
+
     return 0;
 }
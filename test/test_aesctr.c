@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L // for setenv
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
@@ -12,6 +13,9 @@ static void printHex(const char* label, uint8_t* data, size_t len) {
 }
 
 int main(void) {
+    // Use several workers even on a single core machine (read when the pool starts)
+    setenv("LIBHASH_THREADS", "4", 0);
+
     const uint8_t key[16] = {
         0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
         0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
@@ -56,6 +60,116 @@ int main(void) {
         return 4;
     }
 
+    // Keystream reference built block by block from AesEncrypt, checked against uneven chunked AesCtrXor,
+    // AesCtrOutput and AesCtrSetStreamIndex (including calls that end inside the block they started in)
+    {
+        enum { STREAM = 1000 };
+        static uint8_t reference[STREAM + AES_BLOCK_SIZE], data[STREAM], out[STREAM];
+        static const uint32_t chunks[] = { 1, 5, 3, 16, 7, 0, 9, 32, 15, 17, 129, 200, 64, 255 };
+        AesContext aes;
+        AesCtrContext ctx;
+        uint32_t offset, c, n;
+        uint64_t block;
+
+        AesInitialise(&aes, key, sizeof(key));
+        for (block = 0; block * AES_BLOCK_SIZE < STREAM; block++) {
+            uint8_t* b = reference + block * AES_BLOCK_SIZE;
+            memcpy(b, iv, AES_CTR_IV_SIZE);
+            for (n = 0; n < 8; n++) b[AES_CTR_IV_SIZE + n] = (uint8_t)(block >> (56 - 8 * n));
+            AesEncryptInPlace(&aes, b);
+        }
+        for (offset = 0; offset < STREAM; offset++) data[offset] = (uint8_t)(offset * 7 + 3);
+
+        AesCtrInitialise(&ctx, &aes, iv);
+        for (offset = 0, c = 0; offset < STREAM; offset += n, c++) {
+            n = chunks[c % (sizeof(chunks) / sizeof(chunks[0]))];
+            if (n > STREAM - offset) n = STREAM - offset;
+            AesCtrXor(&ctx, data + offset, out + offset, n);
+        }
+        for (offset = 0; offset < STREAM; offset++) {
+            if (out[offset] != (data[offset] ^ reference[offset])) {
+                fprintf(stderr, "Chunked AesCtrXor mismatch at byte %u\n", offset);
+                return 5;
+            }
+        }
+
+        AesCtrInitialise(&ctx, &aes, iv);
+        for (offset = 0, c = 3; offset < STREAM; offset += n, c++) {
+            n = chunks[c % (sizeof(chunks) / sizeof(chunks[0]))];
+            if (n > STREAM - offset) n = STREAM - offset;
+            AesCtrOutput(&ctx, out + offset, n);
+        }
+        if (memcmp(out, reference, STREAM) != 0) {
+            fprintf(stderr, "Chunked AesCtrOutput mismatch\n");
+            return 6;
+        }
+
+        for (offset = 0; offset < STREAM; offset += 37) {
+            AesCtrSetStreamIndex(&ctx, offset);
+            n = (STREAM - offset < 150) ? STREAM - offset : 150;
+            AesCtrOutput(&ctx, out, n);
+            if (memcmp(out, reference + offset, n) != 0) {
+                fprintf(stderr, "AesCtrSetStreamIndex(%u) mismatch\n", offset);
+                return 7;
+            }
+        }
+    }
+
+    // Parallel path against the serial one, from a stream position inside a block, then a follow-up call that
+    // relies on the context state left behind
+    {
+        enum { LARGE = (3 << 20) + 5 };
+        uint8_t *serial = malloc(LARGE + 100), *parallel = malloc(LARGE + 100);
+        AesCtrContext a, b;
+        int ok;
+        if (!serial || !parallel) return 1;
+        for (size_t i = 0; i < LARGE + 100; i++) serial[i] = parallel[i] = (uint8_t)(i * 11);
+        AesCtrInitialiseWithKey(&a, key, sizeof(key), iv);
+        AesCtrInitialiseWithKey(&b, key, sizeof(key), iv);
+        AesCtrSetStreamIndex(&a, 7);
+        AesCtrSetStreamIndex(&b, 7);
+        AesCtrSetParallelThreshold(0);
+        AesCtrXor(&a, serial, serial, LARGE);
+        AesCtrSetParallelThreshold(1 << 20);
+        AesCtrXor(&b, parallel, parallel, LARGE);
+        AesCtrSetParallelThreshold(AES_CTR_PARALLEL_THRESHOLD);
+        AesCtrXor(&a, serial + LARGE, serial + LARGE, 100);
+        AesCtrXor(&b, parallel + LARGE, parallel + LARGE, 100);
+        ok = memcmp(serial, parallel, LARGE + 100) == 0 && a.StreamIndex == b.StreamIndex &&
+             a.CurrentCipherBlockIndex == b.CurrentCipherBlockIndex &&
+             memcmp(a.CurrentCipherBlock, b.CurrentCipherBlock, AES_BLOCK_SIZE) == 0;
+        free(serial);
+        free(parallel);
+        if (!ok) {
+            fprintf(stderr, "Parallel AesCtrXor mismatch\n");
+            return 8;
+        }
+    }
+
+    // Two shared contexts over one key schedule produce the same stream as an owned context
+    {
+        AesContext aes;
+        AesCtrContext owned;
+        AesCtrSharedContext s1, s2;
+        uint8_t expect[300], got1[300], got2[300];
+        AesInitialiseEncryptOnly(&aes, key, sizeof(key));
+        AesCtrInitialiseWithKey(&owned, key, sizeof(key), iv);
+        AesCtrInitialiseShared(&s1, &aes, iv);
+        AesCtrInitialiseShared(&s2, &aes, iv);
+        AesCtrOutput(&owned, expect, sizeof(expect));
+        AesCtrSharedOutput(&s1, got1, 123);
+        AesCtrSharedOutput(&s1, got1 + 123, sizeof(got1) - 123);
+        AesCtrSharedSetStreamIndex(&s2, 45);
+        AesCtrSharedOutput(&s2, got2 + 45, sizeof(got2) - 45);
+        memset(got2, 0, 45);
+        AesCtrSharedSetStreamIndex(&s2, 0);
+        AesCtrSharedXor(&s2, got2, got2, 45);
+        if (memcmp(expect, got1, sizeof(expect)) != 0 || memcmp(expect, got2, sizeof(expect)) != 0) {
+            fprintf(stderr, "Shared context keystream mismatch\n");
+            return 9;
+        }
+    }
+
     printf("CTR AES test passed.\n");
     printHex("Encrypted Data", ciphertext, len);
     printf("Decrypted message: %s\n", decrypted);
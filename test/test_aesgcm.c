@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "aesgcm.h"
+
+static size_t fromHex(const char* hex, uint8_t* out) {
+    size_t n = strlen(hex) / 2;
+    for (size_t i = 0; i < n; i++) {
+        unsigned int b;
+        sscanf(hex + 2 * i, "%2x", &b);
+        out[i] = (uint8_t)b;
+    }
+    return n;
+}
+
+static void printHex(const char* label, const uint8_t* data, size_t len) {
+    printf("%s: ", label);
+    for (size_t i = 0; i < len; i++) { printf("%02x", data[i]); }
+    printf("\n");
+}
+
+#define GCM_P "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72" \
+              "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+#define GCM_A "feedfacedeadbeeffeedfacedeadbeefabaddad2"
+#define GCM_K "feffe9928665731c6d6a8f9467308308"
+
+// Test cases 2, 4, 6 and 16 of the GCM specification (McGrew & Viega)
+static const struct {
+    const char *key, *iv, *aad, *plain, *cipher, *tag;
+} vectors[] = {
+    { "00000000000000000000000000000000", "000000000000000000000000", "",
+      "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf" },
+    { GCM_K, "cafebabefacedbaddecaf888", GCM_A, GCM_P,
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+      "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091", "5bc94fbc3221a5db94fae95ae7121a47" },
+    { GCM_K, "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+             "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b", GCM_A, GCM_P,
+      "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca7"
+      "01e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5", "619cc5aefffe0bfa462af43c1699d050" },
+    { GCM_K GCM_K, "cafebabefacedbaddecaf888", GCM_A, GCM_P,
+      "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+      "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662", "76fc6ece0f4e1768cddf8853bb2d551b" },
+};
+
+int main(void) {
+    uint8_t key[32], iv[64], aad[32], plain[64], cipher[64], expect[64], tag[16], expectTag[16];
+    int ok = 1;
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        uint32_t keySize = (uint32_t)fromHex(vectors[i].key, key);
+        uint32_t ivSize = (uint32_t)fromHex(vectors[i].iv, iv);
+        uint32_t aadSize = (uint32_t)fromHex(vectors[i].aad, aad);
+        uint32_t size = (uint32_t)fromHex(vectors[i].plain, plain);
+        fromHex(vectors[i].cipher, expect);
+        fromHex(vectors[i].tag, expectTag);
+
+        if (AesGcmEncryptWithKey(key, keySize, iv, ivSize, aad, aadSize, plain, cipher, size, tag) != 0 ||
+            memcmp(cipher, expect, size) != 0 || memcmp(tag, expectTag, sizeof(tag)) != 0) {
+            printf("Vector %zu encryption FAILED\n", i);
+            printHex("Got", cipher, size);
+            printHex("Tag", tag, sizeof(tag));
+            ok = 0;
+        }
+        if (AesGcmDecryptWithKey(key, keySize, iv, ivSize, aad, aadSize, expect, cipher, size, expectTag, 16) != 0 ||
+            memcmp(cipher, plain, size) != 0) {
+            printf("Vector %zu decryption FAILED\n", i);
+            ok = 0;
+        }
+        expectTag[0] ^= 1;
+        if (AesGcmDecryptWithKey(key, keySize, iv, ivSize, aad, aadSize, expect, cipher, size, expectTag, 16) != -1) {
+            printf("Vector %zu accepted a forged tag\n", i);
+            ok = 0;
+        }
+    }
+
+    // Streaming in uneven pieces (AAD and data) against one-shot, then in-place decryption
+    {
+        enum { SIZE = 5000 + 7, AAD = 77 };
+        uint8_t *data = malloc(SIZE), *once = malloc(SIZE), *stream = malloc(SIZE);
+        uint8_t header[AAD], tagOnce[16], tagStream[16];
+        AesGcmContext ctx;
+        uint32_t offset, chunk;
+        if (!data || !once || !stream) return 1;
+        for (size_t i = 0; i < SIZE; i++) data[i] = (uint8_t)(i * 7 + 1);
+        for (size_t i = 0; i < AAD; i++) header[i] = (uint8_t)(i * 3);
+        fromHex(GCM_K, key);
+        fromHex("cafebabefacedbaddecaf888", iv);
+        AesGcmEncryptWithKey(key, 16, iv, 12, header, AAD, data, once, SIZE, tagOnce);
+
+        AesGcmInitialiseWithKey(&ctx, key, 16);
+        AesGcmStart(&ctx, iv, 12);
+        AesGcmUpdateAad(&ctx, header, 5);
+        AesGcmUpdateAad(&ctx, header + 5, 20);
+        AesGcmUpdateAad(&ctx, header + 25, AAD - 25);
+        for (offset = 0, chunk = 1; offset < SIZE; offset += chunk, chunk = chunk * 5 + 3) {
+            if (chunk > SIZE - offset) chunk = SIZE - offset;
+            AesGcmEncrypt(&ctx, data + offset, stream + offset, chunk);
+        }
+        AesGcmFinish(&ctx, tagStream);
+        if (memcmp(once, stream, SIZE) != 0 || memcmp(tagOnce, tagStream, 16) != 0) {
+            printf("Streaming encryption FAILED\n");
+            ok = 0;
+        }
+
+        AesGcmStart(&ctx, iv, 12);
+        AesGcmUpdateAad(&ctx, header, AAD);
+        for (offset = 0, chunk = 300; offset < SIZE; offset += chunk, chunk = (chunk * 3) % 1001 + 1) {
+            if (chunk > SIZE - offset) chunk = SIZE - offset;
+            AesGcmDecrypt(&ctx, stream + offset, stream + offset, chunk);
+        }
+        if (AesGcmUpdateAad(&ctx, header, 1) != -1) {
+            printf("AesGcmUpdateAad accepted AAD after data\n");
+            ok = 0;
+        }
+        if (AesGcmVerify(&ctx, tagOnce, 12) != 0 || memcmp(stream, data, SIZE) != 0) {
+            printf("Streaming decryption FAILED\n");
+            ok = 0;
+        }
+        free(data);
+        free(once);
+        free(stream);
+    }
+
+    // 32-bit counter wrap (possible with IVs other than 96 bits): counter block n is J0 with inc32 applied n+1 times
+    {
+        uint8_t data[40 * AES_BLOCK_SIZE], out[sizeof(data)], block[AES_BLOCK_SIZE];
+        AesGcmContext ctx;
+        uint32_t counter;
+        fromHex(GCM_K, key);
+        AesGcmInitialiseWithKey(&ctx, key, 16);
+        AesGcmStart(&ctx, iv, 20);
+        memset(ctx.J0 + 12, 0xff, 4);
+        ctx.J0[15] = 0xf0;
+        for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)i;
+        AesGcmEncrypt(&ctx, data, out, sizeof(data));
+        for (size_t n = 0; n < sizeof(data) / AES_BLOCK_SIZE; n++) {
+            memcpy(block, ctx.J0, AES_BLOCK_SIZE);
+            counter = 0xfffffff0U + 1 + (uint32_t)n;
+            block[12] = (uint8_t)(counter >> 24); block[13] = (uint8_t)(counter >> 16);
+            block[14] = (uint8_t)(counter >> 8); block[15] = (uint8_t)counter;
+            AesEncryptInPlace(&ctx.Aes, block);
+            for (size_t j = 0; j < AES_BLOCK_SIZE; j++) block[j] ^= data[n * AES_BLOCK_SIZE + j];
+            if (memcmp(block, out + n * AES_BLOCK_SIZE, AES_BLOCK_SIZE) != 0) {
+                printf("Counter wrap FAILED at block %zu\n", n);
+                ok = 0;
+                break;
+            }
+        }
+    }
+
+    {
+        AesGcmContext ctx;
+        if (AesGcmInitialiseWithKey(&ctx, key, 17) != -1 ||
+            (AesGcmInitialiseWithKey(&ctx, key, 16) == 0 && AesGcmStart(&ctx, iv, 0) != -1)) {
+            printf("Invalid key or IV size accepted\n");
+            ok = 0;
+        }
+    }
+
+    printf("GCM AES test %s.\n", ok ? "passed" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -1,7 +1,9 @@
+#define _POSIX_C_SOURCE 200809L // for pthreads
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <pthread.h>
 #include "aesofb.h" // Ensure this path is correct
 
 static void printHex(const char* label, uint8_t* data, size_t len) {
@@ -10,6 +12,12 @@ static void printHex(const char* label, uint8_t* data, size_t len) {
     printf("\n");
 }
 
+// Helper thread: keeps the keystream buffer full until AesOfbStopRefill
+static void* refillThread(void* arg) {
+    while (AesOfbRefillWait((AesOfbContext*)arg) != 0) {}
+    return NULL;
+}
+
 // Test AES OFB with key and IV
 int main(void) {
     const uint8_t key[AES_BLOCK_SIZE] = {
@@ -63,6 +71,105 @@ int main(void) {
         return 4;
     }
 
+    // Shared contexts over one key schedule match the owned context, also when split unevenly
+    {
+        AesContext aes;
+        AesOfbSharedContext shared;
+        uint8_t* stream = malloc(len);
+        if (!stream) return 1;
+        AesInitialiseEncryptOnly(&aes, key, sizeof(key));
+        AesOfbInitialiseShared(&shared, &aes, iv);
+        AesOfbSharedXor(&shared, message, stream, 5);
+        AesOfbSharedXor(&shared, message + 5, stream + 5, (uint32_t)(len - 5 - 20));
+        AesOfbSharedOutput(&shared, stream + len - 20, 20);
+        for (size_t i = len - 20; i < len; i++) stream[i] ^= (uint8_t)message[i];
+        if (memcmp(stream, ciphertext, len) != 0) {
+            fprintf(stderr, "Shared context mismatch!\n");
+            free(stream);
+            free(ciphertext);
+            free(decrypted);
+            return 5;
+        }
+        free(stream);
+    }
+
+    // Keystream buffer: enabled mid-block, refilled ahead, drained past its size, then released mid-stream
+    {
+        AesOfbContext ring;
+        uint8_t* stream = malloc(len);
+        size_t offset = 0;
+        uint32_t chunk = 1;
+        if (!stream) return 1;
+        AesOfbInitialiseWithKey(&ring, key, sizeof(key), iv);
+        AesOfbXor(&ring, message, stream, 3);
+        if (AesOfbEnableKeystream(&ring, 40) != 0 || AesOfbEnableKeystream(&ring, 64) != -1 ||
+            AesOfbRefill(&ring) != 16) {
+            fprintf(stderr, "Keystream buffer setup failed!\n");
+            free(stream);
+            free(ciphertext);
+            free(decrypted);
+            return 6;
+        }
+        for (offset = 3; offset < len / 2; offset += chunk, chunk = chunk * 3 % 37 + 1) {
+            if (chunk > len / 2 - offset) chunk = (uint32_t)(len / 2 - offset);
+            AesOfbXor(&ring, message + offset, stream + offset, chunk);
+            if (offset % 2) AesOfbRefill(&ring);
+        }
+        AesOfbDisableKeystream(&ring);
+        AesOfbXor(&ring, message + offset, stream + offset, (uint32_t)(len - offset));
+        if (memcmp(stream, ciphertext, len) != 0) {
+            fprintf(stderr, "Keystream buffer mismatch!\n");
+            free(stream);
+            free(ciphertext);
+            free(decrypted);
+            return 6;
+        }
+        free(stream);
+    }
+
+    // Keystream buffer refilled by a helper thread while this thread XORs, against the stream without a buffer
+    {
+        const size_t bigLen = (size_t)4 << 20;
+        AesOfbContext plain, ring;
+        pthread_t helper;
+        uint8_t* data = malloc(bigLen);
+        uint8_t* expect = malloc(bigLen);
+        uint8_t* got = malloc(bigLen);
+        size_t offset = 0;
+        uint32_t chunk = 1;
+        int ok = data && expect && got;
+        for (size_t i = 0; ok && i < bigLen; i++) data[i] = (uint8_t)(i * 7 + (i >> 9));
+        if (ok) {
+            AesOfbInitialiseWithKey(&plain, key, sizeof(key), iv);
+            AesOfbInitialiseWithKey(&ring, key, sizeof(key), iv);
+            AesOfbXorLarge(&plain, data, expect, bigLen);
+            AesOfbXor(&ring, data, got, 5);
+            ok = AesOfbEnableKeystream(&ring, 64 << 10) == 0 &&
+                 pthread_create(&helper, NULL, refillThread, &ring) == 0;
+        }
+        if (ok) {
+            for (offset = 5; offset < bigLen - 1000; offset += chunk, chunk = chunk * 5 % 4099 + 1) {
+                if (chunk > bigLen - 1000 - offset) chunk = (uint32_t)(bigLen - 1000 - offset);
+                AesOfbXor(&ring, data + offset, got + offset, chunk);
+            }
+            AesOfbStopRefill(&ring);
+            pthread_join(helper, NULL);
+            if (AesOfbRefillWait(&ring) != 0) ok = 0;
+            AesOfbDisableKeystream(&ring);
+            AesOfbXor(&ring, data + offset, got + offset, (uint32_t)(bigLen - offset));
+            ok = ok && memcmp(got, expect, bigLen) == 0;
+        }
+        free(data);
+        free(expect);
+        free(got);
+        if (!ok) {
+            fprintf(stderr, "Keystream helper thread mismatch!\n");
+            free(ciphertext);
+            free(decrypted);
+            return 7;
+        }
+    }
+
     printf("OFB AES test passed.\n");
     printHex("Encrypted Data", ciphertext, len);
     printf("Decrypted message: %s\n", decrypted);
@@ -0,0 +1,113 @@
+#define _POSIX_C_SOURCE 200809L // for setenv
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "aesxts.h"
+
+static size_t fromHex(const char* hex, uint8_t* out) {
+    size_t n = strlen(hex) / 2;
+    for (size_t i = 0; i < n; i++) {
+        unsigned int b;
+        sscanf(hex + 2 * i, "%2x", &b);
+        out[i] = (uint8_t)b;
+    }
+    return n;
+}
+
+static void printHex(const char* label, const uint8_t* data, size_t len) {
+    printf("%s: ", label);
+    for (size_t i = 0; i < len; i++) { printf("%02x", data[i]); }
+    printf("\n");
+}
+
+// IEEE 1619-2007 vectors 1, 2 and 15 (17 bytes: ciphertext stealing)
+static const struct {
+    const char* key;
+    uint64_t sector;
+    const char *plain, *cipher;
+} vectors[] = {
+    { "0000000000000000000000000000000000000000000000000000000000000000", 0,
+      "0000000000000000000000000000000000000000000000000000000000000000",
+      "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e" },
+    { "1111111111111111111111111111111122222222222222222222222222222222", 0x3333333333ULL,
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", 0x123456789aULL,
+      "000102030405060708090a0b0c0d0e0f10", "6c1625db4671522d3d7599601de7ca09ed" },
+};
+
+int main(void) {
+    uint8_t key[64], plain[64], expect[64], out[64];
+    AesXtsContext ctx;
+    int ok = 1;
+
+    setenv("LIBHASH_THREADS", "4", 0);
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        uint32_t keySize = (uint32_t)fromHex(vectors[i].key, key);
+        uint32_t size = (uint32_t)fromHex(vectors[i].plain, plain);
+        fromHex(vectors[i].cipher, expect);
+        if (AesXtsInitialiseWithKey(&ctx, key, keySize) != 0 ||
+            AesXtsEncryptSector(&ctx, vectors[i].sector, plain, out, size) != 0 || memcmp(out, expect, size) != 0) {
+            printf("Vector %zu encryption FAILED\n", i);
+            printHex("Got", out, size);
+            ok = 0;
+        }
+        if (AesXtsDecryptSector(&ctx, vectors[i].sector, out, out, size) != 0 || memcmp(out, plain, size) != 0) {
+            printf("Vector %zu decryption FAILED\n", i);
+            ok = 0;
+        }
+    }
+
+    // Every stealing length, in place, round trip
+    for (uint32_t size = AES_BLOCK_SIZE; size <= 64; size++) {
+        uint8_t data[64];
+        for (uint32_t j = 0; j < size; j++) data[j] = (uint8_t)(j * 13 + size);
+        memcpy(out, data, size);
+        AesXtsEncryptSector(&ctx, size, out, out, size);
+        AesXtsDecryptSector(&ctx, size, out, out, size);
+        if (memcmp(out, data, size) != 0) {
+            printf("Round trip of %u bytes FAILED\n", size);
+            ok = 0;
+        }
+    }
+
+    // Sector batches (serial and on the thread pool) against sector by sector
+    {
+        enum { SECTOR = 520, SECTORS = 2500 };
+        uint8_t *data = malloc(SECTOR * SECTORS), *single = malloc(SECTOR * SECTORS), *batch = malloc(SECTOR * SECTORS);
+        if (!data || !single || !batch) return 1;
+        for (size_t j = 0; j < SECTOR * SECTORS; j++) data[j] = (uint8_t)(j * 7 + 3);
+        fromHex(vectors[2].key, key);
+        AesXtsInitialiseWithKey(&ctx, key, 32);
+        for (size_t j = 0; j < SECTORS; j++) AesXtsEncryptSector(&ctx, 1000 + j, data + j * SECTOR, single + j * SECTOR, SECTOR);
+        for (int parallel = 0; parallel < 2; parallel++) {
+            AesXtsSetParallelThreshold(parallel ? 1 : 0);
+            memcpy(batch, data, SECTOR * SECTORS);
+            AesXtsEncryptSectors(&ctx, 1000, SECTOR, batch, batch, SECTORS);
+            if (memcmp(batch, single, SECTOR * SECTORS) != 0) {
+                printf("Batch encryption FAILED (parallel %d)\n", parallel);
+                ok = 0;
+            }
+            AesXtsDecryptSectors(&ctx, 1000, SECTOR, batch, batch, SECTORS);
+            if (memcmp(batch, data, SECTOR * SECTORS) != 0) {
+                printf("Batch decryption FAILED (parallel %d)\n", parallel);
+                ok = 0;
+            }
+        }
+        AesXtsSetParallelThreshold(AES_XTS_PARALLEL_THRESHOLD);
+        free(data);
+        free(single);
+        free(batch);
+    }
+
+    if (AesXtsInitialiseWithKey(&ctx, key, 16) != -1 || AesXtsEncryptSector(&ctx, 0, plain, out, 15) != -1 ||
+        AesXtsEncryptSectors(&ctx, 0, 8, plain, out, 2) != -1) {
+        printf("Invalid sizes accepted\n");
+        ok = 0;
+    }
+
+    printf("XTS AES test %s.\n", ok ? "passed" : "FAILED");
+    return ok ? 0 : 1;
+}
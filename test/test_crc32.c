@@ -1,7 +1,10 @@
+#define _POSIX_C_SOURCE 200809L // for setenv
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include <crc32_ext.h>
 
 /* === Helper: Convert uint32_t to hex string === */
@@ -31,6 +34,27 @@ static int hash_matches(const uint32_t *digest, const char *expected)
     return (strcasecmp(hex, expected) == 0);
 }
 
+/* === Helper: Create an empty file with a unique name from a "...XXXXXX" template === */
+static int make_temp_file(char *path)
+{
+    int fd = mkstemp(path);
+    if (fd < 0) return 0;
+    close(fd);
+    return 1;
+}
+
+/* === Helper: Bit-at-a-time reflected CRC-32 (init and final XOR 0xFFFFFFFF) === */
+static uint32_t crc32_bitwise(uint32_t poly, const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+    while (len--) {
+        crc ^= *data++;
+        for (int j = 0; j < 8; ++j)
+            crc = (crc >> 1) ^ (poly & (0U - (crc & 1U)));
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
 /* === Main test program === */
 int main(void)
 {
@@ -48,6 +72,8 @@ int main(void)
     uint32_t digest;
     int all_passed = 1;
 
+    setenv("LIBHASH_THREADS", "4", 0);
+
     for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
         digest = crc32(tests[i].message, strlen(tests[i].message));
 
@@ -63,5 +89,118 @@ int main(void)
         }
     }
 
+    /* Every variant (memory and file) against the bitwise reference and the published check values */
+    {
+        static const struct {
+            const char *name;
+            uint32_t (*mem)(const void *, size_t);
+            uint32_t (*file)(const char *);
+            uint32_t poly;
+            uint32_t check;    /* CRC of "123456789", 0 if there is no published value */
+        } variants[] = {
+            { "crc32",         crc32,         crc32_file,         CRC32_POLY_REFLECTED,         0xCBF43926U },
+            { "crc32_ieee",    crc32_ieee,    crc32_ieee_file,    CRC32_POLY_REFLECTED,         0xCBF43926U },
+            { "crc32c",        crc32c,        crc32c_file,        CRC32C_POLY_REFLECTED,        0xE3069283U },
+            { "crc32k",        crc32k,        crc32k_file,        CRC32K_POLY_REFLECTED,        0 },
+            { "crc32q",        crc32q,        crc32q_file,        CRC32Q_POLY_REFLECTED,        0 },
+            { "crc32d",        crc32d,        crc32d_file,        CRC32D_POLY_REFLECTED,        0x87315576U },
+            { "crc32_xfer",    crc32_xfer,    crc32_xfer_file,    CRC32_XFER_POLY_REFLECTED,    0 },
+            { "crc32_autosar", crc32_autosar, crc32_autosar_file, CRC32_AUTOSAR_POLY_REFLECTED, 0x1697D06AU },
+        };
+        static uint8_t data[100000];
+        static const size_t lengths[] = { 1, 3, 8, 15, 16, 17, 63, 64, 65, 255, 1000, 4097, 3 * 256, 3 * 8192 + 13, sizeof(data) };
+        char path[] = "crc32_test_XXXXXX";
+        FILE *fp = NULL;
+        int created = make_temp_file(path);
+        int variants_ok = created;
+        for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 131 + (i >> 7));
+        if (!variants_ok || (fp = fopen(path, "wb")) == NULL || fwrite(data, 1, sizeof(data), fp) != sizeof(data)) variants_ok = 0;
+        if (fp) fclose(fp);
+        for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v) {
+            if (variants[v].check && variants[v].mem("123456789", 9) != variants[v].check) {
+                printf("%s check value FAILED\n", variants[v].name);
+                variants_ok = 0;
+            }
+            for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+                for (size_t offset = 0; offset < 4; ++offset) {
+                    size_t len = lengths[l] - (lengths[l] == sizeof(data) ? offset : 0);
+                    if (variants[v].mem(data + offset, len) != crc32_bitwise(variants[v].poly, data + offset, len)) {
+                        printf("%s FAILED at length %zu, offset %zu\n", variants[v].name, len, offset);
+                        variants_ok = 0;
+                    }
+                }
+            }
+            if (variants[v].file(path) != crc32_bitwise(variants[v].poly, data, sizeof(data))) {
+                printf("%s_file FAILED\n", variants[v].name);
+                variants_ok = 0;
+            }
+            if (crc32_shared_table(variants[v].poly) == NULL ||
+                crc32_shared_table(variants[v].poly) != crc32_shared_table(variants[v].poly)) {
+                printf("%s shared table FAILED\n", variants[v].name);
+                variants_ok = 0;
+            }
+        }
+        if (crc32_shared_table(0x12345678U) != NULL) variants_ok = 0;
+        /* Incremental updates across kernel boundaries, and a polynomial without shared tables */
+        {
+            uint32_t crc = 0xFFFFFFFFU;
+            size_t offset = 0, chunk = 1;
+            for (; offset < sizeof(data); offset += chunk, chunk = chunk * 2 + 5) {
+                if (chunk > sizeof(data) - offset) chunk = sizeof(data) - offset;
+                crc = crc32_update(CRC32C_POLY_REFLECTED, crc, data + offset, chunk);
+            }
+            if ((crc ^ 0xFFFFFFFFU) != crc32_bitwise(CRC32C_POLY_REFLECTED, data, sizeof(data)) ||
+                (crc32_update(0x12345678U, 0xFFFFFFFFU, data, 1000) ^ 0xFFFFFFFFU) != crc32_bitwise(0x12345678U, data, 1000)) {
+                printf("crc32_update FAILED\n");
+                variants_ok = 0;
+            }
+        }
+        if (created) remove(path);
+        printf("Variant test %s\n", variants_ok ? "PASSED" : "FAILED");
+        if (!variants_ok) all_passed = 0;
+    }
+
+    /* crc32_combine on final CRCs and registers, then the parallel paths against the serial ones */
+    {
+        static const uint32_t polys[] = {
+            CRC32_POLY_REFLECTED, CRC32C_POLY_REFLECTED, CRC32K_POLY_REFLECTED, CRC32Q_POLY_REFLECTED,
+            CRC32D_POLY_REFLECTED, CRC32_XFER_POLY_REFLECTED, CRC32_AUTOSAR_POLY_REFLECTED, 0x12345678U,
+        };
+        const size_t size = (9U << 20) + 7;
+        char path[] = "crc32_parallel_XXXXXX";
+        uint8_t *big = malloc(size);
+        FILE *fp = NULL;
+        int created = make_temp_file(path);
+        int parallel_ok = big != NULL && created;
+        for (size_t i = 0; parallel_ok && i < size; ++i) big[i] = (uint8_t)((i * 2654435761U) >> 13);
+        if (parallel_ok && ((fp = fopen(path, "wb")) == NULL || fwrite(big, 1, size, fp) != size)) parallel_ok = 0;
+        if (fp) fclose(fp);
+        for (size_t v = 0; parallel_ok && v < sizeof(polys) / sizeof(polys[0]); ++v) {
+            uint32_t poly = polys[v];
+            uint32_t whole = crc32_update(poly, 0xFFFFFFFFU, big, 100000) ^ 0xFFFFFFFFU;
+            for (size_t split = 0; split <= 100000; split += 12345) {
+                uint32_t a = crc32_update(poly, 0xFFFFFFFFU, big, split) ^ 0xFFFFFFFFU;
+                uint32_t b = crc32_update(poly, 0xFFFFFFFFU, big + split, 100000 - split) ^ 0xFFFFFFFFU;
+                uint32_t r = crc32_update(poly, 0U, big + split, 100000 - split);
+                if (crc32_combine(a, b, 100000 - split, poly) != whole ||
+                    (crc32_combine(a ^ 0xFFFFFFFFU, r, 100000 - split, poly) ^ 0xFFFFFFFFU) != whole) {
+                    printf("crc32_combine FAILED for polynomial %08x at %zu\n", (unsigned)poly, split);
+                    parallel_ok = 0;
+                }
+            }
+            whole = crc32_update(poly, 0xFFFFFFFFU, big, size) ^ 0xFFFFFFFFU;
+            if (crc32_parallel(big, size, poly) != whole || crc32_file_parallel(path, poly) != whole ||
+                (crc32_update_parallel(poly, 0x5A5A5A5AU, big + 3, size - 3) !=
+                 crc32_update(poly, 0x5A5A5A5AU, big + 3, size - 3))) {
+                printf("Parallel CRC FAILED for polynomial %08x\n", (unsigned)poly);
+                parallel_ok = 0;
+            }
+        }
+        if (created) remove(path);
+        free(big);
+        printf("Combine and parallel test %s\n", parallel_ok ? "PASSED" : "FAILED");
+        if (!parallel_ok) all_passed = 0;
+    }
+
     return all_passed ? 0 : 1;
 }
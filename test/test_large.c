@@ -0,0 +1,152 @@
+// Built straight from the headers with a small HASH_LARGE_STRIDE (see CMakeLists.txt), so the size_t entry points
+// cut these buffers into many pieces. Every result must match the 32-bit entry point over the whole buffer.
+#include <stdio.h>
+#include <string.h>
+#include "md2.h"
+#include "md4.h"
+#include "md5.h"
+#include "sha1.h"
+#include "sha224.h"
+#include "sha256.h"
+#include "sha384.h"
+#include "sha512.h"
+#include "sha512_224.h"
+#include "sha512_256.h"
+#include "rc4.h"
+#include "aescbc.h"
+#include "aesctr.h"
+#include "aesofb.h"
+#include "aesgcm.h"
+
+#if HASH_LARGE_STRIDE > 1024
+#error "test_large.c must be built with a small HASH_LARGE_STRIDE"
+#endif
+
+static uint8_t data[5 * 1024 + 37];
+static int all_passed = 1;
+
+static void report(const char* name, int ok) {
+    printf("%s large test %s\n", name, ok ? "PASSED" : "FAILED");
+    if (!ok) all_passed = 0;
+}
+
+// One-shot and incremental (a few bytes buffered first) size_t hashing against the 32-bit one-shot
+#define CHECK_HASH(NAME, PREFIX, CONTEXT, HASH) do {                                    \
+        CONTEXT ctx;                                                                    \
+        HASH whole, large, split;                                                       \
+        PREFIX##Calculate(data, (uint32_t)sizeof(data), &whole);                        \
+        PREFIX##CalculateLarge(data, sizeof(data), &large);                             \
+        PREFIX##Initialise(&ctx);                                                       \
+        PREFIX##Update(&ctx, data, 5);                                                  \
+        PREFIX##UpdateLarge(&ctx, data + 5, sizeof(data) - 5);                          \
+        PREFIX##Finalise(&ctx, &split);                                                 \
+        report(NAME, memcmp(&whole, &large, sizeof(whole)) == 0 &&                      \
+                     memcmp(&whole, &split, sizeof(whole)) == 0);                       \
+    } while (0)
+
+int main() {
+    static const uint8_t key[16] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                     0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+    static const uint8_t iv[16] = { 0 };
+    static uint8_t whole[sizeof(data)], large[sizeof(data)];
+
+    for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 131 + (i >> 8));
+
+    CHECK_HASH("MD2", Md2, Md2Context, MD2_HASH);
+    CHECK_HASH("MD4", Md4, Md4Context, MD4_HASH);
+    CHECK_HASH("MD5", Md5, Md5Context, MD5_HASH);
+    CHECK_HASH("SHA1", Sha1, Sha1Context, SHA1_HASH);
+    CHECK_HASH("SHA224", Sha224, Sha224Context, SHA224_HASH);
+    CHECK_HASH("SHA256", Sha256, Sha256Context, SHA256_HASH);
+    CHECK_HASH("SHA384", Sha384, Sha384Context, SHA384_HASH);
+    CHECK_HASH("SHA512", Sha512, Sha512Context, SHA512_HASH);
+    CHECK_HASH("SHA512/224", Sha512_224, Sha512_224Context, SHA512_224_HASH);
+    CHECK_HASH("SHA512/256", Sha512_256, Sha512_256Context, SHA512_256_HASH);
+
+    // CBC over whole blocks, started one block in so the pieces carry the chaining value across
+    {
+        const size_t size = sizeof(data) - sizeof(data) % AES_BLOCK_SIZE;
+        AesCbcContext a, b;
+        int ok;
+        AesCbcInitialiseWithKey(&a, key, sizeof(key), iv);
+        AesCbcInitialiseWithKey(&b, key, sizeof(key), iv);
+        AesCbcEncrypt(&a, data, whole, (uint32_t)size);
+        AesCbcEncrypt(&b, data, large, AES_BLOCK_SIZE);
+        AesCbcEncryptLarge(&b, data + AES_BLOCK_SIZE, large + AES_BLOCK_SIZE, size - AES_BLOCK_SIZE);
+        ok = memcmp(whole, large, size) == 0;
+        AesCbcInitialiseWithKey(&a, key, sizeof(key), iv);
+        AesCbcInitialiseWithKey(&b, key, sizeof(key), iv);
+        AesCbcDecrypt(&a, whole, whole, (uint32_t)size);
+        AesCbcDecrypt(&b, large, large, AES_BLOCK_SIZE);
+        AesCbcDecryptLarge(&b, large + AES_BLOCK_SIZE, large + AES_BLOCK_SIZE, size - AES_BLOCK_SIZE);
+        report("AES-CBC", ok && memcmp(whole, data, size) == 0 && memcmp(large, data, size) == 0 &&
+                          AesCbcEncryptLarge(&b, data, large, size + 1) == -1);
+    }
+
+    // Stream ciphers, started a few bytes in so the pieces do not line up with the keystream blocks
+    {
+        Rc4Context a, b;
+        Rc4Initialise(&a, key, sizeof(key), 0);
+        Rc4Initialise(&b, key, sizeof(key), 0);
+        Rc4Xor(&a, data, whole, (uint32_t)sizeof(data));
+        Rc4Xor(&b, data, large, 3);
+        Rc4XorLarge(&b, data + 3, large + 3, sizeof(data) - 3);
+        report("RC4", memcmp(whole, large, sizeof(data)) == 0);
+    }
+    {
+        Rc4Context a, b;
+        Rc4Initialise(&a, key, sizeof(key), 0);
+        Rc4Initialise(&b, key, sizeof(key), 0);
+        Rc4Output(&a, whole, (uint32_t)sizeof(data));
+        Rc4Output(&b, large, 3);
+        Rc4OutputLarge(&b, large + 3, sizeof(data) - 3);
+        report("RC4 output", memcmp(whole, large, sizeof(data)) == 0);
+    }
+    {
+        XorBuffers(data, data + 1, whole, (uint32_t)sizeof(data) - 1);
+        XorBuffersLarge(data, data + 1, large, sizeof(data) - 1);
+        report("XorBuffers", memcmp(whole, large, sizeof(data) - 1) == 0);
+    }
+    {
+        AesCtrContext a, b;
+        AesCtrInitialiseWithKey(&a, key, sizeof(key), iv);
+        AesCtrInitialiseWithKey(&b, key, sizeof(key), iv);
+        AesCtrXor(&a, data, whole, (uint32_t)sizeof(data));
+        AesCtrXor(&b, data, large, 3);
+        AesCtrXorLarge(&b, data + 3, large + 3, sizeof(data) - 3);
+        report("AES-CTR", memcmp(whole, large, sizeof(data)) == 0);
+    }
+    {
+        AesOfbContext a, b;
+        AesOfbInitialiseWithKey(&a, key, sizeof(key), iv);
+        AesOfbInitialiseWithKey(&b, key, sizeof(key), iv);
+        AesOfbXor(&a, data, whole, (uint32_t)sizeof(data));
+        AesOfbXor(&b, data, large, 3);
+        AesOfbXorLarge(&b, data + 3, large + 3, sizeof(data) - 3);
+        report("AES-OFB", memcmp(whole, large, sizeof(data)) == 0);
+    }
+    // GCM with the AAD and the message both cut into pieces, then decrypted back the same way
+    {
+        AesGcmContext a, b;
+        uint8_t tagWhole[AES_GCM_TAG_SIZE], tagLarge[AES_GCM_TAG_SIZE];
+        AesGcmInitialiseWithKey(&a, key, sizeof(key));
+        AesGcmInitialiseWithKey(&b, key, sizeof(key));
+        AesGcmStart(&a, iv, AES_GCM_IV_SIZE);
+        AesGcmStart(&b, iv, AES_GCM_IV_SIZE);
+        AesGcmUpdateAad(&a, data, 1000);
+        AesGcmUpdateAad(&b, data, 3);
+        AesGcmUpdateAadLarge(&b, data + 3, 997);
+        AesGcmEncrypt(&a, data, whole, (uint32_t)sizeof(data));
+        AesGcmEncrypt(&b, data, large, 3);
+        AesGcmEncryptLarge(&b, data + 3, large + 3, sizeof(data) - 3);
+        AesGcmFinish(&a, tagWhole);
+        AesGcmFinish(&b, tagLarge);
+        int ok = memcmp(whole, large, sizeof(data)) == 0 && memcmp(tagWhole, tagLarge, sizeof(tagWhole)) == 0;
+        AesGcmStart(&b, iv, AES_GCM_IV_SIZE);
+        AesGcmUpdateAadLarge(&b, data, 1000);
+        AesGcmDecryptLarge(&b, whole, large, sizeof(data));
+        report("AES-GCM", ok && AesGcmVerify(&b, tagWhole, AES_GCM_TAG_SIZE) == 0 &&
+                          memcmp(data, large, sizeof(data)) == 0);
+    }
+    return all_passed ? 0 : 1;
+}
@@ -38,5 +38,65 @@ int main() {
             all_passed = 0;
         }
     }
+    // The same vectors through the size_t entry point
+    for (size_t i = 0; i < sizeof(tests)/sizeof(tests[0]); ++i) {
+        Md5CalculateLarge(tests[i].message, strlen(tests[i].message), &digest);
+        if (hash_matches(&digest, tests[i].expected)) {
+            printf("Large test %zu PASSED\n", i);
+        } else {
+            printf("Large test %zu FAILED\n", i);
+            printf("Expected: %s\n", tests[i].expected);
+            printf("Got     : ");
+            print_hash(&digest);
+            all_passed = 0;
+        }
+    }
+    // Batch against one-by-one hashing. The first message (4000 bytes) holds its lane for the whole batch while the
+    // others come in groups of four equal lengths, so several lanes finish on the same step and are refilled together.
+    // MD5 has a 64-byte block and an 8-byte length field: 55/56 and 119/120 are the edges where padding spills into
+    // another block, 63/64/65 the block edge.
+    {
+        static const size_t lengths[] = { 0, 20, 55, 56, 63, 64, 65, 100, 119, 120 };
+        static uint8_t data[4000 + 41];
+        const void* buffers[41];
+        size_t sizes[41];
+        MD5_HASH batch[41], single;
+        int batch_ok = 1;
+        for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)((i * 29) ^ (i >> 6));
+        for (size_t i = 0; i < 41; ++i) {
+            buffers[i] = data + i;
+            sizes[i] = i == 0 ? 4000 : lengths[(i - 1) / 4];
+        }
+        Md5CalculateBatch(buffers, sizes, 41, batch);
+        for (size_t i = 0; i < 41; ++i) {
+            Md5Calculate(buffers[i], (uint32_t)sizes[i], &single);
+            if (memcmp(batch[i].bytes, single.bytes, MD5_HASH_SIZE) != 0) batch_ok = 0;
+        }
+        printf("Batch test %s\n", batch_ok ? "PASSED" : "FAILED");
+        if (!batch_ok) all_passed = 0;
+    }
+
+
+    // Incremental scheduler: submit one at a time, count completions
+    {
+        static uint8_t data[2048];
+        static MD5_HASH out[20];
+        Md5MultiContext mctx;
+        MD5_HASH single;
+        size_t completed = 0;
+        int multi_ok = 1;
+        for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i ^ 0x5a);
+        Md5MultiInitialise(&mctx);
+        for (size_t i = 0; i < 20; ++i) completed += Md5MultiSubmit(&mctx, data, i * 100, &out[i]);
+        completed += Md5MultiFlush(&mctx);
+        if (completed != 20) multi_ok = 0;
+        for (size_t i = 0; i < 20; ++i) {
+            Md5Calculate(data, (uint32_t)(i * 100), &single);
+            if (memcmp(out[i].bytes, single.bytes, MD5_HASH_SIZE) != 0) multi_ok = 0;
+        }
+        printf("Multi-lane scheduler test %s\n", multi_ok ? "PASSED" : "FAILED");
+        if (!multi_ok) all_passed = 0;
+    }
+
     return all_passed ? 0 : 1;
 }
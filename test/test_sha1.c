@@ -45,5 +45,28 @@ int main(void) {
             all_passed = 0;
         }
     }
+    // One million 'a' fed in uneven chunks: exercises multi-block and buffered updates
+    {
+        static uint8_t million[1000000];
+        Sha1Context ctx;
+        uint32_t offset = 0, chunk = 1;
+        memset(million, 'a', sizeof(million));
+        Sha1Initialise(&ctx);
+        while (offset < sizeof(million)) {
+            if (chunk > sizeof(million) - offset) chunk = (uint32_t)(sizeof(million) - offset);
+            Sha1Update(&ctx, million + offset, chunk);
+            offset += chunk;
+            chunk = chunk * 3 + 7;
+        }
+        Sha1Finalise(&ctx, &digest);
+        if (hash_matches(&digest, "34aa973cd4c4daa4f61eeb2bdbad27316534016f")) {
+            printf("Million 'a' test PASSED\n");
+        } else {
+            printf("Million 'a' test FAILED\n");
+            print_hash(&digest);
+            all_passed = 0;
+        }
+    }
+
     return all_passed ? 0 : 1;
 }
@@ -64,5 +64,67 @@ int main(void) {
 		}
 	}
 
+	// One million 'a' fed in uneven chunks: exercises multi-block and buffered updates
+	{
+		static uint8_t million[1000000];
+		Sha256Context ctx;
+		uint32_t offset = 0, chunk = 1;
+		memset(million, 'a', sizeof(million));
+		Sha256Initialise(&ctx);
+		while (offset < sizeof(million)) {
+			if (chunk > sizeof(million) - offset) chunk = (uint32_t)(sizeof(million) - offset);
+			Sha256Update(&ctx, million + offset, chunk);
+			offset += chunk;
+			chunk = chunk * 3 + 7;
+		}
+		Sha256Finalise(&ctx, &digest);
+		if (hash_matches(&digest, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0")) {
+			printf("Million 'a' test PASSED\n");
+		} else {
+			printf("Million 'a' test FAILED\n");
+			print_hash(&digest);
+			all_passed = 0;
+		}
+	}
+
+	// One million 'a' in a single call of the size_t entry point
+	{
+		static uint8_t million[1000000];
+		memset(million, 'a', sizeof(million));
+		Sha256CalculateLarge(million, sizeof(million), &digest);
+		if (hash_matches(&digest, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0")) {
+			printf("Million 'a' large test PASSED\n");
+		} else {
+			printf("Million 'a' large test FAILED\n");
+			print_hash(&digest);
+			all_passed = 0;
+		}
+	}
+
+	// Batch against one-by-one hashing. The 37 messages outnumber two rounds of 16 lanes, so lanes are refilled at
+	// either batch width. The first lengths sit where SHA-256 padding changes shape: from 56 bytes the 8-byte length
+	// no longer fits and padding takes another block (55/56, 119/120), and 63/64/65 cross a block edge. The rest
+	// spread up to 4 KiB so lanes finish at different steps; buffers start at every offset within 16 bytes.
+	{
+		static const size_t edges[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120 };
+		static uint8_t data[4096 + 16];
+		const void* buffers[37];
+		size_t sizes[37];
+		SHA256_HASH batch[37], single;
+		int batch_ok = 1;
+		for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i ^ (i >> 5));
+		for (size_t i = 0; i < 37; ++i) {
+			buffers[i] = data + i % 16;
+			sizes[i] = i < sizeof(edges) / sizeof(edges[0]) ? edges[i] : (i * 677) % 4096;
+		}
+		Sha256CalculateBatch(buffers, sizes, 37, batch);
+		for (size_t i = 0; i < 37; ++i) {
+			Sha256Calculate(buffers[i], (uint32_t)sizes[i], &single);
+			if (memcmp(batch[i].bytes, single.bytes, SHA256_HASH_SIZE) != 0) batch_ok = 0;
+		}
+		printf("Batch test %s\n", batch_ok ? "PASSED" : "FAILED");
+		if (!batch_ok) all_passed = 0;
+	}
+
 	return all_passed ? 0 : 1;
 }
@@ -78,5 +78,56 @@ int main(void) {
 		}
 	}
 
+	// One Sha512Update carrying several whole blocks, entered with 0..127 bytes already buffered and leaving a tail
+	// behind, against hashing the same bytes in one call
+	{
+		static uint8_t data[7 * SHA512_BLOCK_SIZE + 1];
+		static const uint32_t tails[] = { 0, 1, SHA512_BLOCK_SIZE - 1 };
+		Sha512Context ctx;
+		SHA512_HASH whole;
+		int runs_ok = 1;
+		for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 13 + 5);
+		for (uint32_t buffered = 0; buffered < SHA512_BLOCK_SIZE; buffered += 21) {
+			for (uint32_t blocks = 1; blocks <= 5; ++blocks) {
+				for (size_t t = 0; t < sizeof(tails) / sizeof(tails[0]); ++t) {
+					uint32_t run = blocks * SHA512_BLOCK_SIZE + tails[t];
+					Sha512Initialise(&ctx);
+					Sha512Update(&ctx, data, buffered);
+					Sha512Update(&ctx, data + buffered, run);
+					Sha512Finalise(&ctx, &digest);
+					Sha512Calculate(data, buffered + run, &whole);
+					if (memcmp(digest.bytes, whole.bytes, SHA512_HASH_SIZE) != 0) runs_ok = 0;
+				}
+			}
+		}
+		printf("Block run test %s\n", runs_ok ? "PASSED" : "FAILED");
+		if (!runs_ok) all_passed = 0;
+	}
+
+	// Batch against one-by-one hashing through the 4-lane AVX2 driver; 23 messages refill every lane several times.
+	// SHA-512 blocks are 128 bytes with a 16-byte length field, so padding takes another block from 112 bytes on:
+	// 111/112 and 239/240 sit on that edge and 127/128/129 on the block edge. The rest run up to 3 KiB so the four
+	// lanes finish at different steps.
+	{
+		static const size_t edges[] = { 0, 111, 112, 127, 128, 129, 239, 240 };
+		static uint8_t data[3072 + 23];
+		const void* buffers[23];
+		size_t sizes[23];
+		SHA512_HASH batch[23], single;
+		int batch_ok = 1;
+		for (size_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 37 + (i >> 8));
+		for (size_t i = 0; i < 23; ++i) {
+			buffers[i] = data + i;
+			sizes[i] = i < sizeof(edges) / sizeof(edges[0]) ? edges[i] : (i * 389) % 3072;
+		}
+		Sha512CalculateBatch(buffers, sizes, 23, batch);
+		for (size_t i = 0; i < 23; ++i) {
+			Sha512Calculate(buffers[i], (uint32_t)sizes[i], &single);
+			if (memcmp(batch[i].bytes, single.bytes, SHA512_HASH_SIZE) != 0) batch_ok = 0;
+		}
+		printf("Batch test %s\n", batch_ok ? "PASSED" : "FAILED");
+		if (!batch_ok) all_passed = 0;
+	}
+
 	return all_passed ? 0 : 1;
 }
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>   // for strcasecmp
+#include "sha512_256.h"
+
+static void print_hash(const SHA512_256_HASH* digest) {
+	for (int i = 0; i < SHA512_256_HASH_SIZE; ++i)
+		printf("%02x", digest->bytes[i]);
+	printf("\n");
+}
+
+static int hash_matches(const SHA512_256_HASH* digest, const char* expectedHex) {
+	char hashHex[SHA512_256_HASH_SIZE * 2 + 1] = {0};
+	for (int i = 0; i < SHA512_256_HASH_SIZE; ++i)
+		sprintf(hashHex + i * 2, "%02x", digest->bytes[i]);
+	return strcasecmp(hashHex, expectedHex) == 0;
+}
+
+int main(void) {
+	struct {
+		const char* message;
+		const char* expected;
+	} tests[] = {
+		{
+			"",
+			"c672b8d1ef56ed28ab87c3622c511406"
+			"9bdd3ad7b8f9737498d0c01ecef0967a"
+		},
+		{
+			"abc",
+			"53048e2681941ef99b2e29b76b4c7dab"
+			"e4c2d0c634fc6d46e0e2f13107e7af23"
+		},
+		{
+			"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+			"ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+			"3928e184fb8690f840da3988121d31be"
+			"65cb9d3ef83ee6146feac861e19b563a"
+		},
+		{
+			"The quick brown fox jumps over the lazy dog",
+			"dd9d67b371519c339ed8dbd25af90e97"
+			"6a1eeefd4ad3d889005e532fc5bef04d"
+		},
+		{
+			"The quick brown fox jumps over the lazy cog",
+			"cc8d255a7f2f38fd50388fd1f65ea791"
+			"0835c5c1e73da46fba01ea50d5dd76fb"
+		}
+	};
+
+	SHA512_256_HASH digest;
+	int all_passed = 1;
+
+	for (size_t i = 0; i < sizeof(tests)/sizeof(tests[0]); ++i) {
+		Sha512_256Calculate(tests[i].message, (uint32_t)strlen(tests[i].message), &digest);
+		if (hash_matches(&digest, tests[i].expected)) {
+			printf("Test %zu PASSED\n", i);
+		} else {
+			printf("Test %zu FAILED\n", i);
+			printf("Expected: %s\n", tests[i].expected);
+			printf("Got	 : ");
+			print_hash(&digest);
+			all_passed = 0;
+		}
+	}
+
+	return all_passed ? 0 : 1;
+}
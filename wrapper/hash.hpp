@@ -28,6 +28,18 @@
 #include <cstdint>
 #include <cstring>
 
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define HASH_HPP_STRING_VIEW 1
+#endif
+
+#if (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)) && defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#define HASH_HPP_SPAN 1
+#endif
+#endif
+
 #include "crc32.h"
 #include "crc32_ext.h"
 
@@ -40,6 +52,8 @@
 #include "sha256.h"
 #include "sha384.h"
 #include "sha512.h"
+#include "sha512_224.h"
+#include "sha512_256.h"
 
 #include "base16.h"
 #include "base32.h"
@@ -49,6 +63,8 @@
 #include "aescbc.h"
 #include "aesctr.h"
 #include "aesofb.h"
+#include "aesgcm.h"
+#include "aesxts.h"
 
 #include "rc4.h"
 
@@ -62,9 +78,20 @@ namespace hash {
 			Md2Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Md2Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Md2UpdateLarge(&ctx, data, len);
+		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
 		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
 
 		const MD2_HASH& finalize() {
 			Md2Finalise(&ctx, &hash);
@@ -73,9 +100,20 @@ namespace hash {
 
 		static MD2_HASH calculate(const void* data, size_t len) {
 			MD2_HASH h{};
-			Md2Calculate(data,len, &h);
+			Md2CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static MD2_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static MD2_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
 		const MD2_HASH& get() const { return hash; }
 	};
 
@@ -88,20 +126,42 @@ namespace hash {
 			Md4Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Md4Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Md4UpdateLarge(&ctx, data, len);
 		}
 
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
 		const MD4_HASH& finalize() {
 			Md4Finalise(&ctx, &hash);
 			return hash;
 		}
 
-		static MD4_HASH calculate(const void* data, uint32_t len) {
+		static MD4_HASH calculate(const void* data, size_t len) {
 			MD4_HASH h{};
-			Md4Calculate(data, len, &h);
+			Md4CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static MD4_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static MD4_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
 		const MD4_HASH& get() const { return hash; }
 	};
 
@@ -114,20 +174,46 @@ namespace hash {
 			Md5Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Md5Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Md5UpdateLarge(&ctx, data, len);
+		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
 		}
+#endif
 
 		const MD5_HASH& finalize() {
 			Md5Finalise(&ctx, &hash);
 			return hash;
 		}
 
-		static MD5_HASH calculate(const void* data, uint32_t len) {
+		static MD5_HASH calculate(const void* data, size_t len) {
 			MD5_HASH h{};
-			Md5Calculate(data, len, &h);
+			Md5CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static MD5_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static MD5_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+
+		static void calculateBatch(const void* const* data, const size_t* lens, size_t count, MD5_HASH* out) {
+			Md5CalculateBatch(data, lens, count, out);
+		}
 		const MD5_HASH& get() const { return hash; }
 	};
 
@@ -140,20 +226,42 @@ namespace hash {
 			Sha1Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Sha1Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Sha1UpdateLarge(&ctx, data, len);
 		}
 
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
 		const SHA1_HASH& finalize() {
 			Sha1Finalise(&ctx, &hash);
 			return hash;
 		}
 
-		static SHA1_HASH calculate(const void* data, uint32_t len) {
+		static SHA1_HASH calculate(const void* data, size_t len) {
 			SHA1_HASH h{};
-			Sha1Calculate(data, len, &h);
+			Sha1CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static SHA1_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static SHA1_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
 		const SHA1_HASH& get() const { return hash; }
 	};
 
@@ -166,20 +274,42 @@ namespace hash {
 			Sha224Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Sha224Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Sha224UpdateLarge(&ctx, data, len);
 		}
 
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
 		const SHA224_HASH& finalize() {
 			Sha224Finalise(&ctx, &hash);
 			return hash;
 		}
 
-		static SHA224_HASH calculate(const void* data, uint32_t len) {
+		static SHA224_HASH calculate(const void* data, size_t len) {
 			SHA224_HASH h{};
-			Sha224Calculate(data, len, &h);
+			Sha224CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static SHA224_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static SHA224_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
 		const SHA224_HASH& get() const { return hash; }
 	};
 
@@ -192,20 +322,46 @@ namespace hash {
 			Sha256Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Sha256Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Sha256UpdateLarge(&ctx, data, len);
 		}
 
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
 		const SHA256_HASH& finalize() {
 			Sha256Finalise(&ctx, &hash);
 			return hash;
 		}
 
-		static SHA256_HASH calculate(const void* data, uint32_t len) {
+		static SHA256_HASH calculate(const void* data, size_t len) {
 			SHA256_HASH h{};
-			Sha256Calculate(data, len, &h);
+			Sha256CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static SHA256_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static SHA256_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+
+		static void calculateBatch(const void* const* data, const size_t* lens, size_t count, SHA256_HASH* out) {
+			Sha256CalculateBatch(data, lens, count, out);
+		}
 		const SHA256_HASH& get() const { return hash; }
 	};
 
@@ -218,20 +374,46 @@ namespace hash {
 			Sha384Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Sha384Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Sha384UpdateLarge(&ctx, data, len);
 		}
 
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
 		const SHA384_HASH& finalize() {
 			Sha384Finalise(&ctx, &hash);
 			return hash;
 		}
 
-		static SHA384_HASH calculate(const void* data, uint32_t len) {
+		static SHA384_HASH calculate(const void* data, size_t len) {
 			SHA384_HASH h{};
-			Sha384Calculate(data, len, &h);
+			Sha384CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static SHA384_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static SHA384_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+
+		static void calculateBatch(const void* const* data, const size_t* lens, size_t count, SHA384_HASH* out) {
+			Sha384CalculateBatch(data, lens, count, out);
+		}
 		const SHA384_HASH& get() const { return hash; }
 	};
 
@@ -244,23 +426,145 @@ namespace hash {
 			Sha512Initialise(&ctx);
 		}
 
-		void update(const void* data, uint32_t len) {
-			Sha512Update(&ctx, data, len);
+		void update(const void* data, size_t len) {
+			Sha512UpdateLarge(&ctx, data, len);
 		}
 
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
 		const SHA512_HASH& finalize() {
 			Sha512Finalise(&ctx, &hash);
 			return hash;
 		}
 
-		static SHA512_HASH calculate(const void* data, uint32_t len) {
+		static SHA512_HASH calculate(const void* data, size_t len) {
 			SHA512_HASH h{};
-			Sha512Calculate(data, len, &h);
+			Sha512CalculateLarge(data, len, &h);
 			return h;
 		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static SHA512_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static SHA512_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+
+		static void calculateBatch(const void* const* data, const size_t* lens, size_t count, SHA512_HASH* out) {
+			Sha512CalculateBatch(data, lens, count, out);
+		}
 		const SHA512_HASH& get() const { return hash; }
 	};
 
+	class Sha512_224 {
+		Sha512_224Context ctx{};
+		SHA512_224_HASH hash{};
+
+	public:
+		Sha512_224() {
+			Sha512_224Initialise(&ctx);
+		}
+
+		void update(const void* data, size_t len) {
+			Sha512_224UpdateLarge(&ctx, data, len);
+		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
+		const SHA512_224_HASH& finalize() {
+			Sha512_224Finalise(&ctx, &hash);
+			return hash;
+		}
+
+		static SHA512_224_HASH calculate(const void* data, size_t len) {
+			SHA512_224_HASH h{};
+			Sha512_224CalculateLarge(data, len, &h);
+			return h;
+		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static SHA512_224_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static SHA512_224_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+		const SHA512_224_HASH& get() const { return hash; }
+	};
+
+	class Sha512_256 {
+		Sha512_256Context ctx{};
+		SHA512_256_HASH hash{};
+
+	public:
+		Sha512_256() {
+			Sha512_256Initialise(&ctx);
+		}
+
+		void update(const void* data, size_t len) {
+			Sha512_256UpdateLarge(&ctx, data, len);
+		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		void update(std::string_view data) {
+			update(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		void update(std::span<const uint8_t> data) {
+			update(data.data(), data.size());
+		}
+#endif
+
+		const SHA512_256_HASH& finalize() {
+			Sha512_256Finalise(&ctx, &hash);
+			return hash;
+		}
+
+		static SHA512_256_HASH calculate(const void* data, size_t len) {
+			SHA512_256_HASH h{};
+			Sha512_256CalculateLarge(data, len, &h);
+			return h;
+		}
+
+#ifdef HASH_HPP_STRING_VIEW
+		static SHA512_256_HASH calculate(std::string_view data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+#ifdef HASH_HPP_SPAN
+		static SHA512_256_HASH calculate(std::span<const uint8_t> data) {
+			return calculate(data.data(), data.size());
+		}
+#endif
+		const SHA512_256_HASH& get() const { return hash; }
+	};
+
 	class Base16 {
 	public:
 		// Encode to std::string
@@ -495,8 +799,17 @@ namespace hash {
 			AesDecryptInPlace(&ctx, block);
 		}
 
-		static void xorBuffers(const uint8_t* a, const uint8_t* b, uint8_t* out, uint32_t len) {
-			XorBuffers(a, b, out, len);
+		// ECB over blocks independent 16-byte blocks; in and out may be the same buffer
+		void EncryptBlocks(const void* in, void* out, size_t blocks) const {
+			AesEncryptBlocks(&ctx, in, out, blocks);
+		}
+
+		void DecryptBlocks(const void* in, void* out, size_t blocks) const {
+			AesDecryptBlocks(&ctx, in, out, blocks);
+		}
+
+		static void xorBuffers(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t len) {
+			XorBuffersLarge(a, b, out, len);
 		}
 
 	private:
@@ -516,21 +829,29 @@ namespace hash {
 		}
 
 		// Encrypt a buffer (must be multiple of 16 bytes)
-		void encrypt(const void* in, void* out, uint32_t size) {
+		void encrypt(const void* in, void* out, size_t size) {
 			if (size % AES_BLOCK_SIZE != 0)
 				throw std::runtime_error("Buffer size must be multiple of 16 bytes");
-			if (AesCbcEncrypt(&ctx, in, out, size) != 0)
+			if (AesCbcEncryptLarge(&ctx, in, out, size) != 0)
 				throw std::runtime_error("CBC encryption failed");
 		}
 
 		// Decrypt a buffer (must be multiple of 16 bytes)
-		void decrypt(const void* in, void* out, uint32_t size) {
+		void decrypt(const void* in, void* out, size_t size) {
 			if (size % AES_BLOCK_SIZE != 0)
 				throw std::runtime_error("Buffer size must be multiple of 16 bytes");
-			if (AesCbcDecrypt(&ctx, in, out, size) != 0)
+			if (AesCbcDecryptLarge(&ctx, in, out, size) != 0)
 				throw std::runtime_error("CBC decryption failed");
 		}
 
+		// Encrypt count independent streams (streams[i] over in[i] -> out[i]) with their chains interleaved
+		static void encryptMulti(AesCbc* const* streams, const void* const* in, void* const* out, const uint32_t* sizes, size_t count) {
+			std::vector<AesCbcContext*> contexts(count);
+			for (size_t i = 0; i < count; i++) contexts[i] = &streams[i]->ctx;
+			if (AesCbcEncryptMulti(contexts.data(), in, out, sizes, count) != 0)
+				throw std::runtime_error("Buffer size must be multiple of 16 bytes");
+		}
+
 		// One-shot static helpers
 		static std::vector<uint8_t> encryptWithKey(const std::vector<uint8_t>& key, const std::array<uint8_t, AES_BLOCK_SIZE>& iv, const std::vector<uint8_t>& data) {
 			if (key.size() > UINT32_MAX) throw std::length_error("input too large");
@@ -576,13 +897,18 @@ namespace hash {
 		}
 
 		// Encrypt/decrypt in-place
-		void xorStream(const void* in, void* out, uint32_t size) {
-			AesCtrXor(&ctx, in, out, size);
+		void xorStream(const void* in, void* out, size_t size) {
+			AesCtrXorLarge(&ctx, in, out, size);
 		}
 
 		// Generate keystream bytes
-		void outputKeystream(void* out, uint32_t size) {
-			AesCtrOutput(&ctx, out, size);
+		void outputKeystream(void* out, size_t size) {
+			AesCtrOutputLarge(&ctx, out, size);
+		}
+
+		// Buffers of at least this size are split across the worker threads (0 = never)
+		static void setParallelThreshold(size_t bytes) {
+			AesCtrSetParallelThreshold(bytes);
 		}
 
 		// One-shot encryption/decryption
@@ -609,18 +935,48 @@ namespace hash {
 				throw std::runtime_error("Invalid AES key size");
 		}
 
+		// The keystream buffer is owned by the context
+		AesOfb(const AesOfb&) = delete;
+		AesOfb& operator=(const AesOfb&) = delete;
+
 		~AesOfb() {
+			AesOfbDisableKeystream(&ctx);
 			std::memset(&ctx, 0, sizeof(ctx));
 		}
 
+		// Keystream ring buffer of size bytes, filled ahead of xorStream() by refill()
+		void enableKeystream(uint32_t size) {
+			if (AesOfbEnableKeystream(&ctx, size) != 0)
+				throw std::runtime_error("Cannot allocate OFB keystream buffer");
+		}
+
+		// Non-blocking fill, for the thread that runs xorStream()
+		uint32_t refill() {
+			return AesOfbRefill(&ctx);
+		}
+
+		// Blocking fill for a helper thread; returns 0 after stopRefill()
+		uint32_t refillWait() {
+			return AesOfbRefillWait(&ctx);
+		}
+
+		void stopRefill() {
+			AesOfbStopRefill(&ctx);
+		}
+
+		void disableKeystream() {
+			AesOfbDisableKeystream(&ctx);
+		}
+
 		// XOR buffer (in-place or separate output)
-		void xorStream(const void* in, void* out, uint32_t size) {
-			AesOfbXor(&ctx, in, out, size);
+		void xorStream(const void* in, void* out, size_t size) {
+			AesOfbXorLarge(&ctx, in, out, size);
 		}
 
 		// Output raw OFB keystream
-		void outputKey(void* out, uint32_t size) {
-			AesOfbOutput(&ctx, out,size);
+		void outputKey(void* out, size_t size) {
+			std::memset(out, 0, size);
+			AesOfbXorLarge(&ctx, out, out, size);
 		}
 
 		// One-shot XOR
@@ -638,6 +994,95 @@ namespace hash {
 		AesOfbContext ctx;
 	};
 
+	class AesGcm {
+	public:
+		// Initialize with key, then start each message with start()
+		AesGcm(const uint8_t* key, uint32_t keySize) {
+			if (AesGcmInitialiseWithKey(&ctx, key, keySize) != 0)
+				throw std::runtime_error("Invalid AES key size");
+		}
+
+		~AesGcm() {
+			std::memset(&ctx, 0, sizeof(ctx));
+		}
+
+		void start(const uint8_t* iv, uint32_t ivSize = AES_GCM_IV_SIZE) {
+			if (AesGcmStart(&ctx, iv, ivSize) != 0)
+				throw std::runtime_error("Invalid IV size");
+		}
+
+		// Additional authenticated data, before any encrypt()/decrypt() of the message
+		void updateAad(const void* aad, size_t size) {
+			if (AesGcmUpdateAadLarge(&ctx, aad, size) != 0)
+				throw std::runtime_error("AAD after message data");
+		}
+
+		void encrypt(const void* in, void* out, size_t size) {
+			if (AesGcmEncryptLarge(&ctx, in, out, size) != 0)
+				throw std::length_error("GCM message too long");
+		}
+
+		void decrypt(const void* in, void* out, size_t size) {
+			if (AesGcmDecryptLarge(&ctx, in, out, size) != 0)
+				throw std::length_error("GCM message too long");
+		}
+
+		std::array<uint8_t, AES_GCM_TAG_SIZE> finish() {
+			std::array<uint8_t, AES_GCM_TAG_SIZE> tag;
+			AesGcmFinish(&ctx, tag.data());
+			return tag;
+		}
+
+		// Constant-time tag check, false if the message does not authenticate
+		bool verify(const uint8_t* tag, uint32_t tagSize = AES_GCM_TAG_SIZE) {
+			return AesGcmVerify(&ctx, tag, tagSize) == 0;
+		}
+
+	private:
+		AesGcmContext ctx;
+	};
+
+	class AesXts {
+	public:
+		// Key1 (data) followed by Key2 (tweak): 32, 48 or 64 bytes
+		AesXts(const uint8_t* key, uint32_t keySize) {
+			if (AesXtsInitialiseWithKey(&ctx, key, keySize) != 0)
+				throw std::runtime_error("Invalid AES-XTS key size");
+		}
+
+		~AesXts() {
+			std::memset(&ctx, 0, sizeof(ctx));
+		}
+
+		void encryptSector(uint64_t sector, const void* in, void* out, uint32_t size) {
+			if (AesXtsEncryptSector(&ctx, sector, in, out, size) != 0)
+				throw std::length_error("XTS data unit shorter than one block");
+		}
+
+		void decryptSector(uint64_t sector, const void* in, void* out, uint32_t size) {
+			if (AesXtsDecryptSector(&ctx, sector, in, out, size) != 0)
+				throw std::length_error("XTS data unit shorter than one block");
+		}
+
+		// Consecutive sectors of sectorSize bytes, numbered from firstSector
+		void encryptSectors(uint64_t firstSector, uint32_t sectorSize, const void* in, void* out, size_t sectors) {
+			if (AesXtsEncryptSectors(&ctx, firstSector, sectorSize, in, out, sectors) != 0)
+				throw std::length_error("XTS data unit shorter than one block");
+		}
+
+		void decryptSectors(uint64_t firstSector, uint32_t sectorSize, const void* in, void* out, size_t sectors) {
+			if (AesXtsDecryptSectors(&ctx, firstSector, sectorSize, in, out, sectors) != 0)
+				throw std::length_error("XTS data unit shorter than one block");
+		}
+
+		static void setParallelThreshold(size_t bytes) {
+			AesXtsSetParallelThreshold(bytes);
+		}
+
+	private:
+		AesXtsContext ctx;
+	};
+
 	class CRC32 {
 	public:
 		enum class Variant {
@@ -650,19 +1095,17 @@ namespace hash {
 			AUTOSAR
 		};
 
+		// Reflected variants use the library's shared tables and kernels; only the non-reflected ones build their own
 		CRC32(Variant variant = Variant::IEEE, bool reflected = true)
-			: reflected_(reflected) {
-			uint32_t poly = getPolynomial(variant, reflected_);
-			if (reflected_) {
-				crc32_reflected_table(table_.data(), poly);
-			} else {
-				crc32_init_table(table_.data(), poly);
+			: poly_(getPolynomial(variant, reflected)), reflected_(reflected) {
+			if (!reflected_) {
+				crc32_init_table(table_.data(), poly_);
 			}
 		}
 
 		uint32_t compute(const void* data, size_t len, uint32_t init_crc = 0xFFFFFFFF) const {
 			if (reflected_) {
-				return ccrc32_reflected(init_crc, data, len, table_.data());
+				return crc32_update(poly_, init_crc, data, len);
 			} else {
 				return ccrc32(init_crc, data, len, table_.data());
 			}
@@ -677,7 +1120,8 @@ namespace hash {
 		}
 
 	private:
-		std::array<uint32_t, 256> table_;
+		std::array<uint32_t, 256> table_{};
+		uint32_t poly_;
 		bool reflected_;
 
 		static uint32_t getPolynomial(Variant v, bool reflected) {
@@ -741,6 +1185,34 @@ namespace hash {
 				default: throw std::runtime_error("Unknown CRC32 variant");
 			}
 		}
+
+		// Large buffers and files checksummed in segments on the worker threads
+		static uint32_t compute_parallel(const void* data, size_t len, Variant v = Variant::IEEE) {
+			return crc32_parallel(data, len, getPolynomial(v));
+		}
+
+		static uint32_t compute_file_parallel(const std::string& path, Variant v = Variant::IEEE) {
+			return crc32_file_parallel(path.c_str(), getPolynomial(v));
+		}
+
+		// CRC of a followed by b (lenB bytes) from the CRCs of a and b
+		static uint32_t combine(uint32_t crcA, uint32_t crcB, uint64_t lenB, Variant v = Variant::IEEE) {
+			return crc32_combine(crcA, crcB, lenB, getPolynomial(v));
+		}
+
+	private:
+		static uint32_t getPolynomial(Variant v) {
+			switch (v) {
+				case Variant::IEEE: return CRC32_POLY_REFLECTED;
+				case Variant::CRC32C: return CRC32C_POLY_REFLECTED;
+				case Variant::CRC32K: return CRC32K_POLY_REFLECTED;
+				case Variant::CRC32Q: return CRC32Q_POLY_REFLECTED;
+				case Variant::CRC32D: return CRC32D_POLY_REFLECTED;
+				case Variant::XFER: return CRC32_XFER_POLY_REFLECTED;
+				case Variant::AUTOSAR: return CRC32_AUTOSAR_POLY_REFLECTED;
+				default: throw std::runtime_error("Unknown CRC32 variant");
+			}
+		}
 	};
 
 	class Rc4 {
@@ -762,19 +1234,19 @@ namespace hash {
 		Rc4& operator=(Rc4&&) = delete;
 
 		// Generate keystream bytes
-		void output(void* out, uint32_t size) {
+		void output(void* out, size_t size) {
 			if (!out && size > 0)
 				throw std::invalid_argument("Output buffer is null");
-			Rc4Output(&ctx, out, size);
+			Rc4OutputLarge(&ctx, out, size);
 		}
 
 		// XOR buffer with keystream
-		void xorStream(const void* in, void* out, uint32_t size) {
+		void xorStream(const void* in, void* out, size_t size) {
 			if (size > 0) {
 				if (!out) throw std::invalid_argument("Output buffer is null");
 				if (!in)  throw std::invalid_argument("Input buffer is null");
 			}
-			Rc4Xor(&ctx, in, out, size);
+			Rc4XorLarge(&ctx, in, out, size);
 		}
 
 	private: